@@ -0,0 +1,40 @@
+% This compares the per-worker fetch latency of column blocks against 
+% fetching the whole matrix.
+
+matshare.examples.mshpoolstartup;
+
+% Some data to share
+Data = rand(4000, 2000*numworkers);
+
+matshare.clearshm;
+matshare.share('-n', 'whole', Data);
+matshare.share('-n', 'blocked', '-block', numworkers, Data);
+
+% fetch the whole matrix in each worker
+wholetimes = zeros(1, numworkers);
+parfor i = 1:numworkers
+	t = tic;
+	d = matshare.fetch('whole');
+	wholetimes(i) = toc(t);
+	wholeresult(i) = sum(reshape(d.data(:, (i-1)*2000+1:i*2000), [], 1));
+end
+
+% fetch only this worker's column block
+blocktimes = zeros(1, numworkers);
+parfor i = 1:numworkers
+	t = tic;
+	d = matshare.fetch('blocked', '-block', i);
+	blocktimes(i) = toc(t);
+	blockresult(i) = sum(d.data(:));
+end
+
+fprintf('Mean per-worker fetch latency (whole matrix): %f s\n', mean(wholetimes));
+fprintf('Mean per-worker fetch latency (column block): %f s\n', mean(blocktimes));
+
+if(all(abs(blockresult - wholeresult) <= 1e-8*abs(wholeresult)))
+	disp('Result is correct.');
+else
+	disp('Result is incorrect.');
+end
+
+matshare.clearshm;
@@ -0,0 +1,29 @@
+% This measures atomic variable operations when every worker adds into
+% the same shared array at once. The result is checked for lost updates.
+
+matshare.examples.mshpoolstartup;
+
+numelems = 1e5;
+numiters = 100;
+types = {'int32', 'double'};
+
+for i = 1:numel(types)
+	matshare.clearshm;
+	matshare.share('-n', 'contended', zeros(numelems, 1, types{i}));
+
+	t = tic;
+	parfor j = 1:numworkers
+		c = matshare.fetch('contended');
+		for k = 1:numiters
+			c.add(ones(1, types{i}), '-t');
+		end
+	end
+	elapsed = toc(t);
+
+	c = matshare.fetch('contended');
+	numlost = nnz(c.data ~= numworkers*numiters);
+	fprintf('%-6s: %d workers, %8.3f ns/update, %d lost updates\n', types{i}, ...
+		numworkers, 1e9*elapsed/(numworkers*numiters*numelems), numlost);
+end
+
+matshare.clearshm;
@@ -0,0 +1,73 @@
+% This measures the cost of the internal name table as the number of
+% named variables grows. The variables are shared as one batch so that
+% large tables can be built without creating a segment for each entry.
+%
+% The MEX call and variable copies dominate each operation, so the table
+% itself is isolated by subtracting a baseline which does the same work
+% without touching it. Inserts are timed against an unnamed batch of the
+% same variables, which is not entered into the table. Lookups are timed
+% against missing names fetched from an empty table. A flat table cost
+% across sizes means the table stays O(1).
+
+numlookups = 1000;
+numreps = 5;
+tablesizes = [100 1000 10000 100000];
+
+inserttimes = zeros(size(tablesizes));
+hittimes = zeros(size(tablesizes));
+misstimes = zeros(size(tablesizes));
+
+% baseline for a lookup which probes an empty table
+matshare.clearshm;
+missing = arrayfun(@(k)sprintf('m%d', k), 1:numlookups, 'UniformOutput', false);
+t = tic;
+for j = 1:numlookups
+	matshare.fetch(missing{j});
+end
+basetime = toc(t)/numlookups;
+
+for i = 1:numel(tablesizes)
+	n = tablesizes(i);
+	names = arrayfun(@(k)sprintf('v%d', k), 1:n, 'UniformOutput', false);
+	vals = num2cell(1:n);
+	args = [names; vals];
+	
+	% inserts every name into the table, less the same batch without names
+	named = 0;
+	unnamed = 0;
+	for r = 1:numreps
+		matshare.clearshm;
+		t = tic;
+		matshare.share('-b', vals{:});
+		unnamed = unnamed + toc(t);
+		
+		matshare.clearshm;
+		t = tic;
+		matshare.share('-b', '-n', args{:});
+		named = named + toc(t);
+	end
+	inserttimes(i) = max(named - unnamed, 0)/(numreps*n);
+	
+	% lookups of random names which are present
+	lookups = names(randi(n, 1, numlookups));
+	t = tic;
+	for j = 1:numlookups
+		matshare.fetch(lookups{j});
+	end
+	hittimes(i) = toc(t)/numlookups;
+	
+	% lookups of names which are not present probe the full table without creating a variable
+	t = tic;
+	for j = 1:numlookups
+		matshare.fetch(missing{j});
+	end
+	misstimes(i) = toc(t)/numlookups - basetime;
+	
+	matshare.clearshm;
+end
+
+fprintf('baseline fetch: %8.3f us\n', 1e6*basetime);
+for i = 1:numel(tablesizes)
+	fprintf('%6d entries: %8.3f us/insert, %8.3f us/fetch, %8.3f us/miss over baseline\n', ...
+		tablesizes(i), 1e6*inserttimes(i), 1e6*hittimes(i), 1e6*misstimes(i));
+end
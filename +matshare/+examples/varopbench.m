@@ -0,0 +1,61 @@
+% This measures the throughput of the variable operations on large arrays.
+% Same type operations without atomics use the vector kernels, so these
+% should run close to memory bandwidth.
+
+numelems = 1e8;
+numtrials = 5;
+
+types = {'int16', 'int32', 'single', 'double'};
+
+matshare.clearshm;
+
+for i = 1:numel(types)
+	obj = matshare.share(zeros(numelems, 1, types{i}));
+	in = ones(numelems, 1, types{i});
+
+	% elementwise
+	t = tic;
+	for j = 1:numtrials
+		obj.add(in, '-n');
+	end
+	elemtime = toc(t)/numtrials;
+
+	% scalar broadcast
+	t = tic;
+	for j = 1:numtrials
+		obj.add(ones(1, types{i}), '-n');
+	end
+	scalartime = toc(t)/numtrials;
+
+	% the accumulator is read and written, the elementwise input is read
+	nbytes = numelems*numel(typecast(ones(1, types{i}), 'uint8'));
+	fprintf('%-6s: %8.2f GB/s elementwise, %8.2f GB/s scalar\n', types{i}, ...
+		3*nbytes/elemtime/1e9, 2*nbytes/scalartime/1e9);
+
+	% reductions only read the shared data
+	t = tic;
+	for j = 1:numtrials
+		obj.sum();
+	end
+	fprintf('%-6s: %8.2f GB/s sum\n', types{i}, nbytes/(toc(t)/numtrials)/1e9);
+
+	clear obj in;
+	matshare.clearshm;
+end
+
+% thread scaling for large elementwise operations
+obj = matshare.share(zeros(numelems, 1));
+in = ones(numelems, 1);
+for numthreads = [1 2 4 8]
+	matshare.config('VarOpThreads', num2str(numthreads));
+	t = tic;
+	for j = 1:numtrials
+		obj.add(in, '-n');
+	end
+	fprintf('%d threads: %8.2f GB/s elementwise\n', numthreads, ...
+		3*8*numelems/(toc(t)/numtrials)/1e9);
+end
+matshare.config('VarOpThreads', 'auto');
+
+clear obj in;
+matshare.clearshm;
@@ -12,8 +12,13 @@
 %    List of functions:
 %        Primary:
 %            matshare.share           - Copy a variable to shared memory
+%            matshare.alloc           - Allocate a variable directly in shared memory
+%            matshare.mapfile         - Share a variable mapped directly from a file
+%            matshare.loadfile        - Read files directly into shared memory
 %            matshare.fetch           - Fetch variables from shared memory 
 %            matshare.clearshm        - Clear variables from shared memory
+%            matshare.snapshot        - Save all shared variables to a file
+%            matshare.restore         - Restore shared variables from a snapshot file
 %            matshare.detach          - Detach shared memory from this process
 %        Utility:            
 %            matshare.config          - Configure MATSHARE
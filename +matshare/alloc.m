@@ -0,0 +1,42 @@
+function varargout = alloc(varargin)
+%% MATSHARE.ALLOC  Allocate a variable directly in shared memory.
+%    S = MATSHARE.ALLOC(CLASS,DIMS) creates a zero-filled variable of class
+%    CLASS and size DIMS in shared memory without copying any local data,
+%    and returns a matshare object containing it. Fill the variable in
+%    place with <a href="matlab:help matshare.object/overwrite">overwrite</a> or any of the other in-place operations.
+%
+%    To keep the peak memory low, fill the variable a piece at a time with
+%    subscripted overwrites, so that only one piece is ever held locally.
+%    Overwriting the whole variable at once needs a full local copy of 
+%    the data, which gives up the memory saved by allocating in place.
+%
+%    CLASS may be any numeric class, 'logical', or 'char'. A scalar DIMS
+%    of N creates an N-by-N variable.
+%
+%    Specify options for MATSHARE.ALLOC with character vectors beginning
+%    with '-':
+%        
+%        <strong>-p</strong>[ersist] -- do not subject this variable to garbage 
+%                      collection.
+%        <strong>-c</strong>[omplex] -- allocate space for imaginary data.
+%        <strong>-n</strong>[amed]   -- supply a name to this variable. In this case 
+%                      the syntax is MATSHARE.ALLOC(CLASS,DIMS,'-n',N)
+%                      where N is a name specified by a character vector.
+%
+%    Example filling one column block at a time:
+%        >> s = matshare.alloc('double', [1000 1000], '-n', 'buf');
+%        >> for j = 1:100:1000
+%        >>     s.overwrite(rand(1000, 100), substruct('()', {':', j:j+99}));
+%        >> end
+
+%% Copyright © 2018 Gene Harvey
+%    This software may be modified and distributed under the terms
+%    of the MIT license. See the LICENSE file for details.
+
+	if(nargout == 0)
+		varargout{1} = matshare.object(matshare_(13, 1, varargin));
+	else
+		varargout{1} = matshare.object(matshare_(13, 0, varargin));
+	end
+	
+end
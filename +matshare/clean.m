@@ -1,7 +1,10 @@
 function clean
 %% MATSHARE.CLEAN  Clean the local segment tracking.
 %    MATSHARE.CLEAN runs a garbage collection operation on local segment 
-%    tracking to remove invalid and unused variables.
+%    tracking to remove invalid and unused variables. It also releases 
+%    references held by MATLAB processes which exited without detaching, 
+%    such as killed parallel pool workers, and removes variables which 
+%    were only in use by those processes.
 
 %% Copyright © 2018 Gene Harvey
 %    This software may be modified and distributed under the terms
@@ -54,6 +54,29 @@ function config(varargin)
 %                                variable operations.
 %            Values: '-s','-a','-t','-n'
 %            Default: '-a'
+%
+%        ['EvictionPolicy','ep'] -- Set which variables are evicted when 
+%                                   sharing would exceed MaxSize.
+%            Values: 'none','lru','size'
+%            Default: 'none'
+%            Notes: Only non-persistent variables which are not in use by 
+%                   any process are evicted. 'lru' evicts the least 
+%                   recently shared or fetched first, and 'size' evicts the 
+%                   largest first. Nothing is evicted unless doing so frees 
+%                   enough space for the new variable.
+%
+%        ['VarOpThreads','vt'] -- Set the maximum number of threads used 
+%                                 by variable operations on large arrays.
+%            Values: An unsigned integer, or 'auto'
+%            Default: 'auto'
+%            Notes: 'auto' and '0' use one thread per processor. Arrays 
+%                   smaller than a few hundred thousand elements always 
+%                   run on a single thread, as do subscripted operations
+%                   which modify the variable, since the subscripts may 
+%                   repeat elements. The threads are started on each 
+%                   call rather than kept in a pool, so small gains on 
+%                   arrays just above the threshold may be lost to 
+%                   thread startup.
 
 %% Copyright © 2018 Gene Harvey
 %    This software may be modified and distributed under the terms
@@ -12,7 +12,10 @@ function varargout = fetch(varargin)
 %
 %        <strong>-r</strong>[ecent] -- return the most recent shared variable.
 %
-%        <strong>-w</strong>        -- return variables not tracked by this process
+%        <strong>-w</strong>        -- return variables not tracked by this process.
+%                         A batch is returned whole, and entries or
+%                         subscripts fetched in the same call are not
+%                         included.
 %
 %        <strong>-a</strong>[ll]    -- return all currently shared variables.
 %
@@ -23,6 +26,20 @@ function varargout = fetch(varargin)
 %        >> matshare.share('-n', 'myvarname', rand(5));
 %        >> x = matshare.fetch('myvarname');
 %
+%    X = MATSHARE.FETCH(VARNAME,S) returns only the part of the named
+%    variable addressed by S, where S is a struct in the style of that 
+%    returned by the built-in `substruct`. Only the addressed part is 
+%    created, which is much faster for large cells and structs. S may 
+%    index into cells with '{}', reference fields with '.', and select a
+%    struct element with '()' before a field reference. Example:
+%        >> matshare.share('-n', 'mycell', num2cell(rand(1000)));
+%        >> x = matshare.fetch('mycell', substruct('{}', {5}));
+%
+%    X = MATSHARE.FETCH(VARNAME,'-block',I) returns column block I of a
+%    matrix shared with the '-block' option. Example:
+%        >> matshare.share('-n', 'mymat', '-block', 4, rand(1000));
+%        >> x = matshare.fetch('mymat', '-block', 2);
+%
 %    The returns from options are in the order that the arguments were
 %    entered and can be mixed with variable names.
 
@@ -0,0 +1,44 @@
+function varargout = loadfile(varargin)
+%% MATSHARE.LOADFILE  Read files directly into shared memory.
+%    S = MATSHARE.LOADFILE(FILES,CLASS,DIMS) reads the raw binary files 
+%    FILES back to back into a new shared variable of class CLASS and size
+%    DIMS, and returns a matshare object containing it. FILES may be a
+%    character vector or a cell array of character vectors. The files are
+%    read with many parallel positional reads straight into shared memory,
+%    bypassing MATLAB file I/O and the copy made by <a href="matlab:help matshare.share">matshare.share</a>.
+%
+%    The total size of the files must equal PROD(DIMS) elements of CLASS, 
+%    stored in column-major order with the native byte order. CLASS may be 
+%    any numeric class, 'logical', or 'char'. A scalar DIMS of N loads an 
+%    N-by-N variable.
+%
+%    [S,STATS] = MATSHARE.LOADFILE(...) also returns a struct with the 
+%    number of bytes read, the time taken in seconds, and the achieved
+%    throughput in bytes per second.
+%
+%    Specify options for MATSHARE.LOADFILE with character vectors 
+%    beginning with '-':
+%        
+%        <strong>-p</strong>[ersist] -- do not subject this variable to garbage 
+%                      collection.
+%        <strong>-n</strong>[amed]   -- supply a name to this variable. In this case 
+%                      the syntax is MATSHARE.LOADFILE(FILES,CLASS,DIMS,'-n',N)
+%                      where N is a name specified by a character vector.
+%        <strong>-t</strong>[hreads] -- the number of threads to read with, followed 
+%                      by a positive integer. Defaults to the number of 
+%                      processors.
+%
+%    Example:
+%        >> files = {'part1.bin', 'part2.bin'};
+%        >> [s, stats] = matshare.loadfile(files, 'single', [4096 65536]);
+%        >> fprintf('%.1f MB/s\n', stats.throughput/1e6);
+
+%% Copyright © 2018 Gene Harvey
+%    This software may be modified and distributed under the terms
+%    of the MIT license. See the LICENSE file for details.
+
+	varargout = cell(1, max(nargout, 1));
+	[varargout{:}] = matshare_(18, nargout == 0, varargin);
+	varargout{1} = matshare.object(varargout{1});
+	
+end
@@ -0,0 +1,39 @@
+function varargout = mapfile(varargin)
+%% MATSHARE.MAPFILE  Share a variable mapped directly from a file.
+%    S = MATSHARE.MAPFILE(PATH,CLASS,DIMS) shares a variable of class CLASS
+%    and size DIMS whose data is mapped directly from the raw binary file
+%    at PATH, and returns a matshare object containing it. The data is
+%    never copied into MATLAB, so the file is accessed through the page
+%    cache. Writes with <a href="matlab:help matshare.object/overwrite">overwrite</a> and the other in-place operations
+%    go directly to the file.
+%
+%    The file must hold at least PROD(DIMS) elements of CLASS in column-
+%    major order with the native byte order. CLASS may be any numeric 
+%    class, 'logical', or 'char'. A scalar DIMS of N maps an N-by-N 
+%    variable. Every process fetching the variable maps the file by its 
+%    absolute path, so it must remain available. This is not supported 
+%    on Windows.
+%
+%    Specify options for MATSHARE.MAPFILE with character vectors beginning
+%    with '-':
+%        
+%        <strong>-p</strong>[ersist] -- do not subject this variable to garbage 
+%                      collection.
+%        <strong>-n</strong>[amed]   -- supply a name to this variable. In this case 
+%                      the syntax is MATSHARE.MAPFILE(PATH,CLASS,DIMS,'-n',N)
+%                      where N is a name specified by a character vector.
+%
+%    Example:
+%        >> s = matshare.mapfile('/data/ref.bin', 'double', [1e6 100], '-n', 'ref');
+
+%% Copyright © 2018 Gene Harvey
+%    This software may be modified and distributed under the terms
+%    of the MIT license. See the LICENSE file for details.
+
+	if(nargout == 0)
+		varargout{1} = matshare.object(matshare_(17, 1, varargin));
+	else
+		varargout{1} = matshare.object(matshare_(17, 0, varargin));
+	end
+	
+end
@@ -19,6 +19,19 @@ classdef object
 %        <a href="matlab:help matshare.object/neg">neg</a>          - Negate
 %        <a href="matlab:help matshare.object/ars">ars</a>          - Arithmetic right shift
 %        <a href="matlab:help matshare.object/als">als</a>          - Arithmetic left shift
+%        <a href="matlab:help matshare.object/min">min</a>          - Elementwise minimum
+%        <a href="matlab:help matshare.object/max">max</a>          - Elementwise maximum
+%        <a href="matlab:help matshare.object/bitand">bitand</a>       - Bitwise AND
+%        <a href="matlab:help matshare.object/bitor">bitor</a>        - Bitwise OR
+%        <a href="matlab:help matshare.object/bitxor">bitxor</a>       - Bitwise XOR
+%        <a href="matlab:help matshare.object/axpy">axpy</a>         - Add a scaled input
+%        <a href="matlab:help matshare.object/fma">fma</a>          - Multiply and add
+%        <a href="matlab:help matshare.object/clamp">clamp</a>        - Limit to a range
+%        <a href="matlab:help matshare.object/sum">sum</a>          - Sum of the elements
+%        <a href="matlab:help matshare.object/minval">minval</a>       - Smallest element
+%        <a href="matlab:help matshare.object/maxval">maxval</a>       - Largest element
+%        <a href="matlab:help matshare.object/any">any</a>          - Whether any element is nonzero
+%        <a href="matlab:help matshare.object/nnz">nnz</a>          - Number of nonzero elements
 %
 %    Instances of this class should only be created via <a href="matlab:help matshare.share">matshare.share</a> 
 %    and <a href="matlab:help matshare.fetch">matshare.fetch</a>.
@@ -28,7 +41,7 @@ classdef object
 %    of the MIT license. See the LICENSE file for details.
 	
 	properties (Hidden, Access = protected)
-		shared_data = {[]}; % Shares shared data pointers in a cell.
+		shared_data = {[]}; % Shares shared data pointers in a cell, with a handle to the segment.
 	end
 	
 	
@@ -199,7 +212,170 @@ classdef object
 			end
 		end
 		
-		function ret = overwrite(obj, in, varargin)
+		function ret = min(obj, in, varargin)
+%% MIN  Store the smaller of the variable and the input.
+%    DAT = OBJ.MIN(IN, ...) overwrites each element of the variable with 
+%    the smaller of it and IN. NaNs are ignored, as with the builtin.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 11, obj.shared_data, {in}, varargin);
+			else
+				ret = matshare_(8, 11, obj.shared_data, {in}, varargin);
+			end
+		end
+		
+		function ret = max(obj, in, varargin)
+%% MAX  Store the larger of the variable and the input.
+%    DAT = OBJ.MAX(IN, ...) overwrites each element of the variable with 
+%    the larger of it and IN. NaNs are ignored, as with the builtin.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 12, obj.shared_data, {in}, varargin);
+			else
+				ret = matshare_(8, 12, obj.shared_data, {in}, varargin);
+			end
+		end
+		
+		function ret = bitand(obj, in, varargin)
+%% BITAND  Bitwise AND the variable with the input and store the result.
+%    DAT = OBJ.BITAND(IN, ...) stores the bitwise AND of the variable and 
+%    IN. The variable must be of integer or logical class.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 13, obj.shared_data, {in}, varargin);
+			else
+				ret = matshare_(8, 13, obj.shared_data, {in}, varargin);
+			end
+		end
+		
+		function ret = bitor(obj, in, varargin)
+%% BITOR  Bitwise OR the variable with the input and store the result.
+%    DAT = OBJ.BITOR(IN, ...) stores the bitwise OR of the variable and 
+%    IN. The variable must be of integer or logical class.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 14, obj.shared_data, {in}, varargin);
+			else
+				ret = matshare_(8, 14, obj.shared_data, {in}, varargin);
+			end
+		end
+		
+		function ret = bitxor(obj, in, varargin)
+%% BITXOR  Bitwise XOR the variable with the input and store the result.
+%    DAT = OBJ.BITXOR(IN, ...) stores the bitwise XOR of the variable and 
+%    IN. The variable must be of integer or logical class.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 15, obj.shared_data, {in}, varargin);
+			else
+				ret = matshare_(8, 15, obj.shared_data, {in}, varargin);
+			end
+		end
+		
+		function ret = axpy(obj, a, x, varargin)
+%% AXPY  Add a scaled input to the variable in one pass.
+%    DAT = OBJ.AXPY(A, X, ...) stores OBJ.data + A.*X. A and X are 
+%    converted to the class of the variable before they are combined,
+%    except when the variable is an integer class and A or X is single 
+%    or double. Then the result is computed in double and converted to 
+%    the class of the variable once, as with OBJ.data + A.*X in MATLAB.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 16, obj.shared_data, {a, x}, varargin);
+			else
+				ret = matshare_(8, 16, obj.shared_data, {a, x}, varargin);
+			end
+		end
+		
+		function ret = fma(obj, a, b, varargin)
+%% FMA  Multiply the variable and add to it in one pass.
+%    DAT = OBJ.FMA(A, B, ...) stores OBJ.data.*A + B. A and B are 
+%    converted to the class of the variable before they are combined,
+%    except when the variable is an integer class and A or B is single 
+%    or double. Then the result is computed in double and converted to 
+%    the class of the variable once.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 17, obj.shared_data, {a, b}, varargin);
+			else
+				ret = matshare_(8, 17, obj.shared_data, {a, b}, varargin);
+			end
+		end
+		
+		function ret = clamp(obj, lower, upper, varargin)
+%% CLAMP  Limit the variable to a range in one pass.
+%    DAT = OBJ.CLAMP(LOWER, UPPER, ...) stores 
+%    min(max(OBJ.data, LOWER), UPPER). The bounds are converted to the 
+%    class of the variable, except when the variable is an integer class
+%    and LOWER or UPPER is single or double. Then the result is computed 
+%    in double and converted to the class of the variable once.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			if(nargout == 0)
+				matshare_(8, 18, obj.shared_data, {lower, upper}, varargin);
+			else
+				ret = matshare_(8, 18, obj.shared_data, {lower, upper}, varargin);
+			end
+		end
+		
+		function ret = sum(obj, varargin)
+%% SUM  Sum the elements without copying the variable.
+%    S = OBJ.SUM(...) returns the sum of all elements of the variable, or
+%    of the subset of elements when a subscript struct is given. The sum is
+%    accumulated and returned as a double. The variable is not modified.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			ret = matshare_(8, 19, obj.shared_data, {}, varargin);
+		end
+		
+		function ret = minval(obj, varargin)
+%% MINVAL  Find the smallest element without copying the variable.
+%    M = OBJ.MINVAL(...) returns the smallest element of the variable, or
+%    of the subset of elements when a subscript struct is given, in the 
+%    class of the variable. NaNs are ignored as with the built-in `min`.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			ret = matshare_(8, 20, obj.shared_data, {}, varargin);
+		end
+		
+		function ret = maxval(obj, varargin)
+%% MAXVAL  Find the largest element without copying the variable.
+%    M = OBJ.MAXVAL(...) returns the largest element of the variable, or
+%    of the subset of elements when a subscript struct is given, in the 
+%    class of the variable. NaNs are ignored as with the built-in `max`.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			ret = matshare_(8, 21, obj.shared_data, {}, varargin);
+		end
+		
+		function ret = any(obj, varargin)
+%% ANY  Check for nonzero elements without copying the variable.
+%    TF = OBJ.ANY(...) returns true if any element of the variable, or of
+%    the subset of elements when a subscript struct is given, is nonzero
+%    and not NaN. This stops early once such an element is found.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			ret = matshare_(8, 22, obj.shared_data, {}, varargin);
+		end
+		
+		function ret = nnz(obj, varargin)
+%% NNZ  Count the nonzero elements without copying the variable.
+%    N = OBJ.NNZ(...) returns the number of nonzero elements of the 
+%    variable, or of the subset of elements when a subscript struct is 
+%    given.
+%
+%    See <a href="matlab:help matshare.object/overwrite">overwrite</a> for details on the optional arguments.
+			ret = matshare_(8, 23, obj.shared_data, {}, varargin);
+		end
+		
+		function [ret, varargout] = overwrite(obj, in, varargin)
 %% OVERWRITE  Overwrite the contents of a variable in-place.
 %    DAT = OBJ.OVERWRITE(IN) recursively overwrites the 
 %    contents of the matshare object OBJ with IN. The data stored by OBJ 
@@ -215,15 +391,38 @@ classdef object
 %    subset of elements when S is a struct with the same structure as that
 %    returned by the built-in `substruct`. The same effect can be achieved
 %    by using subsasgn indexing in the style of OBJ.data(idx) = IN.
+%    In this case, and for the other variable operations, DAT only holds
+%    the indexed elements rather than a copy of the whole variable. Use 
+%    the flag '-o' to return the values from before the operation instead.
 %
 %    This function is completely asynchronous by default. You can specify
 %    the default behavior with <a href="matlab:help matshare.config">matshare.config</a>.
+%
+%    When no subscripts are given and IN has the same class as OBJ the 
+%    data is copied in bulk; otherwise each element is converted.
+%
+%    [NCHANGED,VER,DAT] = OBJ.OVERWRITE(IN,'-d') runs a delta overwrite,
+%    which compares IN against the shared data in page-sized blocks and
+%    only writes the blocks which differ. This avoids dirtying unchanged 
+%    pages when only a small part of a large variable has changed. 
+%    NCHANGED is the number of blocks written and VER is the data version
+%    of the variable, which is incremented once by each delta overwrite 
+%    that changes the data. IN must have the same class and size as OBJ.
+%    DAT is last so that the variable is only copied when it is asked for.
 			
-			if(nargout == 0)
-				matshare_(8, 10, obj.shared_data, {in}, varargin);
+			if(any(cellfun(@isstruct, varargin)))
+				if(nargout == 0)
+					matshare_(8, 10, obj.shared_data, {in}, varargin);
+				else
+					ret = matshare_(8, 10, obj.shared_data, {in}, varargin);
+				end
 			else
-				ret = matshare_(8, 10, obj.shared_data, {in}, varargin);
-			end			
+				if(nargout == 0)
+					matshare_(14, obj.shared_data, {in}, varargin);
+				else
+					[ret, varargout{1:nargout-1}] = matshare_(14, obj.shared_data, {in}, varargin);
+				end
+			end
 		end
 		
 		function clearshm(obj)
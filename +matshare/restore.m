@@ -0,0 +1,20 @@
+function varargout = restore(filename)
+%% MATSHARE.RESTORE  Restore shared variables from a snapshot file.
+%    MATSHARE.RESTORE(FILENAME) recreates the shared variables saved by
+%    <a href="matlab:help matshare.snapshot">matshare.snapshot</a> in the file FILENAME. The restored variables are 
+%    appended to shared memory and may be fetched as usual.
+%
+%    N = MATSHARE.RESTORE(FILENAME) also returns the number of variables
+%    restored.
+
+%% Copyright © 2018 Gene Harvey
+%    This software may be modified and distributed under the terms
+%    of the MIT license. See the LICENSE file for details.
+	
+	if(nargout == 0)
+		matshare_(16, filename);
+	else
+		varargout{1} = matshare_(16, filename);
+	end
+	
+end
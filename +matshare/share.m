@@ -12,10 +12,33 @@ function varargout = share(varargin)
 %        <strong>-n</strong>[amed]   -- supply names to these variables. In this case the 
 %                      syntax is then MATSHARE.SHARE('-n',N1,V1,...)
 %                      where N1 is a name specified by a character vector.
+%        <strong>-d</strong>[edup]   -- reuse an identical variable already in shared 
+%                      memory which was also shared with this option. 
+%                      The shared memory is only freed once the last 
+%                      reference to it is gone. All variables matched 
+%                      this way alias the same memory, so in-place 
+%                      writes (overwrite, varops) through any one of 
+%                      them are seen by all of them.
+%        <strong>-z</strong>         -- store these variables compressed. Each process 
+%                      decompresses a private read-only copy on first 
+%                      fetch. Intended for idle persistent variables.
+%        <strong>-block</strong> K   -- lay out matrices as a 1-by-K cell of contiguous 
+%                      column blocks. Each block may be fetched 
+%                      independently without a copy with 
+%                      MATSHARE.FETCH(NAME,'-block',I).
+%        <strong>-b</strong>         -- share all of these variables together in a single 
+%                      segment. Named variables may still be fetched 
+%                      individually, but clearing any one of them clears 
+%                      the whole batch. Cannot be combined with -d, -z, 
+%                      or -block.
 %
 %    Example using names:
 %        >> matshare.share('-n', 'myvarname', rand(5));
 %        >> x = matshare.fetch('myvarname');
+%
+%    Example sharing a batch:
+%        >> matshare.share('-b', '-n', 'a', rand(5), 'b', 'text');
+%        >> b = matshare.fetch('b');
 
 %% Copyright © 2018 Gene Harvey
 %    This software may be modified and distributed under the terms
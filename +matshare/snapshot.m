@@ -0,0 +1,23 @@
+function snapshot(filename)
+%% MATSHARE.SNAPSHOT  Save all shared variables to a file.
+%    MATSHARE.SNAPSHOT(FILENAME) writes every variable currently in shared
+%    memory to the file FILENAME, along with its name and options. The
+%    variables are written as they are stored in shared memory, so they
+%    can be restored quickly with <a href="matlab:help matshare.restore">matshare.restore</a>.
+%
+%    Snapshots may only be restored by builds of matshare with the same 
+%    snapshot version and bitness.
+%
+%    Example:
+%        >> matshare.share('-p', '-n', 'ref', rand(1000));
+%        >> matshare.snapshot('ref.mshsnap');
+%        >> matshare.mshreset;
+%        >> matshare.restore('ref.mshsnap');
+
+%% Copyright © 2018 Gene Harvey
+%    This software may be modified and distributed under the terms
+%    of the MIT license. See the LICENSE file for details.
+	
+	matshare_(15, filename);
+	
+end
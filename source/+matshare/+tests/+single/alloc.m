@@ -0,0 +1,43 @@
+fprintf('Testing in-place allocation... ');
+
+matshare.clearshm;
+
+% zero-filled with the requested class and size
+x = matshare.alloc('int16', [40 30]);
+if(~isa(x.data, 'int16') || ~isequal(size(x.data), [40 30]) || any(x.data(:)))
+	error('Allocated variable is not zero-filled with the requested class and size.');
+end
+
+% scalar dimensions make a square variable
+x = matshare.alloc('double', 7, '-c');
+if(~isequal(size(x.data), [7 7]) || isreal(x.data))
+	error('Allocated variable has the wrong size or complexity.');
+end
+
+% fill in place one column block at a time
+v = rand(100, 60);
+x = matshare.alloc('double', [100 60]);
+for j = 1:20:60
+	x.overwrite(v(:, j:j+19), substruct('()', {':', j:j+19}));
+end
+if(~isequal(x.data, v))
+	error('Blocked fill of an allocated variable failed.');
+end
+
+% sizes which overflow must be rejected rather than wrapping to a small segment
+baddims = {[2^32 2^32], [2^62 8], 2^64, [1 2^64]};
+for i = 1:numel(baddims)
+	try
+		x = matshare.alloc('double', baddims{i});
+		error('matshare:tests:NoError', 'Allocation with overflowing dimensions did not fail.');
+	catch err
+		if(strcmp(err.identifier, 'matshare:tests:NoError'))
+			rethrow(err);
+		end
+	end
+end
+
+clear x;
+matshare.clearshm;
+
+fprintf('Test successful.\n\n');
@@ -0,0 +1,51 @@
+fprintf('Testing delta overwrites... ');
+
+matshare.clearshm;
+
+% 16 blocks of 4096 bytes
+v = zeros(512*16, 1);
+x = matshare.share(v);
+
+% an identical input writes nothing and keeps the version
+[nchanged, ver0] = x.overwrite(v, '-d');
+if(nchanged ~= 0)
+	error('Delta overwrite of identical data wrote %d blocks.', nchanged);
+end
+
+% a single changed element only writes its own block
+v(600) = 1;
+[nchanged, ver1, dat] = x.overwrite(v, '-d');
+if(nchanged ~= 1)
+	error('Delta overwrite of one element wrote %d blocks instead of 1.', nchanged);
+end
+if(ver1 <= ver0)
+	error('Delta overwrite which changed the data did not increase the version.');
+end
+if(~isequal(dat, v) || ~isequal(x.data, v))
+	error('Delta overwrite produced incorrect data.');
+end
+
+% changes in the first and last blocks write both of them
+v(1) = 2;
+v(end) = 3;
+[nchanged, ver2] = x.overwrite(v, '-d');
+if(nchanged ~= 2)
+	error('Delta overwrite of two blocks wrote %d blocks instead of 2.', nchanged);
+end
+if(ver2 <= ver1)
+	error('Delta overwrite which changed the data did not increase the version.');
+end
+if(~isequal(x.data, v))
+	error('Delta overwrite produced incorrect data.');
+end
+
+% unchanged data keeps the version
+[nchanged, ver3] = x.overwrite(v, '-d');
+if(nchanged ~= 0 || ver3 ~= ver2)
+	error('Delta overwrite of unchanged data modified the version.');
+end
+
+clear x dat;
+matshare.clearshm;
+
+fprintf('Test successful.\n\n');
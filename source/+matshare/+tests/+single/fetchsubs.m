@@ -0,0 +1,37 @@
+fprintf('Testing subscripted and new variable fetches... ');
+
+matshare.clearshm;
+
+sv = struct('a', {{1:5, 'txt'}}, 'b', magic(3));
+matshare.share('-p', '-n', 'sv', sv);
+
+% subscripted fetches return only the addressed part
+f = matshare.fetch('sv', substruct('.', 'a', '{}', {2}));
+if(~isequal(f.data, 'txt'))
+	error('Subscripted fetch of a cell element failed.');
+end
+f = matshare.fetch('sv', substruct('.', 'b'));
+if(~isequal(f.data, magic(3)))
+	error('Subscripted fetch of a field failed.');
+end
+f = matshare.fetch('sv');
+if(~isequal(f.data, sv))
+	error('Fetch of the whole variable failed.');
+end
+clear f;
+
+% after detaching the variable is untracked, so it should be the only new variable
+% even though the subscripted fetch in the same call also creates a variable
+matshare.detach;
+[f, w] = matshare.fetch('sv', substruct('.', 'b'), '-w');
+if(~isequal(f.data, magic(3)))
+	error('Subscripted fetch failed after detaching.');
+end
+if(numel(w) ~= 1 || ~isequal(w.data, sv))
+	error('New variable fetch did not return the newly tracked variable.');
+end
+
+clear f w;
+matshare.clearshm;
+
+fprintf('Test successful.\n\n');
@@ -0,0 +1,39 @@
+fprintf('Testing snapshot and restore... ');
+
+matshare.clearshm;
+
+sa = rand(200, 30);
+sb = struct('c', {{int16(1:10), 'txt'}}, 'd', single(magic(4)));
+sc = repmat(uint8(1:8), 50, 1);
+matshare.share('-p', '-n', 'sa', sa);
+matshare.share('-p', '-n', 'sb', sb);
+matshare.share('-p', '-z', '-n', 'sc', sc);
+
+snapfile = [tempname '.mshsnap'];
+matshare.snapshot(snapfile);
+matshare.clearshm;
+
+n = matshare.restore(snapfile);
+delete(snapfile);
+if(n ~= 3)
+	error('Restore returned %d variables instead of 3.', n);
+end
+
+% the restored variables must match the originals exactly
+f = matshare.fetch('sa');
+if(~isequal(f.data, sa))
+	error('Restored matrix did not match the original.');
+end
+f = matshare.fetch('sb');
+if(~isequal(f.data, sb))
+	error('Restored struct did not match the original.');
+end
+f = matshare.fetch('sc');
+if(~isequal(f.data, sc))
+	error('Restored compressed variable did not match the original.');
+end
+
+clear f;
+matshare.clearshm;
+
+fprintf('Test successful.\n\n');
@@ -181,5 +181,93 @@ btester.test(5, -7);
 btester.test(-7, -5);
 btester.test(-realmax, realmax);
 
+
+% min
+btester.mshf = @min;
+btester.matf = @min;
+
+btester.test(2, 1);
+btester.test(-7, -5);
+btester.test(NaN, 5);
+btester.test(5, NaN);
+btester.test(int8(-125), int8(25));
+btester.test(uint8(225), uint8(100));
+btester.test(single(3), single(-3));
+
+% max
+btester.mshf = @max;
+btester.matf = @max;
+
+btester.test(2, 1);
+btester.test(-7, -5);
+btester.test(NaN, 5);
+btester.test(int8(-125), int8(25));
+btester.test(uint8(225), uint8(100));
+btester.test(single(3), single(-3));
+
+% bitand, bitor, bitxor
+btester.mshf = @bitand;
+btester.matf = @bitand;
+btester.test(uint8(225), uint8(100));
+btester.test(uint32(234), uint32(2384293));
+
+btester.mshf = @bitor;
+btester.matf = @bitor;
+btester.test(uint8(225), uint8(100));
+btester.test(uint32(234), uint32(2384293));
+
+btester.mshf = @bitxor;
+btester.matf = @bitxor;
+btester.test(uint8(225), uint8(100));
+btester.test(uint32(234), uint32(2384293));
+
+% axpy, fma, clamp
+x = matshare.share([1 2 3]);
+if(any(x.axpy(2, [4 5 6]) ~= [9 12 15]))
+	error('Incorrect result');
+end
+if(any(x.fma(2, 1) ~= [19 25 31]))
+	error('Incorrect result');
+end
+if(any(x.clamp(20, 30) ~= [20 25 30]))
+	error('Incorrect result');
+end
+x = matshare.share(int8([100 -100]));
+if(any(x.axpy(int8(2), int8(50)) ~= int8([127 0])))
+	error('Incorrect result');
+end
+x = matshare.share(int16([1 2 3]));
+if(any(x.axpy(0.5, [4 6 -8]) ~= int16([1 2 3]) + 0.5*[4 6 -8]))
+	error('Incorrect result');
+end
+clear x;
+
+% reductions
+v = [3 NaN -2 0 7; 1 0 5 -9 2];
+x = matshare.share(v);
+if(x.sum(substruct('()', {':', [1 3]})) ~= sum(sum(v(:, [1 3]))) || ~isnan(x.sum()))
+	error('Incorrect result');
+end
+if(x.minval() ~= min(v(:)) || x.maxval() ~= max(v(:)) || x.nnz() ~= nnz(v) || ~x.any())
+	error('Incorrect result');
+end
+if(x.any(substruct('()', {2, 2})) || x.minval(substruct('()', {1, ':'})) ~= -2)
+	error('Incorrect result');
+end
+x = matshare.share(int16([-300 12 300]));
+if(~isa(x.maxval(), 'int16') || x.maxval() ~= 300 || x.sum() ~= 12)
+	error('Incorrect result');
+end
+
+% indexed operations return only the affected elements
+x = matshare.share(magic(4));
+if(~isequal(x.add(1, substruct('()', {':', 2})), magic(4)*[0;1;0;0] + 1))
+	error('Incorrect result');
+end
+if(~isequal(x.mul(2, substruct('()', {[1 3], ':'}), '-o'), [16 3 3 13; 9 8 6 12]))
+	error('Incorrect result');
+end
+clear x;
+
 fprintf('Test successful.\n\n');
 
@@ -0,0 +1,49 @@
+fprintf('Testing threaded variable operations... ');
+
+matshare.clearshm;
+matshare.config('vt', '4');
+
+% at least four times MSH_VAROP_THREAD_MIN_ELEMS so that whole variable operations use all four threads
+n = 2^20 + 7;
+
+% whole variable operations
+v = rand(n, 1);
+w = rand(n, 1);
+x = matshare.share(v);
+x.add(w);
+if(~isequal(x.data, v + w))
+	error('Threaded add did not match MATLAB.');
+end
+
+v = int16(randi([-30000 30000], n, 1));
+w = int16(randi([-30000 30000], n, 1));
+x = matshare.share(v);
+x.add(w);
+if(~isequal(x.data, v + w))
+	error('Threaded saturating add did not match MATLAB.');
+end
+
+x.add(int16(5));
+if(~isequal(x.data, (v + w) + 5))
+	error('Threaded scalar add did not match MATLAB.');
+end
+
+% indexed operations with repeated subscripts apply once per subscript
+v = zeros(n, 1);
+idx = [randi(n, n, 1); (1:8)'; (1:8)'];
+w = randi(100, numel(idx), 1);
+x = matshare.share(v);
+x.add(w, substruct('()', {idx}));
+expected = v;
+for i = 1:numel(idx)
+	expected(idx(i)) = expected(idx(i)) + w(i);
+end
+if(~isequal(x.data, expected))
+	error('Threaded indexed add with repeated subscripts did not match a sequential add.');
+end
+
+clear x;
+matshare.config('vt', 'auto');
+matshare.clearshm;
+
+fprintf('Test successful.\n\n');
@@ -28,6 +28,21 @@ matshare.tests.single.subsover;
 % test variable operations
 matshare.tests.single.varops;
 
+% test variable operations split across threads
+matshare.tests.single.varopthreads;
+
+% test in-place allocation
+matshare.tests.single.alloc;
+
+% test subscripted and new variable fetches
+matshare.tests.single.fetchsubs;
+
+% test snapshot and restore
+matshare.tests.single.snapshot;
+
+% test delta overwrites
+matshare.tests.single.deltaoverwrite;
+
 fprintf('Test suite ran successfully.\n\n');
 
 
@@ -42,6 +42,10 @@ function INSTALL
 		'mshlockfree.c',...
 		'mshtable.c',...
 		'mshvarops.c',...
+		'mshthreads.c',...
+		'mshpool.c',...
+		'mshprocs.c',...
+		'mshsimd.c',...
 		'headers/opaque/mshheader.c',...
 		'headers/opaque/mshexterntypes.c',...
 		'headers/opaque/mshvariablenode.c',...
@@ -60,7 +64,7 @@ function INSTALL
 		mexflags = [mexflags, {'-DMSH_WIN'}];
 	else
 		userconfigfolder = fullfile(getenv('HOME'), '.config');
-		mexflags = [mexflags, {'-DMSH_UNIX'}];
+		mexflags = [mexflags, {'-DMSH_UNIX', '-lpthread'}];
 		if(~ismac)
 			mexflags = [mexflags, {'-lrt'}];
 		end
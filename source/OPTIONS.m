@@ -23,8 +23,10 @@ function opts = OPTIONS
 
 	opts.mshVarOpsOptsDefault = {};
 
-	% must have at least SSE2, AVX/2 is optional
-	opts.mshUseSSE2=false;
+	% must have at least SSE2, AVX/2 is optional. The variable operations use
+	% the widest vector kernels the processor supports, so compiling in AVX2
+	% is safe on processors without it.
+	opts.mshUseSSE2=true;
 
 	opts.mshUseAVX=false;
 
@@ -42,6 +42,14 @@
 #define MSH_PARAM_VAROP_OPTS_DEFAULT_L   "syncdefault"
 #define MSH_PARAM_VAROP_OPTS_DEFAULT_AB  "sd"
 
+#define MSH_PARAM_EVICTION_POLICY    "EvictionPolicy"
+#define MSH_PARAM_EVICTION_POLICY_L  "evictionpolicy"
+#define MSH_PARAM_EVICTION_POLICY_AB "ep"
+
+#define MSH_PARAM_VAROP_THREADS      "VarOpThreads"
+#define MSH_PARAM_VAROP_THREADS_L    "varopthreads"
+#define MSH_PARAM_VAROP_THREADS_AB   "vt"
+
 #ifdef MSH_UNIX
 #define MSH_CONFIG_SECURITY_STRING_FORMAT \
 "    Security:            '%o'\n"
@@ -59,6 +67,8 @@
 "    Fetch default:                   '%s'\n" \
 "    Variable operations use mutex:   '%s'\n" \
 "    Variable operations use atomics: '%s'\n" \
+"    Eviction policy:                 '%s'\n" \
+"    Variable operation threads:      %lu\n" \
 
 #define MSH_CONFIG_STRING_ARGS \
 MSH_VERSION_STRING, \
@@ -67,7 +77,9 @@ g_user_config.max_shared_size, \
 g_user_config.will_shared_gc? "on" : "off", \
 g_user_config.fetch_default, \
 g_user_config.varop_opts_default & MSH_IS_SYNCHRONOUS? "yes" : "no", \
-g_user_config.varop_opts_default & MSH_USE_ATOMIC_OPS? "yes" : "no"
+g_user_config.varop_opts_default & MSH_USE_ATOMIC_OPS? "yes" : "no", \
+g_user_config.eviction_policy == msh_EVICT_LRU? "lru" : (g_user_config.eviction_policy == msh_EVICT_SIZE? "size" : "none"), \
+g_user_config.varop_threads
 
 #ifdef MSH_WIN
 
@@ -94,24 +106,36 @@ g_local_info.process_lock.lock_size,
 "     rev_num: "SIZE_FORMAT"\n" \
 "     lock_level: %lu\n" \
 "     this_pid: "PID_FORMAT"\n" \
+"     process_slot: %lu\n" \
 "     shared_info_wrapper (struct):\n" \
 "          ptr: "SIZE_FORMAT"\n" \
 "          handle: "HANDLE_FORMAT"\n" \
 MSH_PROCESS_LOCK_FORMAT \
 "     has_fatal_error: %u\n" \
 "     is_initialized: %u\n" \
-"     is_deinitialized: %u\n"
+"     is_deinitialized: %u\n" \
+"     seg_node_pool (struct):\n" \
+"          num_used: "SIZE_FORMAT"\n" \
+"          num_allocated: "SIZE_FORMAT"\n" \
+"     var_node_pool (struct):\n" \
+"          num_used: "SIZE_FORMAT"\n" \
+"          num_allocated: "SIZE_FORMAT"\n"
 
 #define MSH_DEBUG_LOCAL_ARGS \
 g_local_info.rev_num, \
 g_local_info.lock_level, \
 g_local_info.this_pid, \
+(unsigned long)g_local_info.process_slot, \
 g_local_info.shared_info_wrapper.ptr, \
 g_local_info.shared_info_wrapper.handle, \
 MSH_PROCESS_LOCK_ARGS \
 g_local_info.has_fatal_error, \
 g_local_info.is_initialized, \
-g_local_info.is_deinitialized
+g_local_info.is_deinitialized, \
+g_seg_node_pool.num_used, \
+g_seg_node_pool.num_slabs*g_seg_node_pool.nodes_per_slab, \
+g_var_node_pool.num_used, \
+g_var_node_pool.num_slabs*g_var_node_pool.nodes_per_slab
 
 #ifdef MSH_WIN
 #  define MSH_SECURITY_FORMAT \
@@ -187,6 +211,38 @@ g_shared_info->update_pid
 #define MSH_FETCHOPT_ALL    'a'
 #define MSH_FETCHOPT_NAMED  'n'
 
+#define MSH_SNAPSHOT_MAGIC   "MSHSNAP"
+#define MSH_SNAPSHOT_VERSION 2
+
+/**
+ * Leads a snapshot file. The header and each record are padded to the data
+ * alignment so that every payload sits at an aligned offset in the file.
+ */
+typedef struct SnapshotHeader_T
+{
+	char_T magic[8];
+	uint32_T version;
+	uint32_T bitness;
+	size_t num_segments;
+} SnapshotHeader_T;
+
+/**
+ * Precedes the raw data of each segment in a snapshot file.
+ */
+typedef struct SnapshotRecord_T
+{
+	char_T name[MSH_NAME_LEN_MAX];
+	size_t data_size;
+	size_t uncompressed_size;
+	size_t file_size;
+	size_t file_path_offset;
+	uint32_T content_hash;
+	alignedbool_T is_persistent;
+	alignedbool_T has_content_hash;
+	alignedbool_T is_compressed;
+	alignedbool_T is_batch;
+} SnapshotRecord_T;
+
 typedef enum
 {
 	msh_SHARE           = 0x0000,  /* share a variable */
@@ -202,6 +258,12 @@ typedef enum
 	msh_UNLOCK          = 0x000A,  /* release the interprocess lock */
 	msh_CLEAN           = 0x000B,  /* clean invalid and unused segments */
 	msh_STATUS          = 0x000C,  /* print out info about the current state of matshare */
+	msh_ALLOC           = 0x000D,  /* allocate a shared variable without copying */
+	msh_OVERWRITE       = 0x000E,  /* overwrite an entire shared variable in-place */
+	msh_SNAPSHOT        = 0x000F,  /* write all shared variables to a file */
+	msh_RESTORE         = 0x0010,  /* recreate shared variables from a snapshot file */
+	msh_MAPFILE         = 0x0011,  /* share a variable mapped directly from a file */
+	msh_LOADFILE        = 0x0012,  /* read files directly into a new shared variable */
 } msh_directive_T;
 
 /**
@@ -215,6 +277,44 @@ typedef enum
 void msh_Share(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args, int return_to_ans);
 
 
+/**
+ * Allocates a zeroed variable directly in shared memory and returns a shared copy to be filled in place.
+ *
+ * @param nlhs The number of outputs.
+ * @param plhs An array of output mxArrays.
+ * @param num_args The number of arguments.
+ * @param in_args The class name, the dimensions, and any options.
+ * @param return_to_ans Whether the output is going to ans.
+ */
+void msh_Alloc(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args, int return_to_ans);
+
+
+/**
+ * Shares a variable whose data is mapped directly from a raw binary file. The
+ * header is placed in a small segment which the file is mapped directly after.
+ *
+ * @param nlhs The number of outputs.
+ * @param plhs An array of output mxArrays.
+ * @param num_args The number of arguments.
+ * @param in_args The file path, the class name, the dimensions, and any options.
+ * @param return_to_ans Whether the output is going to ans.
+ */
+void msh_MapFile(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args, int return_to_ans);
+
+
+/**
+ * Shares a variable read directly from one or more raw binary files into a new segment
+ * using parallel positional reads.
+ *
+ * @param nlhs The number of outputs. If this is 2 the second output holds the read throughput.
+ * @param plhs An array of output mxArrays.
+ * @param num_args The number of arguments.
+ * @param in_args The files, the class name, the dimensions, and any options.
+ * @param return_to_ans Whether the output is going to ans.
+ */
+void msh_LoadFile(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args, int return_to_ans);
+
+
 /**
  * Fetches variables from shared memory as shared data copies.
  *
@@ -253,4 +353,39 @@ void msh_Config(size_t num_params, const mxArray** in_params);
 
 void msh_VarOps(int nlhs, mxArray** plhs, int num_args, const mxArray** in_args, msh_varop_T varop);
 
+
+/**
+ * Overwrites an entire shared variable in-place. The shape is validated once and the
+ * leaf data is copied in bulk if the classes match. Otherwise this defers to the
+ * generic copy variable operation. With the '-d' option only the blocks which
+ * differ are copied, and the number of changed blocks and the data version are returned.
+ *
+ * @param nlhs The number of outputs.
+ * @param plhs An array of output mxArrays.
+ * @param num_args The number of arguments.
+ * @param in_args The parent variable, the input variable, and a cell of options.
+ */
+void msh_Overwrite(int nlhs, mxArray** plhs, int num_args, const mxArray** in_args);
+
+
+/**
+ * Writes every shared variable to a file. The segment data is written as it is
+ * stored since the variable headers only hold relative offsets.
+ *
+ * @param num_args The number of arguments.
+ * @param in_args The file name.
+ */
+void msh_Snapshot(int num_args, const mxArray** in_args);
+
+
+/**
+ * Recreates the shared variables stored in a snapshot file.
+ *
+ * @param nlhs The number of outputs.
+ * @param plhs An array of output mxArrays. Holds the number of variables restored if requested.
+ * @param num_args The number of arguments.
+ * @param in_args The file name.
+ */
+void msh_Restore(int nlhs, mxArray** plhs, int num_args, const mxArray** in_args);
+
 #endif /* MATSHARE__H */
@@ -110,6 +110,8 @@ typedef int32_T segmentnumber_T; /* segment number identifiers */
 #define MSH_NAME_LEN_MAX 64
 #define MSH_SEG_NUM_MAX 0x7FFFFFFF      /* the maximum segment number (which is int32 max) */
 #define MSH_INVALID_SEG_NUM (-1L)
+#define MSH_MAX_PROCESS_SLOTS 64        /* the maximum number of processes whose references can be reclaimed */
+#define MSH_INVALID_PROCESS_SLOT 0xFFFFFFFF
 
 #if   defined(_MSC_VER)
 #  define MSH_ALIGN(ALIGNMENT) __declspec(align(ALIGNMENT))
@@ -366,6 +366,16 @@ size_t* msh_GetChildOffsets(SharedVariableHeader_T* hdr_ptr);
 SharedVariableHeader_T* msh_GetChildHeader(SharedVariableHeader_T* hdr_ptr, size_t child_num);
 
 
+/**
+ * Finds the child of a scalar struct with the specified field name.
+ *
+ * @param hdr_ptr The shared variable header.
+ * @param field_name The name of the field.
+ * @return A local pointer to the child, or NULL if there is no such field.
+ */
+SharedVariableHeader_T* msh_GetFieldHeader(SharedVariableHeader_T* hdr_ptr, const char_T* field_name);
+
+
 /**
  * Checks if the variable is complex.
  *
@@ -405,6 +415,92 @@ size_t msh_FindSharedSize(const mxArray* in_var);
 size_t msh_CopyVariable(void* dest, const mxArray* in_var);
 
 
+/**
+ * Finds the shared size of a matrix laid out as column blocks.
+ *
+ * @note The returned size does not include the size of segment metadata.
+ * @param in_var The input matrix.
+ * @param num_blocks The number of column blocks.
+ * @return The size of the shared variable.
+ */
+size_t msh_FindBlockedSharedSize(const mxArray* in_var, size_t num_blocks);
+
+
+/**
+ * Copies a matrix into shared memory as a 1-by-num_blocks cell of contiguous column blocks.
+ * Each block has its own allocation header so it may be fetched independently without a copy.
+ *
+ * @param dest The destination pointer.
+ * @param in_var The input matrix.
+ * @param num_blocks The number of column blocks.
+ * @return The number of bytes needed to store this variable.
+ */
+size_t msh_CopyVariableBlocked(void* dest, const mxArray* in_var, size_t num_blocks);
+
+
+/**
+ * Finds the shared size of a new variable with the given class and dimensions.
+ *
+ * @note The returned size does not include the size of segment metadata.
+ * @param class_id The class of the variable. Must be numeric, logical, or char.
+ * @param num_dims The number of dimensions.
+ * @param dims The dimensions.
+ * @param is_complex Whether space should be made for imaginary data.
+ * @return The size of the shared variable.
+ */
+size_t msh_FindAllocatedSize(mxClassID class_id, size_t num_dims, const mwSize* dims, int is_complex);
+
+
+/**
+ * Lays out the header for a new variable at the destination pointer without copying any data.
+ *
+ * @note The data is expected to have been zeroed beforehand.
+ * @param dest The destination pointer.
+ * @param class_id The class of the variable.
+ * @param num_dims The number of dimensions.
+ * @param dims The dimensions.
+ * @param is_complex Whether the variable is complex.
+ * @return The number of bytes needed to store this variable.
+ */
+size_t msh_AllocateVariable(void* dest, mxClassID class_id, size_t num_dims, const mwSize* dims, int is_complex);
+
+
+/**
+ * Finds the size of the data of a variable which will be read or mapped from a file.
+ *
+ * @param class_id The class of the variable. Must be numeric, logical, or char.
+ * @param num_dims The number of dimensions.
+ * @param dims The dimensions.
+ * @return The size of the data in bytes.
+ */
+size_t msh_FindMappedDataSize(mxClassID class_id, size_t num_dims, const mwSize* dims);
+
+
+/**
+ * Finds the minimum size needed to lay out the header of a variable mapped from a file.
+ * This includes the dimensions, the file path, and the mxMalloc signature.
+ *
+ * @param num_dims The number of dimensions.
+ * @param file_path The path of the mapped file.
+ * @return The minimum size of the header.
+ */
+size_t msh_FindMappedHeaderSize(size_t num_dims, const char_T* file_path);
+
+
+/**
+ * Lays out the header for a variable whose data is mapped from a file at the given offset.
+ *
+ * @param dest The destination pointer.
+ * @param class_id The class of the variable.
+ * @param num_dims The number of dimensions.
+ * @param dims The dimensions.
+ * @param file_path The path of the mapped file, stored after the dimensions.
+ * @param data_offset The offset of the mapped data from the header.
+ * @return The offset of the file path from the header.
+ */
+size_t msh_MapVariable(void* dest, mxClassID class_id, size_t num_dims, const mwSize* dims, const char_T* file_path, size_t data_offset);
+
+
 /**
  * Creates a new mxArray from the specified shared variable header tree.
  *
@@ -414,6 +510,18 @@ size_t msh_CopyVariable(void* dest, const mxArray* in_var);
 mxArray* msh_FetchVariable(SharedVariableHeader_T* shared_header);
 
 
+/**
+ * Walks the shared variable header tree to the subtree addressed by the subscript struct.
+ * Supports brace indexing into cells, field references, and parenthesis indexing to
+ * select a struct element before a field reference.
+ *
+ * @param shared_header The shared variable header.
+ * @param subs_struct The subscript struct, in the style of that returned by substruct.
+ * @return The header of the addressed subtree.
+ */
+SharedVariableHeader_T* msh_GetSubscriptedHeader(SharedVariableHeader_T* shared_header, const mxArray* subs_struct);
+
+
 /**
  * Overwrites the data in the specified shared variable.
  *
@@ -424,6 +532,18 @@ mxArray* msh_FetchVariable(SharedVariableHeader_T* shared_header);
 void msh_OverwriteHeader(SharedVariableHeader_T* shared_header, const mxArray* in_var);
 
 
+/**
+ * Overwrites the data in the specified shared variable, copying only the
+ * blocks of data which have changed.
+ *
+ * @note This is not an atomic operation.
+ * @param shared_header The shared variable header.
+ * @param in_var The input variable. Must have the same size and class.
+ * @return The number of blocks which changed.
+ */
+size_t msh_OverwriteHeaderDelta(SharedVariableHeader_T* shared_header, const mxArray* in_var);
+
+
 /**
  * Recursively compares the size of the shared variable in the input variable.
  *
@@ -434,6 +554,26 @@ void msh_OverwriteHeader(SharedVariableHeader_T* shared_header, const mxArray* i
 int msh_CompareHeaderSize(SharedVariableHeader_T* shared_header, const mxArray* comp_var);
 
 
+/**
+ * Recursively hashes the class, dimensions, field names, and leaf data of the input variable.
+ *
+ * @param in_var The input variable.
+ * @param seed The hash seed.
+ * @return The content hash.
+ */
+uint32_T msh_HashVariableContent(const mxArray* in_var, uint32_T seed);
+
+
+/**
+ * Compares the contents of the shared variable and the input variable.
+ *
+ * @param shared_header The shared variable header.
+ * @param comp_var The input comparison variable.
+ * @return Whether the variables have the same class, size, and data.
+ */
+int msh_CompareVariableContent(SharedVariableHeader_T* shared_header, const mxArray* comp_var);
+
+
 /**
  * Detaches the specified variable from shared memoory.
  *
@@ -445,10 +585,21 @@ void msh_DetachVariable(mxArray* ret_var);
 /**
  * Gets the segment data (the first shared variable header in the segment).
  *
+ * @note If the segment is compressed this is a private decompressed copy.
  * @param seg_node The segment node.
  * @return The segment data.
  */
 SharedVariableHeader_T* msh_GetSegmentData(struct SegmentNode_T* seg_node);
 
 
+/**
+ * Gets the data of the segment as it is stored in shared memory. This
+ * is never decompressed.
+ *
+ * @param seg_node The segment node.
+ * @return The raw segment data.
+ */
+void* msh_GetSegmentRawData(struct SegmentNode_T* seg_node);
+
+
 #endif /* MATSHARE_MSHHEADERTYPE_H */
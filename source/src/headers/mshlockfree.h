@@ -18,6 +18,18 @@
 #define VO_FCN_SNAME_(TYPEN) msh_AtomicSet##TYPEN
 #define VO_FCN_SNAME(TYPEN) VO_FCN_SNAME_(TYPEN)
 
+#define VO_FCN_CXNAME_(TYPEN) msh_AtomicCompareExchange##TYPEN
+#define VO_FCN_CXNAME(TYPEN) VO_FCN_CXNAME_(TYPEN)
+
+#define VO_FCN_ANDNAME_(TYPEN) msh_AtomicAnd##TYPEN
+#define VO_FCN_ANDNAME(TYPEN) VO_FCN_ANDNAME_(TYPEN)
+
+#define VO_FCN_ORNAME_(TYPEN) msh_AtomicOr##TYPEN
+#define VO_FCN_ORNAME(TYPEN) VO_FCN_ORNAME_(TYPEN)
+
+#define VO_FCN_XORNAME_(TYPEN) msh_AtomicXor##TYPEN
+#define VO_FCN_XORNAME(TYPEN) VO_FCN_XORNAME_(TYPEN)
+
 
 /* for lcc compatibility --- matshare requires at least Windows XP */
 #if defined(MSH_WIN) && defined(__LCC__)
@@ -166,6 +178,32 @@ uint64_T VO_FCN_CASNAME(UInt64)(volatile uint64_T* dest, uint64_T comp_val, uint
 single VO_FCN_CASNAME(Single)(volatile single* dest, single comp_val, single set_val);
 double VO_FCN_CASNAME(Double)(volatile double* dest, double comp_val, double set_val);
 
+/**
+ * Sets the destination to set_val if its bit pattern matches that of the expected
+ * value. Otherwise the expected value is replaced with the value at the destination,
+ * so the caller may retry without reloading. Comparing bit patterns rather than
+ * values means that NaNs and signed zeros in floating point destinations are
+ * handled correctly.
+ *
+ * @param dest A pointer to the destination.
+ * @param expected A pointer to the expected value.
+ * @param set_val The value to set the destination to.
+ * @return Whether the destination was set.
+ */
+bool_T VO_FCN_CXNAME(Int8)(volatile int8_T* dest, int8_T* expected, int8_T set_val);
+bool_T VO_FCN_CXNAME(Int16)(volatile int16_T* dest, int16_T* expected, int16_T set_val);
+bool_T VO_FCN_CXNAME(Int32)(volatile int32_T* dest, int32_T* expected, int32_T set_val);
+
+bool_T VO_FCN_CXNAME(UInt8)(volatile uint8_T* dest, uint8_T* expected, uint8_T set_val);
+bool_T VO_FCN_CXNAME(UInt16)(volatile uint16_T* dest, uint16_T* expected, uint16_T set_val);
+bool_T VO_FCN_CXNAME(UInt32)(volatile uint32_T* dest, uint32_T* expected, uint32_T set_val);
+
+bool_T VO_FCN_CXNAME(Int64)(volatile int64_T* dest, int64_T* expected, int64_T set_val);
+bool_T VO_FCN_CXNAME(UInt64)(volatile uint64_T* dest, uint64_T* expected, uint64_T set_val);
+
+bool_T VO_FCN_CXNAME(Single)(volatile single* dest, single* expected, single set_val);
+bool_T VO_FCN_CXNAME(Double)(volatile double* dest, double* expected, double set_val);
+
 int8_T  VO_FCN_SNAME(Int8)(volatile int8_T* dest, int8_T set_val);
 int16_T VO_FCN_SNAME(Int16)(volatile int16_T* dest, int16_T set_val);
 int32_T VO_FCN_SNAME(Int32)(volatile int32_T* dest, int32_T set_val);
@@ -182,5 +220,43 @@ double VO_FCN_SNAME(Double)(volatile double* dest, double set_val);
 
 size_t msh_AtomicSetSize(volatile size_t* dest, size_t set_val);
 
+/**
+ * Applies the bitwise operation to the destination with the value in a single
+ * locked instruction, so no retry loop is needed.
+ *
+ * @param dest A pointer to the destination.
+ * @param val The other operand.
+ * @return The value of the destination before the operation.
+ */
+int8_T  VO_FCN_ANDNAME(Int8)(volatile int8_T* dest, int8_T val);
+int16_T VO_FCN_ANDNAME(Int16)(volatile int16_T* dest, int16_T val);
+int32_T VO_FCN_ANDNAME(Int32)(volatile int32_T* dest, int32_T val);
+int64_T VO_FCN_ANDNAME(Int64)(volatile int64_T* dest, int64_T val);
+
+uint8_T  VO_FCN_ANDNAME(UInt8)(volatile uint8_T* dest, uint8_T val);
+uint16_T VO_FCN_ANDNAME(UInt16)(volatile uint16_T* dest, uint16_T val);
+uint32_T VO_FCN_ANDNAME(UInt32)(volatile uint32_T* dest, uint32_T val);
+uint64_T VO_FCN_ANDNAME(UInt64)(volatile uint64_T* dest, uint64_T val);
+
+int8_T  VO_FCN_ORNAME(Int8)(volatile int8_T* dest, int8_T val);
+int16_T VO_FCN_ORNAME(Int16)(volatile int16_T* dest, int16_T val);
+int32_T VO_FCN_ORNAME(Int32)(volatile int32_T* dest, int32_T val);
+int64_T VO_FCN_ORNAME(Int64)(volatile int64_T* dest, int64_T val);
+
+uint8_T  VO_FCN_ORNAME(UInt8)(volatile uint8_T* dest, uint8_T val);
+uint16_T VO_FCN_ORNAME(UInt16)(volatile uint16_T* dest, uint16_T val);
+uint32_T VO_FCN_ORNAME(UInt32)(volatile uint32_T* dest, uint32_T val);
+uint64_T VO_FCN_ORNAME(UInt64)(volatile uint64_T* dest, uint64_T val);
+
+int8_T  VO_FCN_XORNAME(Int8)(volatile int8_T* dest, int8_T val);
+int16_T VO_FCN_XORNAME(Int16)(volatile int16_T* dest, int16_T val);
+int32_T VO_FCN_XORNAME(Int32)(volatile int32_T* dest, int32_T val);
+int64_T VO_FCN_XORNAME(Int64)(volatile int64_T* dest, int64_T val);
+
+uint8_T  VO_FCN_XORNAME(UInt8)(volatile uint8_T* dest, uint8_T val);
+uint16_T VO_FCN_XORNAME(UInt16)(volatile uint16_T* dest, uint16_T val);
+uint32_T VO_FCN_XORNAME(UInt32)(volatile uint32_T* dest, uint32_T val);
+uint64_T VO_FCN_XORNAME(UInt64)(volatile uint64_T* dest, uint64_T val);
+
 
 #endif /* MATSHARE_MSHLOCKFREE_H */
@@ -0,0 +1,57 @@
+/** mshpool.h
+ * Declares fixed-size node pools backed by persistent slabs.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef MATSHARE_MSHPOOL_H
+#define MATSHARE_MSHPOOL_H
+
+#include "mshbasictypes.h"
+
+typedef struct NodePool_T
+{
+	void*  free_list;          /* free nodes, linked through their first word */
+	void*  slabs;              /* allocated slabs, linked through their headers */
+	size_t node_size;
+	size_t nodes_per_slab;
+	size_t num_slabs;
+	size_t num_used;
+} NodePool_T;
+
+/**
+ * Statically initializes a pool of nodes of the given size.
+ */
+#define MSH_NODE_POOL_INITIALIZER(NODE_SIZE, NODES_PER_SLAB) {NULL, NULL, (NODE_SIZE), (NODES_PER_SLAB), 0, 0}
+
+
+/**
+ * Takes a node from the pool. A new persistent slab is allocated if there are
+ * no free nodes. The node is not zeroed.
+ *
+ * @param node_pool The node pool.
+ * @return The node.
+ */
+void* msh_AllocateNode(NodePool_T* node_pool);
+
+
+/**
+ * Returns a node to the pool.
+ *
+ * @param node_pool The node pool.
+ * @param node The node, which must have been taken from the same pool.
+ */
+void msh_FreeNode(NodePool_T* node_pool, void* node);
+
+
+/**
+ * Frees all slabs of the pool if none of its nodes are in use.
+ *
+ * @param node_pool The node pool.
+ */
+void msh_DestroyNodePool(NodePool_T* node_pool);
+
+#endif /* MATSHARE_MSHPOOL_H */
@@ -0,0 +1,82 @@
+/** mshprocs.h
+ * Declares functions for recording the references held by each
+ * process and reclaiming those of processes which have died.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef MATSHARE_MSHPROCS_H
+#define MATSHARE_MSHPROCS_H
+
+#include "mshtypes.h"
+#include "mshsegments.h"
+
+/**
+ * Note: the counters procs_using and procs_tracking in the segment metadata are
+ *       shared by all processes, so a process which is killed never releases its
+ *       share of them. Each process therefore claims a slot in the shared info
+ *       and records its own share of each counter in the segment metadata. The
+ *       reaper subtracts the shares of slots whose processes no longer exist.
+ */
+
+/**
+ * Claims a process slot for this process, reaping dead processes first.
+ * If every slot is in use the process runs without one and its references
+ * cannot be reclaimed should it die.
+ */
+void msh_AcquireProcessSlot(void);
+
+
+/**
+ * Frees the process slot of this process.
+ */
+void msh_ReleaseProcessSlot(void);
+
+
+/**
+ * Releases the references held by processes which have died and frees their
+ * slots. Segments which are no longer used are garbage collected.
+ *
+ * @param seg_list The segment list used to track the shared segments.
+ * @return The number of dead processes which were reaped.
+ */
+uint32_T msh_ReapDeadProcesses(SegmentList_T* seg_list);
+
+
+/**
+ * Increments procs_using and records the reference under this process.
+ *
+ * @param metadata The segment metadata.
+ * @return The value of procs_using immediately after the increment.
+ */
+long msh_IncrementProcsUsing(SegmentMetadata_T* metadata);
+
+
+/**
+ * Decrements procs_using and removes the reference recorded under this process.
+ *
+ * @param metadata The segment metadata.
+ * @return The value of procs_using immediately after the decrement.
+ */
+long msh_DecrementProcsUsing(SegmentMetadata_T* metadata);
+
+
+/**
+ * Records that this process incremented procs_tracking. Called after the increment.
+ *
+ * @param metadata The segment metadata.
+ */
+void msh_RecordTracking(SegmentMetadata_T* metadata);
+
+
+/**
+ * Records that this process is about to decrement procs_tracking. Called before the decrement.
+ *
+ * @param metadata The segment metadata.
+ */
+void msh_RecordUntracking(SegmentMetadata_T* metadata);
+
+#endif /* MATSHARE_MSHPROCS_H */
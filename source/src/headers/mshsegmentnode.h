@@ -33,6 +33,17 @@ typedef struct SegmentMetadata_T
 	volatile segmentnumber_T next_seg_num;
 	volatile long procs_using;                   /* number of processes using this variable */
 	volatile LockFreeCounter_T procs_tracking;
+	alignedbool_T has_content_hash;              /* set to TRUE if this segment may be matched by deduplicated shares; non-volatile */
+	uint32_T content_hash;                       /* hash of the variable contents; non-volatile */
+	alignedbool_T is_compressed;                 /* set to TRUE if the data is compressed; non-volatile */
+	size_t uncompressed_size;                    /* size of the data after decompression; non-volatile */
+	size_t file_size;                            /* size of the file mapped directly after the segment, zero if none; non-volatile */
+	size_t file_path_offset;                     /* offset of the mapped file path from the segment data; non-volatile */
+	volatile long data_version;                  /* incremented once for each delta overwrite which changed the data */
+	alignedbool_T is_batch;                      /* set to TRUE if the data is a directory of variables shared together; non-volatile */
+	volatile long last_access;                   /* value of the shared access clock when the segment was last handed out */
+	volatile long slot_using[MSH_MAX_PROCESS_SLOTS];    /* share of procs_using held by each process slot */
+	volatile long slot_tracking[MSH_MAX_PROCESS_SLOTS]; /* share of procs_tracking held by each process slot */
 } SegmentMetadata_T;
 
 typedef struct SegmentInfo_T
@@ -43,9 +54,13 @@ typedef struct SegmentInfo_T
 	handle_T           handle;
 	FileLock_T         lock;
 	segmentnumber_T    seg_num;
+	void*              cache_alloc;    /* private allocation holding the decompressed data */
+	void*              cache_ptr;      /* aligned pointer to the decompressed data */
+	size_t             file_size;      /* size of the file mapped after raw_ptr */
 } SegmentInfo_T;
 
 #define msh_HasVariableName(seg_node) (msh_GetSegmentMetadata(seg_node)->name[0] != '\0')
+#define msh_IsBatchSegment(seg_node) (msh_GetSegmentMetadata(seg_node)->is_batch)
 
 /**
  * Creates a segment node (which is a linked list wrapper for a shared segment).
@@ -101,6 +116,16 @@ SegmentNode_T* msh_GetPreviousSegment(SegmentNode_T* seg_node);
 SegmentInfo_T* msh_GetSegmentInfo(SegmentNode_T* seg_node);
 
 
+/**
+ * Gets the process-local generation of the segment node. Each segment node
+ * created by this process has a different generation.
+ *
+ * @param seg_node The segment node.
+ * @return The generation.
+ */
+uint32_T msh_GetSegmentGeneration(SegmentNode_T* seg_node);
+
+
 /**
  * Gets the associated variable node.
  *
@@ -110,6 +135,15 @@ SegmentInfo_T* msh_GetSegmentInfo(SegmentNode_T* seg_node);
 struct VariableNode_T* msh_GetVariableNode(SegmentNode_T* seg_node);
 
 
+/**
+ * Gets the first variable node materialized from a subscript of this segment.
+ *
+ * @param seg_node The segment node.
+ * @return The first sub-variable node.
+ */
+struct VariableNode_T* msh_GetSubVariableNode(SegmentNode_T* seg_node);
+
+
 /**
  * Sets the parent segment list for the segment node.
  *
@@ -155,4 +189,13 @@ void msh_SetSegmentInfo(SegmentNode_T* seg_node, SegmentInfo_T* seg_info);
  */
 void msh_SetVariableNode(SegmentNode_T* seg_node, struct VariableNode_T* var_node);
 
+
+/**
+ * Sets the first variable node materialized from a subscript of this segment.
+ *
+ * @param seg_node The segment node.
+ * @param subvar_node The sub-variable node.
+ */
+void msh_SetSubVariableNode(SegmentNode_T* seg_node, struct VariableNode_T* subvar_node);
+
 #endif /* MATSHARE_MSHSEGMENTNODE_H */
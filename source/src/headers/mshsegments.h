@@ -20,6 +20,9 @@ struct SharedVariableHeader_T;
 /* forward declaration */
 struct SegmentTable_T;
 
+/* maximum number of dead segments reclaimed under one acquisition of the process lock */
+#define MSH_RECLAIM_BATCH_SIZE 64
+
 typedef struct SegmentList_T
 {
 	SegmentTable_T* seg_table;
@@ -28,6 +31,7 @@ typedef struct SegmentList_T
 	SegmentNode_T* last;
 	uint32_T num_segs;
 	uint32_T num_named;
+	size_t clean_rev_num;              /* the shared revision number at the last clean */
 } SegmentList_T;
 
 typedef void (*UpdateFunction_t)(SegmentList_T*);
@@ -104,6 +108,34 @@ void msh_AddSegmentToSharedList(SegmentNode_T* seg_node);
 void msh_RemoveSegmentFromSharedList(SegmentNode_T* seg_node);
 
 
+/**
+ * Removes several segments from the shared list while holding the
+ * process lock once, with a single revision number increment.
+ *
+ * @param seg_nodes The segment nodes containing the segments to remove.
+ * @param num_segs The number of segment nodes.
+ */
+void msh_RemoveSegmentsFromSharedList(SegmentNode_T** seg_nodes, size_t num_segs);
+
+
+/**
+ * Removes the segments from the shared list in one critical section, then
+ * detaches them locally.
+ *
+ * @param seg_nodes The segment nodes to be reclaimed.
+ * @param num_segs The number of segment nodes.
+ */
+void msh_ReclaimSegments(SegmentNode_T** seg_nodes, size_t num_segs);
+
+
+/**
+ * Records an access to the segment for the LRU eviction policy.
+ *
+ * @param seg_node The segment node.
+ */
+void msh_TouchSegment(SegmentNode_T* seg_node);
+
+
 /**
  * Detaches all segments in the specified segment list.
  *
@@ -157,6 +189,9 @@ SegmentNode_T* msh_RemoveSegmentFromList(SegmentNode_T* seg_node);
 
 /**
  * Detaches segments that have been marked as invalid in shared memory.
+ * Segments are only invalidated alongside a revision number increment,
+ * so the list is not walked if the revision has not changed since the
+ * last clean.
  *
  * @param seg_list The segment list to be cleaned.
  */
@@ -191,6 +226,37 @@ handle_T msh_CreateSharedMemory(char_T* segment_name, size_t segment_size);
 handle_T msh_OpenSharedMemory(char_T* segment_name);
 
 
+/**
+ * Finds a data size of at least the given size such that the segment ends on a page
+ * boundary. This is used so that a file can be mapped directly after the segment.
+ *
+ * @param min_data_size The minimum size of the data.
+ * @return The padded size of the data.
+ */
+size_t msh_FindPageAlignedDataSize(size_t min_data_size);
+
+
+/**
+ * Records a file to be mapped directly after the segment data. Any existing
+ * mapping of the segment is released so it can be mapped again with the file.
+ *
+ * @param seg_node The segment node.
+ * @param file_path_offset The offset of the file path from the segment data.
+ * @param file_size The size of the file mapping.
+ */
+void msh_SetSegmentFile(SegmentNode_T* seg_node, size_t file_path_offset, size_t file_size);
+
+
+/**
+ * Maps the segment memory. If a file is attached to the segment it is
+ * mapped in shared mode directly after the segment.
+ *
+ * @param seg_info The segment info.
+ * @return A pointer to the start of the map.
+ */
+void* msh_MapSegmentMemory(SegmentInfo_T* seg_info);
+
+
 /**
  * Creates a map to the segment specified by the handle with the
  * specified size.
@@ -236,18 +302,37 @@ void msh_LockMemory(void* ptr, size_t sz);
  */
 void msh_UnlockMemory(void* ptr, size_t sz);
 
-uint32_T msh_GetSegmentHashByNumber(SegmentTable_T* seg_table, void* seg_num);
+uint32_T msh_GetSegmentHashByNumber(void* seg_num);
 
 int msh_CompareNumericKey(void* node_seg_num, void* comp_seg_num);
 
-uint32_T msh_GetSegmentHashByName(SegmentTable_T* seg_table, void* varname);
+uint32_T msh_GetSegmentHashByName(void* varname);
 
 int msh_CompareStringKey(void* node_str, void* comp_str);
 
-uint32_T msh_GetSegmentHashByVariableAddress(SegmentTable_T* seg_table, void* var_address);
+uint32_T msh_GetSegmentHashByVariableAddress(void* var_address);
 
 int msh_CompareVariableAddressKey(void* var_address, void* comp_var_address);
 
 SegmentNode_T* msh_FindSegmentNodeFromCrosslink(SegmentTable_T* seg_table, const mxArray* dest_var);
 
+/**
+ * Creates a handle identifying the segment node, to be stored alongside one of its variables.
+ *
+ * @param seg_node The segment node.
+ * @param is_primary Whether the variable is the whole segment variable rather than a sub-variable.
+ * @return A 1x3 uint32 array holding the segment number, generation, and primary flag.
+ */
+mxArray* msh_CreateSegmentHandle(SegmentNode_T* seg_node, int is_primary);
+
+/**
+ * Finds the segment node identified by the handle.
+ *
+ * @param seg_table The segment number table to be searched.
+ * @param seg_handle A handle created by msh_CreateSegmentHandle.
+ * @param is_primary Set to the primary flag of the handle if the segment node was found. May be NULL.
+ * @return The segment node, or NULL if the handle is invalid or the segment node no longer exists.
+ */
+SegmentNode_T* msh_FindSegmentNodeFromHandle(SegmentTable_T* seg_table, const mxArray* seg_handle, int* is_primary);
+
 #endif /* MATSHARE_MSHSEGMENTS_H */
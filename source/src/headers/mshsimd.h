@@ -0,0 +1,91 @@
+/** mshsimd.h
+ * Declares vectorized kernels for the variable operations and
+ * the runtime dispatch to them.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef MATSHARE_MSHSIMD_H
+#define MATSHARE_MSHSIMD_H
+
+#include "mshvarops.h"
+
+/**
+ * Note: the kernels are compiled in with MSH_USE_SSE2 and MSH_USE_AVX2, and
+ *       the widest set supported by the processor is chosen at runtime, so a
+ *       build with AVX2 kernels still runs on processors without AVX2.
+ */
+
+typedef enum
+{
+	msh_SIMD_NONE = 0,
+	msh_SIMD_SSE2 = 1,
+	msh_SIMD_AVX2 = 2
+} msh_simdlevel_T;
+
+/* the most lanes a reduction can store, for sizing the lanes buffer */
+#define MSH_SIMD_MAX_LANES 32
+
+
+/**
+ * Gets the widest instruction set which has kernels compiled in and is
+ * supported by the processor and operating system.
+ *
+ * @return The instruction set level.
+ */
+msh_simdlevel_T msh_GetSIMDLevel(void);
+
+
+/**
+ * Runs a non-atomic binary operation on operands of the same type with
+ * vector instructions. Only whole vectors are processed; the caller must
+ * finish the remaining elements with the scalar operation.
+ *
+ * @param varop The variable operation.
+ * @param mxtype The type of both operands.
+ * @param accum The accumulator data.
+ * @param in The input data.
+ * @param num_elems The number of elements in the accumulator.
+ * @param is_scalar_in Whether the input is a single element applied to every element of the accumulator.
+ * @return The number of leading elements which were processed.
+ */
+size_t msh_SIMDBinaryOp(msh_varop_T varop, mxClassID mxtype, void* accum, const void* in, size_t num_elems, bool_T is_scalar_in);
+
+
+/**
+ * Converts the input to the output type with vector instructions, with the
+ * same rounding and saturation as the scalar type converters. Only whole
+ * vectors are processed; the caller must convert the remaining elements.
+ *
+ * @param out_mxtype The type of the output.
+ * @param in_mxtype The type of the input.
+ * @param out The output buffer.
+ * @param in The input data.
+ * @param num_elems The number of elements to convert.
+ * @return The number of leading elements which were converted.
+ */
+size_t msh_SIMDConvert(mxClassID out_mxtype, mxClassID in_mxtype, void* out, const void* in, size_t num_elems);
+
+
+/**
+ * Reduces the input for the read-only variable operations with vector
+ * instructions. Only whole vectors are processed, and the partial result of
+ * each vector lane is stored for the caller to combine with the scalar
+ * reduction of the remaining elements. The lanes are doubles for VAROP_SUM,
+ * a single uint64_T count for VAROP_ANY and VAROP_NNZ, and of the input type
+ * for VAROP_MINVAL and VAROP_MAXVAL.
+ *
+ * @param varop The reduction.
+ * @param mxtype The type of the input.
+ * @param in The input data.
+ * @param num_elems The number of elements in the input.
+ * @param lanes The output buffer for the lanes, with room for MSH_SIMD_MAX_LANES of the lane type.
+ * @param num_lanes Set to the number of lanes stored, or zero if no elements were processed.
+ * @return The number of leading elements which were reduced.
+ */
+size_t msh_SIMDReduce(msh_varop_T varop, mxClassID mxtype, const void* in, size_t num_elems, void* lanes, size_t* num_lanes);
+
+#endif /* MATSHARE_MSHSIMD_H */
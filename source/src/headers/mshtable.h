@@ -4,18 +4,20 @@
 #include "mshsegmentnode.h"
 
 
-typedef struct SegmentTableNode_T
+typedef struct SegmentTableEntry_T
 {
-	struct SegmentTableNode_T* next;
-	SegmentNode_T* seg_node;
+	SegmentNode_T* seg_node;    /* NULL if the slot is empty */
 	void* key;
-} SegmentTableNode_T;
+	uint32_T hash;
+	uint32_T probe_len;         /* distance of the slot from the home slot of the hash */
+} SegmentTableEntry_T;
 
 typedef struct SegmentTable_T
 {
-	SegmentTableNode_T** table;
-	uint32_T table_sz;
-	uint32_T (*get_hash)(struct SegmentTable_T*, void*);
+	SegmentTableEntry_T* table; /* open addressed with Robin Hood linear probing */
+	uint32_T table_sz;          /* always a power of two */
+	uint32_T num_entries;
+	uint32_T (*get_hash)(void*);
 	int (*compare_keys)(void*, void*);
 } SegmentTable_T;
 
@@ -23,7 +25,7 @@ typedef struct SegmentTable_T
 /**
  * Initializes the segment hash table.
  *
- * @note allocates an array of size MSH_INIT_TABLE_SIZE.
+ * @note allocates an array of MSH_INIT_TABLE_SIZE entries.
  * @param seg_table A pointer to a segment hash table struct.
  */
 void msh_InitializeTable(SegmentTable_T* seg_table);
@@ -50,7 +52,18 @@ void msh_AddSegmentToTable(SegmentTable_T* seg_table, SegmentNode_T* seg_node, v
 SegmentNode_T* msh_FindSegmentNode(SegmentTable_T* seg_table, void* key);
 
 
-void msh_FindAllSegmentNodes(SegmentTable_T* seg_table, struct SegmentList_T* seg_list_cache, void* key);
+/**
+ * Finds the next table entry matching the key. The entries reference the tracked
+ * segment nodes directly, so nothing is allocated for the search.
+ *
+ * @note The table must not be modified between calls continuing the same search.
+ * @param seg_table The segment table to be searched.
+ * @param prev_entry The previous match, or NULL to find the first match.
+ * @param key The key.
+ * @return The next matching table entry, or NULL if there are no more matches.
+ */
+SegmentTableEntry_T* msh_FindTableEntry(SegmentTable_T* seg_table, SegmentTableEntry_T* prev_entry, void* key);
+
 
 /**
  * Removes the specified segment node from the hash table.
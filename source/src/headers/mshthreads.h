@@ -0,0 +1,47 @@
+/** mshthreads.h
+ * Declares functions for running work on native threads.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef MATSHARE_MSHTHREADS_H
+#define MATSHARE_MSHTHREADS_H
+
+#include "mshbasictypes.h"
+
+typedef void (*ThreadFunction_T)(void* thread_arg);
+
+
+/**
+ * Gets the number of processors currently online.
+ *
+ * @return The number of processors.
+ */
+size_t msh_GetNumProcessors(void);
+
+
+/**
+ * Runs the thread function once for each argument, each on its own thread, and
+ * waits for all of them to finish. The first argument is run on the calling thread.
+ * If a thread cannot be started its argument is run on the calling thread instead.
+ *
+ * @note The thread function must not call into the MATLAB API or raise errors.
+ * @param thread_function The function to run.
+ * @param thread_args The array of arguments.
+ * @param arg_size The size of each argument.
+ * @param num_threads The number of arguments.
+ */
+void msh_RunThreads(ThreadFunction_T thread_function, void* thread_args, size_t arg_size, size_t num_threads);
+
+
+/**
+ * Gets a monotonic time in seconds for measuring intervals.
+ *
+ * @return The time in seconds.
+ */
+double msh_GetTime(void);
+
+#endif /* MATSHARE_MSHTHREADS_H */
@@ -40,6 +40,23 @@
 #  endif
 #endif
 
+/* which unused segments are evicted first when the maximum shared size is reached */
+typedef enum
+{
+	msh_EVICT_NONE = 0,                /* never evict */
+	msh_EVICT_LRU  = 1,                /* least recently accessed first */
+	msh_EVICT_SIZE = 2                 /* largest first */
+} msh_eviction_T;
+
+#ifndef MSH_DEFAULT_EVICTION_POLICY
+#  define MSH_DEFAULT_EVICTION_POLICY msh_EVICT_NONE
+#endif
+
+/* zero uses one thread per processor */
+#ifndef MSH_DEFAULT_VAROP_THREADS
+#  define MSH_DEFAULT_VAROP_THREADS 0
+#endif
+
 typedef struct UserConfig_T
 {
 	/* these are aligned for lockless assignment */
@@ -54,8 +71,17 @@ typedef struct UserConfig_T
 	char_T fetch_default[MSH_NAME_LEN_MAX];
 	long varop_opts_default;
 	long version;
+	long eviction_policy;              /* appended so older config files still load */
+	unsigned long varop_threads;
 } UserConfig_T;
 
+/* identifies a process attached to matshare; the start time distinguishes processes with recycled PIDs */
+typedef struct ProcessSlot_T
+{
+	pid_T pid;                         /* zero if the slot is free */
+	uint64_T start_time;               /* zero if unavailable on this platform */
+} ProcessSlot_T;
+
 /* structure of shared info about the shared segments */
 typedef volatile struct SharedInfo_T
 {
@@ -73,6 +99,11 @@ typedef volatile struct SharedInfo_T
 	LockFreeCounter_T num_procs;
 #endif
 	pid_T update_pid;
+	long num_compressed_segments;
+	size_t total_compressed_size;      /* sizes of the data of compressed segments */
+	size_t total_uncompressed_size;
+	ProcessSlot_T process_slots[MSH_MAX_PROCESS_SLOTS];
+	long access_clock;                 /* logical clock for segment access times */
 } SharedInfo_T;
 
 
@@ -81,6 +112,7 @@ typedef struct LocalInfo_T
 	size_t rev_num;
 	uint32_T lock_level;
 	pid_T this_pid;
+	uint32_T process_slot;             /* index into the shared process slots, MSH_INVALID_PROCESS_SLOT if none */
 	
 	struct shared_info_wrapper_tag
 	{
@@ -127,6 +159,16 @@ extern struct SegmentList_T g_local_seg_list;
  */
 extern struct VariableList_T g_local_var_list;
 
+/**
+ * Forward declaration of the segment node pool.
+ */
+extern struct NodePool_T g_seg_node_pool;
+
+/**
+ * Forward declaration of the variable node pool.
+ */
+extern struct NodePool_T g_var_node_pool;
+
 #define g_shared_info (g_local_info.shared_info_wrapper.ptr)
 
 #define g_process_lock (g_local_info.process_lock)
@@ -67,4 +67,49 @@ void msh_CheckVarname(const mxArray* varname);
 
 uint32_T msh_MurmurHash3(const uint8_T* key, size_t len, int seed);
 
+
+/**
+ * Finds the maximum size of the compressed output for an input of the specified size.
+ *
+ * @param src_sz The size of the input.
+ * @return The maximum size of the compressed output.
+ */
+size_t msh_FindCompressedBound(size_t src_sz);
+
+
+/**
+ * Compresses the input by shuffling bytes into lanes of MSH_SHUFFLE_STRIDE and run-length encoding the result.
+ *
+ * @param dest The destination buffer. Must have a size of at least msh_FindCompressedBound(src_sz).
+ * @param src The input buffer.
+ * @param src_sz The size of the input.
+ * @return The size of the compressed output.
+ */
+size_t msh_Compress(uint8_T* dest, const uint8_T* src, size_t src_sz);
+
+
+/**
+ * Decompresses input compressed with msh_Compress.
+ *
+ * @param dest The destination buffer.
+ * @param dest_sz The size of the uncompressed data.
+ * @param src The compressed input.
+ * @param src_sz The size of the compressed input.
+ */
+void msh_Decompress(uint8_T* dest, size_t dest_sz, const uint8_T* src, size_t src_sz);
+
+
+
+/**
+ * Reads the files into the destination back to back using parallel positional reads.
+ *
+ * @param dest The destination buffer. Must be at least as large as the sum of the file sizes.
+ * @param file_handles The handles of the open files.
+ * @param file_sizes The number of bytes to read from each file.
+ * @param num_files The number of files.
+ * @param num_threads The number of threads to read with.
+ * @return Zero if successful, otherwise the system error code of the first failure.
+ */
+int msh_ReadFiles(void* dest, const handle_T* file_handles, const size_t* file_sizes, size_t num_files, size_t num_threads);
+
 #endif /* MATSHARE_MATSHAREUTILS_H */
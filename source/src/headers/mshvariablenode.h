@@ -90,6 +90,24 @@ mxArray* msh_GetVariableData(VariableNode_T* var_node);
 struct SegmentNode_T* msh_GetSegmentNode(VariableNode_T* var_node);
 
 
+/**
+ * Gets the next sub-variable node of the same segment.
+ *
+ * @param var_node The variable node.
+ * @return The next sub-variable node.
+ */
+VariableNode_T* msh_GetNextSubVariable(VariableNode_T* var_node);
+
+
+/**
+ * Gets the previous sub-variable node of the same segment.
+ *
+ * @param var_node The variable node.
+ * @return The previous sub-variable node.
+ */
+VariableNode_T* msh_GetPreviousSubVariable(VariableNode_T* var_node);
+
+
 int msh_GetIsUsed(VariableNode_T* var_node);
 
 
@@ -138,6 +156,24 @@ void msh_SetVariableData(VariableNode_T* var_node, mxArray* var);
 void msh_SetSegmentNode(VariableNode_T* var_node, struct SegmentNode_T* seg_node);
 
 
+/**
+ * Sets the next sub-variable node of the same segment.
+ *
+ * @param var_node The variable node.
+ * @param next_subvar_node The next sub-variable node.
+ */
+void msh_SetNextSubVariable(VariableNode_T* var_node, VariableNode_T* next_subvar_node);
+
+
+/**
+ * Sets the previous sub-variable node of the same segment.
+ *
+ * @param var_node The variable node.
+ * @param prev_subvar_node The previous sub-variable node.
+ */
+void msh_SetPreviousSubVariable(VariableNode_T* var_node, VariableNode_T* prev_subvar_node);
+
+
 void msh_SetIsUsed(VariableNode_T* var_node, int is_used);
 
 #endif /* MATSHARE_MSHVARIABLENODE_H */
@@ -14,12 +14,16 @@
 #include "mshtypes.h"
 #include "mshvariablenode.h"
 #include "mshtable.h"
+#include "mshheader.h"
 
+/* maximum number of variable nodes inspected by each incremental sweep */
+#define MSH_VARIABLE_SWEEP_SIZE 32
 typedef struct VariableList_T
 {
 	SegmentTable_T* mvar_table;
 	VariableNode_T* first;
 	VariableNode_T* last;
+	VariableNode_T* sweep_node;        /* the next node to be inspected by the incremental sweep */
 } VariableList_T;
 
 /**
@@ -31,6 +35,17 @@ typedef struct VariableList_T
 VariableNode_T* msh_CreateVariable(SegmentNode_T* seg_node);
 
 
+/**
+ * Creates a new MATLAB variable from a subtree of the specified shared segment. Only
+ * the subtree is materialized. The variable node is destroyed once it is no longer used.
+ *
+ * @param seg_node The segment node associated to the shared data.
+ * @param sub_header The header of the subtree inside the segment.
+ * @return A variable node containing the new MATLAB variable.
+ */
+VariableNode_T* msh_CreateSubVariable(SegmentNode_T* seg_node, SharedVariableHeader_T* sub_header);
+
+
 /**
  * Detaches and destroys the variable contained in the specified variable node.
  *
@@ -67,11 +82,15 @@ void msh_ClearVariableList(VariableList_T* var_list);
 
 /**
  * Does garbage collection on variables which have no crosslinks
- * into the MATLAB workspace.
+ * into the MATLAB workspace. The sweep resumes from where the
+ * previous sweep stopped, so that the cost of each call does not
+ * depend on the number of tracked variables.
  *
  * @param var_list The variable list to be cleaned.
+ * @param max_nodes The maximum number of nodes to inspect, or SIZE_MAX to sweep the entire list.
+ * @param shared_gc_override Whether to remove unused segments regardless of the shared GC setting.
  */
-void msh_CleanVariableList(VariableList_T* var_list, int shared_gc_override);
+void msh_CleanVariableList(VariableList_T* var_list, size_t max_nodes, int shared_gc_override);
 
 
 mxArray* msh_CreateSharedDataCopy(VariableNode_T* var_node, int will_set_used);
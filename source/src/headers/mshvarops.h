@@ -53,6 +53,7 @@
 
 #define MSH_IS_SYNCHRONOUS 0x0001
 #define MSH_USE_ATOMIC_OPS 0x0002
+#define MSH_RETURN_OLD_VALS 0x0004
 
 typedef enum
 {
@@ -66,7 +67,20 @@ typedef enum
 	VAROP_NEG = 0x0007,
 	VAROP_ARS = 0x0008,
 	VAROP_ALS = 0x0009,
-	VAROP_CPY = 0x000A
+	VAROP_CPY = 0x000A,
+	VAROP_MIN = 0x000B,
+	VAROP_MAX = 0x000C,
+	VAROP_AND = 0x000D,
+	VAROP_OR  = 0x000E,
+	VAROP_XOR = 0x000F,
+	VAROP_AXPY  = 0x0010,             /* accum + a*x */
+	VAROP_FMA   = 0x0011,             /* accum*a + b */
+	VAROP_CLAMP = 0x0012,             /* min(max(accum, lower), upper) */
+	VAROP_SUM    = 0x0013,            /* read-only reductions */
+	VAROP_MINVAL = 0x0014,
+	VAROP_MAXVAL = 0x0015,
+	VAROP_ANY    = 0x0016,
+	VAROP_NNZ    = 0x0017
 } msh_varop_T;
 
 typedef struct WideInput_T
@@ -96,6 +110,7 @@ typedef struct WideInput_T
 
 typedef void (*unaryvaropfcn_T)(WideInput_T*,long);
 typedef void (*binaryvaropfcn_T)(WideInput_T*,WideInput_T*,long);
+typedef void (*ternaryvaropfcn_T)(WideInput_T*,WideInput_T*,WideInput_T*,long);
 
 typedef struct ParsedIndices_T
 {
@@ -133,8 +148,29 @@ void msh_CompareVariableSize(IndexedVariable_T* indexed_var, const mxArray* in_v
 
 int msh_GetNumVarOpArgs(msh_varop_T varop);
 
-void msh_UnaryVariableOperation(IndexedVariable_T* indexed_var, msh_varop_T varop, long opts, mxArray** output);
-void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray* in_var, msh_varop_T varop, long opts, mxArray** output);
+
+/**
+ * Checks whether the variable operation only reads the variable.
+ *
+ * @param varop The variable operation.
+ * @return Whether the operation is a reduction.
+ */
+int msh_IsReadOnlyVarOp(msh_varop_T varop);
+
+void msh_UnaryVariableOperation(IndexedVariable_T* indexed_var, msh_varop_T varop, long opts);
+void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray* in_var, msh_varop_T varop, long opts);
+void msh_TernaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray* in_var1, const mxArray* in_var2, msh_varop_T varop, long opts);
+
+
+/**
+ * Reduces the indexed variable to a scalar without modifying it. Sums are
+ * returned as doubles, and the minimum and maximum in the class of the variable.
+ *
+ * @param indexed_var The indexed variable.
+ * @param varop The reduction.
+ * @param output Set to the result.
+ */
+void msh_ReduceVariable(IndexedVariable_T* indexed_var, msh_varop_T varop, mxArray** output);
 
 void msh_VariableOperation(const mxArray* parent_var, const mxArray* subs_struct, const mxArray* in_vars, size_t num_in_vars, msh_varop_T varop, long opts, FileLock_T filelock, mxArray** output);
 
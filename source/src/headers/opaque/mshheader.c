@@ -16,6 +16,7 @@
 #include "mshvariables.h"
 #include "mlerrorutils.h"
 #include "mshexterntypes.h"
+#include "mshutils.h"
 
 
 #ifdef MSH_UNIX
@@ -52,6 +53,9 @@ typedef struct AllocationHeader_T
 #  error(matshare is only supported in 64-bit and 32-bit variants.)
 #endif
 
+/* the granularity of delta overwrites; one page so that unchanged pages are never dirtied */
+#define MSH_DELTA_BLOCK_SIZE 0x1000
+
 
 /**
  * Close emulation of the structure of mxArray:
@@ -131,6 +135,79 @@ static void msh_MakeAllocationHeader(AllocationHeader_T* alloc_hdr, size_t copy_
 static size_t msh_FindPaddedDataSize(size_t copy_sz);
 
 
+/**
+ * Gets the element size of a class which may be stored as a base case.
+ *
+ * @param class_id The class ID.
+ * @return The size of each element, or 0 if the class is not numeric, logical, or char.
+ */
+static size_t msh_GetClassElementSize(mxClassID class_id);
+
+
+/**
+ * Counts the elements of a variable with the given dimensions, and checks
+ * that the size of its data can be stored in a size_t with room to spare
+ * for a complex part and the alignment padding.
+ *
+ * @param num_dims The number of dimensions.
+ * @param dims The dimensions.
+ * @param elem_size The size of each element.
+ * @return The number of elements.
+ */
+static size_t msh_CountCheckedElements(size_t num_dims, const mwSize* dims, size_t elem_size);
+
+
+/**
+ * Checks that the input variable may be shared as column blocks.
+ *
+ * @param in_var The input variable.
+ * @param num_blocks The number of column blocks.
+ */
+static void msh_CheckBlockedVariable(const mxArray* in_var, size_t num_blocks);
+
+
+/**
+ * Gets the number of columns in the specified block. Leading blocks take the remainder.
+ *
+ * @param num_cols The total number of columns.
+ * @param num_blocks The number of blocks.
+ * @param blk_num The block number.
+ * @return The number of columns in the block.
+ */
+static size_t msh_GetBlockNumColumns(size_t num_cols, size_t num_blocks, size_t blk_num);
+
+
+/**
+ * Converts a cell of scalar subscripts into a linear index into the shared variable.
+ *
+ * @param shared_header The shared variable header.
+ * @param subs The cell of subscripts from a subscript struct.
+ * @return The zero-based linear index.
+ */
+static size_t msh_GetSubscriptedIndex(SharedVariableHeader_T* shared_header, const mxArray* subs);
+
+
+/**
+ * Recursively compares the leaf data of a shared variable and an input variable with the same size.
+ *
+ * @param shared_header The shared variable header.
+ * @param comp_var The input comparison variable.
+ * @return Whether the leaf data is the same.
+ */
+static int msh_CompareLeafContent(SharedVariableHeader_T* shared_header, const mxArray* comp_var);
+
+
+/**
+ * Copies only the blocks of the source which differ from the destination.
+ *
+ * @param dest The destination.
+ * @param src The source.
+ * @param size The size of the data.
+ * @return The number of blocks copied.
+ */
+static size_t msh_CopyChangedBlocks(byte_T* dest, const byte_T* src, size_t size);
+
+
 /** offset Get functions **/
 
 size_t msh_GetDataOffset(SharedVariableHeader_T* hdr_ptr)
@@ -374,6 +451,30 @@ SharedVariableHeader_T* msh_GetChildHeader(SharedVariableHeader_T* hdr_ptr, size
 }
 
 
+SharedVariableHeader_T* msh_GetFieldHeader(SharedVariableHeader_T* hdr_ptr, const char_T* field_name)
+{
+	int field_num, num_fields;
+	const char_T* curr_field_name;
+	
+	if(msh_GetClassID(hdr_ptr) != mxSTRUCT_CLASS || msh_GetNumElems(hdr_ptr) != 1)
+	{
+		return NULL;
+	}
+	
+	num_fields = msh_GetNumFields(hdr_ptr);
+	curr_field_name = msh_GetFieldNames(hdr_ptr);
+	for(field_num = 0; field_num < num_fields; field_num++, msh_GetNextFieldName(&curr_field_name))
+	{
+		if(strcmp(curr_field_name, field_name) == 0)
+		{
+			return msh_GetChildHeader(hdr_ptr, (size_t)field_num);
+		}
+	}
+	
+	return NULL;
+}
+
+
 int msh_GetIsComplex(SharedVariableHeader_T* hdr_ptr)
 {
 	return hdr_ptr->data_offsets.imag_data != SIZE_MAX;
@@ -731,6 +832,251 @@ size_t msh_CopyVariable(void* dest, const mxArray* in_var)
 }
 
 
+size_t msh_FindBlockedSharedSize(const mxArray* in_var, size_t num_blocks)
+{
+	size_t blk_num, obj_tree_sz;
+	mwSize blk_dims[2];
+	
+	msh_CheckBlockedVariable(in_var, num_blocks);
+	
+	/* the cell header, dimensions, and child offsets */
+	obj_tree_sz = msh_PadToAlignData(sizeof(SharedVariableHeader_T) + 2*sizeof(mwSize) + num_blocks*sizeof(size_t));
+	
+	blk_dims[0] = mxGetM(in_var);
+	for(blk_num = 0; blk_num < num_blocks; blk_num++)
+	{
+		blk_dims[1] = msh_GetBlockNumColumns(mxGetN(in_var), num_blocks, blk_num);
+		obj_tree_sz += msh_PadToAlignData(msh_FindAllocatedSize(mxGetClassID(in_var), 2, blk_dims, mxIsComplex(in_var)));
+	}
+	
+	return obj_tree_sz;
+}
+
+
+size_t msh_CopyVariableBlocked(void* dest, const mxArray* in_var, size_t num_blocks)
+{
+	size_t curr_off, blk_num, col_start, col_off, copy_sz;
+	mwSize blk_dims[2];
+	
+	size_t elem_sz = mxGetElementSize(in_var);
+	
+	msh_CheckBlockedVariable(in_var, num_blocks);
+	
+	/* lay out a 1-by-num_blocks cell */
+	msh_SetDataOffset(dest, SIZE_MAX);
+	msh_SetImagDataOffset(dest, SIZE_MAX);
+	msh_SetIrOffset(dest, SIZE_MAX);
+	msh_SetJcOffset(dest, SIZE_MAX);
+	
+	msh_SetNumDims(dest, 2);
+	msh_SetElemSize(dest, sizeof(mxArray*));
+	msh_SetNumElems(dest, num_blocks);
+	msh_SetNumFields(dest, 0);
+	msh_SetClassId(dest, mxCELL_CLASS);
+	msh_SetIsEmpty(dest, FALSE);
+	msh_SetIsSparse(dest, FALSE);
+	msh_SetIsNumeric(dest, FALSE);
+	
+	curr_off = sizeof(SharedVariableHeader_T);
+	
+	msh_GetDimensions(dest)[0] = 1;
+	msh_GetDimensions(dest)[1] = num_blocks;
+	curr_off += 2*sizeof(mwSize);
+	
+	msh_SetChildOffsOffset(dest, curr_off);
+	curr_off += num_blocks*sizeof(size_t);
+	
+	curr_off = msh_PadToAlignData(curr_off);
+	
+	/* each block is a full matrix with its own allocation headers */
+	blk_dims[0] = mxGetM(in_var);
+	for(blk_num = 0, col_start = 0; blk_num < num_blocks; blk_num++, col_start += blk_dims[1])
+	{
+		blk_dims[1] = msh_GetBlockNumColumns(mxGetN(in_var), num_blocks, blk_num);
+		
+		msh_GetChildOffsets(dest)[blk_num] = curr_off;
+		curr_off += msh_PadToAlignData(msh_AllocateVariable(msh_GetChildHeader(dest, blk_num), mxGetClassID(in_var), 2, blk_dims, mxIsComplex(in_var)));
+		
+		/* columns are contiguous, so each block is a single copy */
+		col_off = col_start*blk_dims[0]*elem_sz;
+		copy_sz = blk_dims[0]*blk_dims[1]*elem_sz;
+		memcpy(msh_GetData(msh_GetChildHeader(dest, blk_num)), (char*)mxGetData(in_var) + col_off, copy_sz);
+		if(mxIsComplex(in_var))
+		{
+			memcpy(msh_GetImagData(msh_GetChildHeader(dest, blk_num)), (char*)mxGetImagData(in_var) + col_off, copy_sz);
+		}
+	}
+	
+	return curr_off;
+}
+
+
+size_t msh_FindAllocatedSize(mxClassID class_id, size_t num_dims, const mwSize* dims, int is_complex)
+{
+	size_t num_elems, elem_size, data_sz, obj_tree_sz = 0;
+
+	if(num_dims < 2)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "UndefinedDimensionsError", "There was an unexpected number of dimensions. Make sure the array has at least two dimensions.");
+	}
+
+	if((elem_size = msh_GetClassElementSize(class_id)) == 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidTypeError", "Unexpected class. Allocated variables must be of type 'numeric', 'logical', or 'char'.");
+	}
+
+	if(is_complex && (class_id == mxLOGICAL_CLASS || class_id == mxCHAR_CLASS))
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidComplexityError", "Only numeric variables may be allocated as complex.");
+	}
+
+	/* Add space for the header and dimensions */
+	obj_tree_sz += sizeof(SharedVariableHeader_T) + num_dims*sizeof(mwSize);
+
+	num_elems = msh_CountCheckedElements(num_dims, dims, elem_size);
+
+	if(num_elems > 0)
+	{
+		/* scalars are given extra room in the same fashion as msh_FindSharedSize */
+		data_sz = elem_size*((num_elems == 1)? 2 : num_elems);
+		msh_AddAlignedDataSize(obj_tree_sz, data_sz);
+		if(is_complex)
+		{
+			msh_AddAlignedDataSize(obj_tree_sz, data_sz);
+		}
+	}
+
+	return obj_tree_sz;
+}
+
+
+size_t msh_AllocateVariable(void* dest, mxClassID class_id, size_t num_dims, const mwSize* dims, int is_complex)
+{
+	size_t i, num_elems, alloc_sz, curr_off = 0;
+
+	for(i = 0, num_elems = 1; i < num_dims; i++)
+	{
+		num_elems *= dims[i];
+	}
+
+	/* initialize header info */
+	msh_SetDataOffset(dest, SIZE_MAX);
+	msh_SetImagDataOffset(dest, SIZE_MAX);
+	msh_SetIrOffset(dest, SIZE_MAX);
+	msh_SetJcOffset(dest, SIZE_MAX);
+
+	msh_SetNumDims(dest, num_dims);
+	msh_SetElemSize(dest, msh_GetClassElementSize(class_id));
+	msh_SetNumElems(dest, num_elems);
+	msh_SetNumFields(dest, 0);
+	msh_SetClassId(dest, class_id);
+	msh_SetIsEmpty(dest, num_elems == 0);
+	msh_SetIsSparse(dest, FALSE);
+	msh_SetIsNumeric(dest, class_id != mxLOGICAL_CLASS && class_id != mxCHAR_CLASS);
+
+	/* shift to beginning of dims */
+	curr_off += sizeof(SharedVariableHeader_T);
+
+	/* copy the dimensions */
+	memcpy(msh_GetDimensions(dest), dims, num_dims*sizeof(mwSize));
+
+	/* shift to end of dims */
+	curr_off += num_dims*sizeof(mwSize);
+
+	/* the segment is zeroed on creation, so only the signatures need to be written */
+	if(num_elems > 0)
+	{
+		alloc_sz = num_elems*msh_GetElemSize(dest);
+
+		/* make room for the mxMalloc signature */
+		curr_off = msh_PadToAlignData(curr_off + ALLOCATION_HEADER_SIZE);
+		msh_SetDataOffset(dest, curr_off);
+		msh_MakeAllocationHeader((AllocationHeader_T*)msh_GetData(dest) - 1, alloc_sz);
+		curr_off += msh_PadToAlignData(alloc_sz);
+
+		if(is_complex)
+		{
+			curr_off = msh_PadToAlignData(curr_off + ALLOCATION_HEADER_SIZE);
+			msh_SetImagDataOffset(dest, curr_off);
+			msh_MakeAllocationHeader((AllocationHeader_T*)msh_GetImagData(dest) - 1, alloc_sz);
+			curr_off += msh_PadToAlignData(alloc_sz);
+		}
+	}
+
+	return curr_off;
+}
+
+
+size_t msh_FindMappedDataSize(mxClassID class_id, size_t num_dims, const mwSize* dims)
+{
+	size_t num_elems, elem_size;
+	
+	if(num_dims < 2)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "UndefinedDimensionsError", "There was an unexpected number of dimensions. Make sure the array has at least two dimensions.");
+	}
+	
+	if((elem_size = msh_GetClassElementSize(class_id)) == 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidTypeError", "Unexpected class. Variables read from files must be of type 'numeric', 'logical', or 'char'.");
+	}
+	
+	num_elems = msh_CountCheckedElements(num_dims, dims, elem_size);
+	
+	if(num_elems == 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "EmptyMappingError", "Variables read from files must not be empty.");
+	}
+	
+	return num_elems*elem_size;
+}
+
+
+size_t msh_FindMappedHeaderSize(size_t num_dims, const char_T* file_path)
+{
+	return sizeof(SharedVariableHeader_T) + num_dims*sizeof(mwSize) + strlen(file_path) + 1 + ALLOCATION_HEADER_SIZE;
+}
+
+
+size_t msh_MapVariable(void* dest, mxClassID class_id, size_t num_dims, const mwSize* dims, const char_T* file_path, size_t data_offset)
+{
+	size_t i, num_elems, path_off;
+	
+	for(i = 0, num_elems = 1; i < num_dims; i++)
+	{
+		num_elems *= dims[i];
+	}
+	
+	/* initialize header info */
+	msh_SetDataOffset(dest, SIZE_MAX);
+	msh_SetImagDataOffset(dest, SIZE_MAX);
+	msh_SetIrOffset(dest, SIZE_MAX);
+	msh_SetJcOffset(dest, SIZE_MAX);
+	
+	msh_SetNumDims(dest, num_dims);
+	msh_SetElemSize(dest, msh_GetClassElementSize(class_id));
+	msh_SetNumElems(dest, num_elems);
+	msh_SetNumFields(dest, 0);
+	msh_SetClassId(dest, class_id);
+	msh_SetIsEmpty(dest, FALSE);
+	msh_SetIsSparse(dest, FALSE);
+	msh_SetIsNumeric(dest, class_id != mxLOGICAL_CLASS && class_id != mxCHAR_CLASS);
+	
+	/* copy the dimensions */
+	memcpy(msh_GetDimensions(dest), dims, num_dims*sizeof(mwSize));
+	
+	/* the file path goes after the dimensions */
+	path_off = sizeof(SharedVariableHeader_T) + num_dims*sizeof(mwSize);
+	strcpy((char_T*)dest + path_off, file_path);
+	
+	/* the data lies outside of the segment, but the mxMalloc signature is still directly before it */
+	msh_SetDataOffset(dest, data_offset);
+	msh_MakeAllocationHeader((AllocationHeader_T*)msh_GetData(dest) - 1, num_elems*msh_GetElemSize(dest));
+	
+	return path_off;
+}
+
+
 mxArray* msh_FetchVariable(SharedVariableHeader_T* shared_header)
 {
 	mxArray* ret_var = NULL;
@@ -867,6 +1213,108 @@ mxArray* msh_FetchVariable(SharedVariableHeader_T* shared_header)
 }
 
 
+SharedVariableHeader_T* msh_GetSubscriptedHeader(SharedVariableHeader_T* shared_header, const mxArray* subs_struct)
+{
+	size_t         i, num_levels, elem_idx = 0;
+	int            field_num, num_fields;
+	const mxArray* type;
+	const mxArray* subs;
+	const char_T*  field_name;
+	char_T         field_str[MSH_NAME_LEN_MAX];
+	
+	int            has_elem_idx = FALSE;
+	
+	if(!mxIsStruct(subs_struct) || mxGetFieldNumber(subs_struct, "type") < 0 || mxGetFieldNumber(subs_struct, "subs") < 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Subscripts must be specified with a struct in the style of that returned by substruct.");
+	}
+	
+	for(i = 0, num_levels = mxGetNumberOfElements(subs_struct); i < num_levels; i++)
+	{
+		type = mxGetField(subs_struct, i, "type");
+		subs = mxGetField(subs_struct, i, "subs");
+		if(type == NULL || subs == NULL || !mxIsChar(type) || mxIsEmpty(type))
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Invalid subscript struct.");
+		}
+		
+		switch(mxGetChars(type)[0])
+		{
+			case('('):
+			{
+				/* only used to select a struct element for a following field reference */
+				if(msh_GetClassID(shared_header) != mxSTRUCT_CLASS || has_elem_idx)
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Parenthesis indexing is only supported for selecting a single struct element before a field reference.");
+				}
+				elem_idx = msh_GetSubscriptedIndex(shared_header, subs);
+				has_elem_idx = TRUE;
+				break;
+			}
+			case('{'):
+			{
+				if(msh_GetClassID(shared_header) != mxCELL_CLASS || has_elem_idx)
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Brace indexing is only supported for cells.");
+				}
+				shared_header = msh_GetChildHeader(shared_header, msh_GetSubscriptedIndex(shared_header, subs));
+				break;
+			}
+			case('.'):
+			{
+				if(msh_GetClassID(shared_header) != mxSTRUCT_CLASS)
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Field references are only supported for structs.");
+				}
+				
+				if(!has_elem_idx)
+				{
+					if(msh_GetNumElems(shared_header) != 1)
+					{
+						meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Field references into non-scalar structs must select a single element first.");
+					}
+					elem_idx = 0;
+				}
+				
+				if(!mxIsChar(subs) || mxGetString(subs, field_str, sizeof(field_str)) != 0)
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Invalid field name.");
+				}
+				
+				num_fields = msh_GetNumFields(shared_header);
+				field_name = msh_GetFieldNames(shared_header);
+				for(field_num = 0; field_num < num_fields && strcmp(field_name, field_str) != 0; field_num++)
+				{
+					msh_GetNextFieldName(&field_name);
+				}
+				
+				if(field_num == num_fields)
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Reference to non-existent field '%s'.", field_str);
+				}
+				
+				/* children are stored field by field */
+				shared_header = msh_GetChildHeader(shared_header, field_num*msh_GetNumElems(shared_header) + elem_idx);
+				has_elem_idx = FALSE;
+				break;
+			}
+			default:
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Invalid subscript type.");
+			}
+		}
+	}
+	
+	if(has_elem_idx)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Parenthesis indexing must be followed by a field reference.");
+	}
+	
+	return shared_header;
+	
+}
+
+
 void msh_OverwriteHeader(SharedVariableHeader_T* shared_header, const mxArray* in_var)
 {
 	size_t idx, count, num_elems, nzmax;
@@ -943,6 +1391,75 @@ void msh_OverwriteHeader(SharedVariableHeader_T* shared_header, const mxArray* i
 }
 
 
+size_t msh_OverwriteHeaderDelta(SharedVariableHeader_T* shared_header, const mxArray* in_var)
+{
+	size_t idx, count, num_elems, nzmax, num_changed = 0;
+	
+	/* for structures */
+	int field_num, num_fields;                /* current field */
+	
+	mxClassID class_id = (mxClassID)msh_GetClassID(shared_header);
+	
+	/* Structure case */
+	if(class_id == mxSTRUCT_CLASS)
+	{
+		num_elems = msh_GetNumElems(shared_header);
+		num_fields = msh_GetNumFields(shared_header);
+		
+		for(field_num = 0, count = 0; field_num < num_fields; field_num++)
+		{
+			for(idx = 0; idx < num_elems; idx++, count++)
+			{
+				num_changed += msh_OverwriteHeaderDelta(msh_GetChildHeader(shared_header, count), mxGetFieldByNumber(in_var, idx, field_num));
+			}
+		}
+	}
+	else if(class_id == mxCELL_CLASS) /* Cell case */
+	{
+		num_elems = msh_GetNumElems(shared_header);
+		
+		for(count = 0; count < num_elems; count++)
+		{
+			num_changed += msh_OverwriteHeaderDelta(msh_GetChildHeader(shared_header, count), mxGetCell(in_var, count));
+		}
+	}
+	else     /*base case*/
+	{
+		
+		if(msh_GetIsSparse(shared_header))
+		{
+			
+			nzmax = msh_GetNzmax(shared_header);
+			
+			num_changed += msh_CopyChangedBlocks((byte_T*)msh_GetIr(shared_header), (byte_T*)mxGetIr(in_var), nzmax*sizeof(mwIndex));
+			num_changed += msh_CopyChangedBlocks((byte_T*)msh_GetJc(shared_header), (byte_T*)mxGetJc(in_var), (mxGetN(in_var) + 1)*sizeof(mwIndex));
+			num_changed += msh_CopyChangedBlocks(msh_GetData(shared_header), mxGetData(in_var), nzmax*msh_GetElemSize(shared_header));
+			
+			if(msh_GetIsComplex(shared_header))
+			{
+				num_changed += msh_CopyChangedBlocks(msh_GetImagData(shared_header), mxGetImagData(in_var), nzmax*msh_GetElemSize(shared_header));
+			}
+		}
+		else if(!msh_GetIsEmpty(shared_header))
+		{
+			
+			num_elems = msh_GetNumElems(shared_header);
+			
+			num_changed += msh_CopyChangedBlocks(msh_GetData(shared_header), mxGetData(in_var), num_elems*msh_GetElemSize(shared_header));
+			
+			if(msh_GetIsComplex(shared_header))
+			{
+				num_changed += msh_CopyChangedBlocks(msh_GetImagData(shared_header), mxGetImagData(in_var), num_elems*msh_GetElemSize(shared_header));
+			}
+		}
+		
+	}
+	
+	return num_changed;
+	
+}
+
+
 int msh_CompareHeaderSize(SharedVariableHeader_T* shared_header, const mxArray* comp_var)
 {
 	
@@ -1044,6 +1561,78 @@ int msh_CompareHeaderSize(SharedVariableHeader_T* shared_header, const mxArray*
 }
 
 
+uint32_T msh_HashVariableContent(const mxArray* in_var, uint32_T seed)
+{
+	size_t idx, num_elems, data_sz;
+	int field_num, num_fields;
+	const char_T* field_name;
+	
+	mxClassID class_id = mxGetClassID(in_var);
+	
+	/* hash the shape first so that differently shaped variables with the same data differ */
+	seed = msh_MurmurHash3((const uint8_T*)&class_id, sizeof(mxClassID), (int)seed);
+	seed = msh_MurmurHash3((const uint8_T*)mxGetDimensions(in_var), mxGetNumberOfDimensions(in_var)*sizeof(mwSize), (int)seed);
+	
+	if(class_id == mxSTRUCT_CLASS)
+	{
+		num_elems = mxGetNumberOfElements(in_var);
+		num_fields = mxGetNumberOfFields(in_var);
+		for(field_num = 0; field_num < num_fields; field_num++)
+		{
+			field_name = mxGetFieldNameByNumber(in_var, field_num);
+			seed = msh_MurmurHash3((const uint8_T*)field_name, strlen(field_name), (int)seed);
+			for(idx = 0; idx < num_elems; idx++)
+			{
+				seed = msh_HashVariableContent(mxGetFieldByNumber(in_var, idx, field_num), seed);
+			}
+		}
+	}
+	else if(class_id == mxCELL_CLASS)
+	{
+		num_elems = mxGetNumberOfElements(in_var);
+		for(idx = 0; idx < num_elems; idx++)
+		{
+			seed = msh_HashVariableContent(mxGetCell(in_var, idx), seed);
+		}
+	}
+	else if(mxIsNumeric(in_var) || class_id == mxLOGICAL_CLASS || class_id == mxCHAR_CLASS)
+	{
+		if(mxIsSparse(in_var))
+		{
+			data_sz = mxGetNzmax(in_var)*mxGetElementSize(in_var);
+			seed = msh_MurmurHash3((const uint8_T*)mxGetIr(in_var), mxGetNzmax(in_var)*sizeof(mwIndex), (int)seed);
+			seed = msh_MurmurHash3((const uint8_T*)mxGetJc(in_var), (mxGetN(in_var) + 1)*sizeof(mwIndex), (int)seed);
+		}
+		else
+		{
+			data_sz = mxGetNumberOfElements(in_var)*mxGetElementSize(in_var);
+		}
+		
+		if(!mxIsEmpty(in_var))
+		{
+			seed = msh_MurmurHash3((const uint8_T*)mxGetData(in_var), data_sz, (int)seed);
+			if(mxIsComplex(in_var))
+			{
+				seed = msh_MurmurHash3((const uint8_T*)mxGetImagData(in_var), data_sz, (int)seed);
+			}
+		}
+	}
+	else
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidTypeError",
+		                  "Unexpected input type '%s'. All elements of the shared variable must be of type 'numeric', 'logical', 'char', 'struct', or 'cell'.", mxGetClassName(in_var));
+	}
+	
+	return seed;
+}
+
+
+int msh_CompareVariableContent(SharedVariableHeader_T* shared_header, const mxArray* comp_var)
+{
+	return msh_CompareHeaderSize(shared_header, comp_var) && msh_CompareLeafContent(shared_header, comp_var);
+}
+
+
 void msh_DetachVariable(mxArray* ret_var)
 {
 	mxArray* link;
@@ -1135,14 +1724,42 @@ void msh_DetachVariable(mxArray* ret_var)
 
 SharedVariableHeader_T* msh_GetSegmentData(SegmentNode_T* seg_node)
 {
+	byte_T*        cache_ptr;
+	SegmentInfo_T* seg_info = msh_GetSegmentInfo(seg_node);
+	
+	if(seg_info->cache_ptr != NULL)
+	{
+		return seg_info->cache_ptr;
+	}
+	
+	if(seg_info->metadata->is_compressed)
+	{
+		/* decompress into a private cache on first use; this is never written back */
+		seg_info->cache_alloc = mxMalloc(seg_info->metadata->uncompressed_size + MSH_ALIGNMENT);
+		mexMakeMemoryPersistent(seg_info->cache_alloc);
+		cache_ptr = (byte_T*)seg_info->cache_alloc + (MSH_ALIGNMENT - (size_t)seg_info->cache_alloc%MSH_ALIGNMENT)%MSH_ALIGNMENT;
+		msh_Decompress(cache_ptr, seg_info->metadata->uncompressed_size, msh_GetSegmentRawData(seg_node), seg_info->metadata->data_size);
+		seg_info->cache_ptr = cache_ptr;
+		return seg_info->cache_ptr;
+	}
+	
+	return msh_GetSegmentRawData(seg_node);
+}
+
+
+void* msh_GetSegmentRawData(SegmentNode_T* seg_node)
+{
+	SegmentInfo_T* seg_info = msh_GetSegmentInfo(seg_node);
+	
 	/* The raw pointer is only mapped if it is actually needed.
 	 * This improves performance of functions only needing the
 	 * metadata without effecting performance of other functions. */
-	if(msh_GetSegmentInfo(seg_node)->raw_ptr == NULL)
+	if(seg_info->raw_ptr == NULL)
 	{
-		msh_GetSegmentInfo(seg_node)->raw_ptr = msh_MapMemory(msh_GetSegmentInfo(seg_node)->handle, msh_GetSegmentInfo(seg_node)->total_segment_size);
+		seg_info->raw_ptr = msh_MapSegmentMemory(seg_info);
 	}
-	return (SharedVariableHeader_T*)((byte_T*)msh_GetSegmentInfo(seg_node)->raw_ptr + msh_PadToAlignData(sizeof(SegmentMetadata_T)));
+	
+	return (byte_T*)seg_info->raw_ptr + msh_PadToAlignData(sizeof(SegmentMetadata_T));
 }
 
 
@@ -1197,3 +1814,213 @@ static size_t msh_FindPaddedDataSize(size_t copy_sz)
 {
 	return copy_sz + ((ALLOCATION_HEADER_SIZE-1) - ((copy_sz - 1) & (ALLOCATION_HEADER_SIZE-1)));
 }
+
+
+static size_t msh_CopyChangedBlocks(byte_T* dest, const byte_T* src, size_t size)
+{
+	size_t offset, block_size, num_changed = 0;
+	
+	/* memcmp is vectorized by the C library and returns at the first difference */
+	for(offset = 0; offset < size; offset += block_size)
+	{
+		block_size = MIN(MSH_DELTA_BLOCK_SIZE, size - offset);
+		if(memcmp(dest + offset, src + offset, block_size) != 0)
+		{
+			memcpy(dest + offset, src + offset, block_size);
+			num_changed += 1;
+		}
+	}
+	
+	return num_changed;
+}
+
+
+static size_t msh_GetClassElementSize(mxClassID class_id)
+{
+	switch(class_id)
+	{
+		case(mxINT8_CLASS):
+		case(mxUINT8_CLASS):   return sizeof(int8_T);
+		case(mxINT16_CLASS):
+		case(mxUINT16_CLASS):  return sizeof(int16_T);
+		case(mxINT32_CLASS):
+		case(mxUINT32_CLASS):  return sizeof(int32_T);
+		case(mxINT64_CLASS):
+		case(mxUINT64_CLASS):  return sizeof(int64_T);
+		case(mxSINGLE_CLASS):  return sizeof(single);
+		case(mxDOUBLE_CLASS):  return sizeof(double);
+		case(mxLOGICAL_CLASS): return sizeof(mxLogical);
+		case(mxCHAR_CLASS):    return sizeof(mxChar);
+		default:               return 0;
+	}
+}
+
+
+static size_t msh_CountCheckedElements(size_t num_dims, const mwSize* dims, size_t elem_size)
+{
+	size_t i, num_elems;
+	
+	for(i = 0; i < num_dims; i++)
+	{
+		if(dims[i] == 0)
+		{
+			return 0;
+		}
+	}
+	
+	for(i = 0, num_elems = 1; i < num_dims; i++)
+	{
+		if(num_elems > SIZE_MAX/dims[i])
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "DimensionsTooLargeError", "The number of elements is too large to be stored.");
+		}
+		num_elems *= dims[i];
+	}
+	
+	/* a quarter leaves room for the complex part and the padding */
+	if(num_elems > SIZE_MAX/4/elem_size)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "DimensionsTooLargeError", "The size of the data is too large to be stored.");
+	}
+	
+	return num_elems;
+}
+
+
+static size_t msh_GetSubscriptedIndex(SharedVariableHeader_T* shared_header, const mxArray* subs)
+{
+	size_t         i, j, num_subs, dim_len, stride, lin_idx;
+	double         sub_val;
+	const mxArray* curr_sub;
+	
+	size_t         num_dims = msh_GetNumDims(shared_header);
+	mwSize*        dims     = msh_GetDimensions(shared_header);
+	
+	if(!mxIsCell(subs) || (num_subs = mxGetNumberOfElements(subs)) < 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Invalid subscript struct.");
+	}
+	
+	for(i = 0, stride = 1, lin_idx = 0; i < num_subs; i++)
+	{
+		curr_sub = mxGetCell(subs, i);
+		if(curr_sub == NULL || !mxIsNumeric(curr_sub) || mxIsComplex(curr_sub) || mxGetNumberOfElements(curr_sub) != 1)
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidSubscriptError", "Subscripts must be real numeric scalars.");
+		}
+		
+		sub_val = mxGetScalar(curr_sub);
+		
+		/* the last subscript spans all of the remaining dimensions */
+		if(i + 1 < num_subs)
+		{
+			dim_len = (i < num_dims)? dims[i] : 1;
+		}
+		else
+		{
+			for(j = i, dim_len = 1; j < num_dims; j++)
+			{
+				dim_len *= dims[j];
+			}
+		}
+		
+		if(!(sub_val >= 1) || sub_val > (double)dim_len || sub_val != (double)(size_t)sub_val)
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "IndexOutOfBoundsError", "Index exceeds matrix dimensions.");
+		}
+		
+		lin_idx += ((size_t)sub_val - 1)*stride;
+		stride *= dim_len;
+	}
+	
+	return lin_idx;
+	
+}
+
+
+static void msh_CheckBlockedVariable(const mxArray* in_var, size_t num_blocks)
+{
+	if(!(mxIsNumeric(in_var) || mxIsLogical(in_var) || mxIsChar(in_var)) || mxIsSparse(in_var) || mxGetNumberOfDimensions(in_var) != 2)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "BlockLayoutError", "Only full two dimensional numeric, logical, or char matrices may be shared as column blocks.");
+	}
+	
+	if(num_blocks < 1 || num_blocks > mxGetN(in_var))
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "BlockLayoutError", "The number of blocks must be between 1 and the number of columns.");
+	}
+}
+
+
+static size_t msh_GetBlockNumColumns(size_t num_cols, size_t num_blocks, size_t blk_num)
+{
+	return num_cols/num_blocks + (blk_num < num_cols%num_blocks);
+}
+
+
+static int msh_CompareLeafContent(SharedVariableHeader_T* shared_header, const mxArray* comp_var)
+{
+	size_t idx, count, num_elems, data_sz;
+	int field_num, num_fields;
+	
+	mxClassID class_id = (mxClassID)msh_GetClassID(shared_header);
+	
+	if(class_id == mxSTRUCT_CLASS)
+	{
+		num_elems = msh_GetNumElems(shared_header);
+		num_fields = msh_GetNumFields(shared_header);
+		for(field_num = 0, count = 0; field_num < num_fields; field_num++)
+		{
+			for(idx = 0; idx < num_elems; idx++, count++)
+			{
+				if(!msh_CompareLeafContent(msh_GetChildHeader(shared_header, count), mxGetFieldByNumber(comp_var, idx, field_num)))
+				{
+					return FALSE;
+				}
+			}
+		}
+	}
+	else if(class_id == mxCELL_CLASS)
+	{
+		num_elems = msh_GetNumElems(shared_header);
+		for(count = 0; count < num_elems; count++)
+		{
+			if(!msh_CompareLeafContent(msh_GetChildHeader(shared_header, count), mxGetCell(comp_var, count)))
+			{
+				return FALSE;
+			}
+		}
+	}
+	else
+	{
+		if(msh_GetIsSparse(shared_header))
+		{
+			data_sz = msh_GetNzmax(shared_header)*msh_GetElemSize(shared_header);
+			if(memcmp(msh_GetIr(shared_header), mxGetIr(comp_var), msh_GetNzmax(shared_header)*sizeof(mwIndex)) != 0
+			   || memcmp(msh_GetJc(shared_header), mxGetJc(comp_var), (mxGetN(comp_var) + 1)*sizeof(mwIndex)) != 0)
+			{
+				return FALSE;
+			}
+		}
+		else if(msh_GetIsEmpty(shared_header))
+		{
+			return TRUE;
+		}
+		else
+		{
+			data_sz = msh_GetNumElems(shared_header)*msh_GetElemSize(shared_header);
+		}
+		
+		if(memcmp(msh_GetData(shared_header), mxGetData(comp_var), data_sz) != 0)
+		{
+			return FALSE;
+		}
+		
+		if(msh_GetIsComplex(shared_header) && memcmp(msh_GetImagData(shared_header), mxGetImagData(comp_var), data_sz) != 0)
+		{
+			return FALSE;
+		}
+	}
+	
+	return TRUE;
+}
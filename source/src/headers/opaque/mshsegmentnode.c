@@ -12,6 +12,7 @@
 
 #include "mshsegmentnode.h"
 #include "mshvariablenode.h"
+#include "mshpool.h"
 
 struct SegmentNode_T
 {
@@ -19,17 +20,23 @@ struct SegmentNode_T
 	SegmentNode_T* next;
 	SegmentNode_T* prev;
 	VariableNode_T* var_node;
+	VariableNode_T* subvar_node; /* first variable materialized from a subscript of this segment */
 	SegmentInfo_T seg_info;
+	uint32_T generation;         /* distinguishes this node from earlier nodes of the same segment number */
 };
 
+NodePool_T g_seg_node_pool = MSH_NODE_POOL_INITIALIZER(sizeof(struct SegmentNode_T), 64);
+
 
 SegmentNode_T* msh_CreateSegmentNode(SegmentInfo_T* seg_info_cache)
 {
-	SegmentNode_T* new_seg_node = mxMalloc(sizeof(SegmentNode_T));
-	mexMakeMemoryPersistent(new_seg_node);
+	static uint32_T next_generation = 0;
+	SegmentNode_T* new_seg_node = msh_AllocateNode(&g_seg_node_pool);
 	
 	msh_SetSegmentInfo(new_seg_node, seg_info_cache);
+	new_seg_node->generation = ++next_generation;
 	new_seg_node->var_node = NULL;
+	new_seg_node->subvar_node = NULL;
 	new_seg_node->parent_seg_list = NULL;
 	new_seg_node->prev = NULL;
 	new_seg_node->next = NULL;
@@ -40,7 +47,7 @@ SegmentNode_T* msh_CreateSegmentNode(SegmentInfo_T* seg_info_cache)
 
 void msh_DestroySegmentNode(SegmentNode_T* seg_node)
 {
-	mxFree(seg_node);
+	msh_FreeNode(&g_seg_node_pool, seg_node);
 }
 
 
@@ -70,12 +77,24 @@ SegmentInfo_T* msh_GetSegmentInfo(SegmentNode_T* seg_node)
 }
 
 
+uint32_T msh_GetSegmentGeneration(SegmentNode_T* seg_node)
+{
+	return seg_node->generation;
+}
+
+
 VariableNode_T* msh_GetVariableNode(SegmentNode_T* seg_node)
 {
 	return seg_node->var_node;
 }
 
 
+VariableNode_T* msh_GetSubVariableNode(SegmentNode_T* seg_node)
+{
+	return seg_node->subvar_node;
+}
+
+
 /** setters **/
 
 void msh_SetSegmentList(SegmentNode_T* seg_node, struct SegmentList_T* seg_list)
@@ -106,3 +125,9 @@ void msh_SetVariableNode(SegmentNode_T* seg_node, VariableNode_T* var_node)
 {
 	seg_node->var_node = var_node;
 }
+
+
+void msh_SetSubVariableNode(SegmentNode_T* seg_node, VariableNode_T* subvar_node)
+{
+	seg_node->subvar_node = subvar_node;
+}
@@ -9,8 +9,11 @@
 
 #include "mex.h"
 
+#include <string.h>
+
 #include "mshvariablenode.h"
 #include "mshsegmentnode.h"
+#include "mshpool.h"
 
 
 struct VariableNode_T
@@ -20,14 +23,18 @@ struct VariableNode_T
 	VariableNode_T* prev;
 	mxArray* var;
 	SegmentNode_T* seg_node;
+	VariableNode_T* next_subvar; /* sub-variables of the same segment */
+	VariableNode_T* prev_subvar;
 	int is_used;
 };
 
+NodePool_T g_var_node_pool = MSH_NODE_POOL_INITIALIZER(sizeof(struct VariableNode_T), 64);
+
 
 VariableNode_T* msh_CreateVariableNode(SegmentNode_T* seg_node, mxArray* new_var)
 {
-	VariableNode_T* new_var_node = mxCalloc(1, sizeof(VariableNode_T));
-	mexMakeMemoryPersistent(new_var_node);
+	VariableNode_T* new_var_node = msh_AllocateNode(&g_var_node_pool);
+	memset(new_var_node, 0, sizeof(VariableNode_T));
 	
 	new_var_node->seg_node = seg_node;
 	new_var_node->var = new_var;
@@ -73,6 +80,18 @@ SegmentNode_T* msh_GetSegmentNode(VariableNode_T* var_node)
 }
 
 
+VariableNode_T* msh_GetNextSubVariable(VariableNode_T* var_node)
+{
+	return var_node->next_subvar;
+}
+
+
+VariableNode_T* msh_GetPreviousSubVariable(VariableNode_T* var_node)
+{
+	return var_node->prev_subvar;
+}
+
+
 int msh_GetIsUsed(VariableNode_T* var_node)
 {
 	return var_node->is_used;
@@ -111,6 +130,18 @@ void msh_SetSegmentNode(VariableNode_T* var_node, SegmentNode_T* seg_node)
 }
 
 
+void msh_SetNextSubVariable(VariableNode_T* var_node, VariableNode_T* next_subvar_node)
+{
+	var_node->next_subvar = next_subvar_node;
+}
+
+
+void msh_SetPreviousSubVariable(VariableNode_T* var_node, VariableNode_T* prev_subvar_node)
+{
+	var_node->prev_subvar = prev_subvar_node;
+}
+
+
 void msh_SetIsUsed(VariableNode_T* var_node, int is_used)
 {
 	var_node->is_used = is_used;
@@ -119,5 +150,5 @@ void msh_SetIsUsed(VariableNode_T* var_node, int is_used)
 
 void msh_DestroyVariableNode(VariableNode_T* var_node)
 {
-	mxFree(var_node);
+	msh_FreeNode(&g_var_node_pool, var_node);
 }
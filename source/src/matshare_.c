@@ -11,6 +11,7 @@
 #include "mex.h"
 
 #include <ctype.h>
+#include <stdlib.h>
 
 #include "matshare_.h"
 #include "mshheader.h"
@@ -23,11 +24,16 @@
 #include "mshinit.h"
 #include "mshlockfree.h"
 #include "mshvarops.h"
+#include "mshthreads.h"
+#include "mshpool.h"
+#include "mshprocs.h"
 
 #ifdef MSH_UNIX
 #  include <string.h>
 #  include <sys/mman.h>
 #  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
 #endif
 
 char_T* g_msh_library_name         = "matshare";
@@ -39,6 +45,7 @@ LocalInfo_T g_local_info =
 	MSH_INITIAL_STATE,          /* rev_num */
 	0,                          /* lock_level */
 	0,                          /* this_pid */
+	MSH_INVALID_PROCESS_SLOT,   /* process_slot */
 	{
 		NULL,                  /* ptr */
 		MSH_INVALID_HANDLE     /* handle */
@@ -63,6 +70,7 @@ static SegmentTable_T s_mvar_table =
 {
 	NULL,
 	0,
+	0,
 	msh_GetSegmentHashByVariableAddress,
 	msh_CompareVariableAddressKey
 };
@@ -74,6 +82,7 @@ static SegmentTable_T s_seg_table =
 {
 	NULL,
 	0,
+	0,
 	msh_GetSegmentHashByNumber,
 	msh_CompareNumericKey
 };
@@ -85,6 +94,7 @@ static SegmentTable_T s_name_table =
 {
 	NULL,
 	0,
+	0,
 	msh_GetSegmentHashByName,
 	msh_CompareStringKey
 };
@@ -96,23 +106,38 @@ SegmentList_T g_local_seg_list =
 	NULL,
 	NULL,
 	0,
-	0
+	0,
+	MSH_INITIAL_STATE
 };
 
 VariableList_T g_local_var_list =
 {
 	&s_mvar_table,
 	NULL,
+	NULL,
 	NULL
 };
 
 /**
- * Wraps the output in a 1x1 cell array.
+ * Wraps a shared data copy of the variable in a 1x2 cell array along with
+ * the handle of its segment.
  *
- * @param shared_data_copy the output which should be a shared data copy.
+ * @param var_node The variable node.
+ * @param will_set_used Whether to mark the variable as used.
  * @return the wrapped output.
  */
-static mxArray* msh_WrapOutput(mxArray* shared_data_copy);
+static mxArray* msh_WrapOutput(VariableNode_T* var_node, int will_set_used);
+
+
+/**
+ * Finds the segment node of a wrapped variable, using its segment handle if
+ * it is still valid and its crosslinks otherwise.
+ *
+ * @param wrapped_var The wrapped variable.
+ * @param is_primary Set to whether the variable is the whole segment variable if the segment node was found. May be NULL.
+ * @return The segment node, or NULL if it is not tracked.
+ */
+static SegmentNode_T* msh_FindWrappedSegmentNode(const mxArray* wrapped_var, int* is_primary);
 
 
 /**
@@ -126,10 +151,20 @@ static mxArray* msh_CreateOutputRecent(void);
 /**
  * Creates output for all newly tracked variables.
  *
- * @param num_new_vars the number of newly tracked variables.
+ * @param new_seg_nodes the newly tracked segments.
+ * @param num_new_segs the number of newly tracked segments.
  * @return the output for the newly tracked variables.
  */
-static mxArray* msh_CreateOutputNew(size_t num_new_vars);
+static mxArray* msh_CreateOutputNew(SegmentNode_T** new_seg_nodes, size_t num_new_segs);
+
+
+/**
+ * Gets the variable node of the segment, creating and tracking it if it hasn't been created yet.
+ *
+ * @param seg_node the segment node.
+ * @return the variable node of the segment.
+ */
+static VariableNode_T* msh_GetOrCreateVariableNode(SegmentNode_T* seg_node);
 
 
 /**
@@ -156,6 +191,160 @@ static mxArray* msh_CreateOutputNamed(void);
  */
 static mxArray* msh_CreateNamedOutput(const char_T* name);
 
+
+/**
+ * Creates output for the subtrees of named variables addressed by a subscript struct.
+ *
+ * @param name The name of the variables.
+ * @param subs_struct The subscript struct.
+ * @return the output for the addressed subtrees.
+ */
+static mxArray* msh_CreateSubscriptedOutput(const char_T* name, const mxArray* subs_struct);
+
+
+/**
+ * Gets the header of the variable with the specified name in the segment. This is
+ * the segment data itself unless the segment is a batch.
+ *
+ * @param seg_node The segment node.
+ * @param name The name of the variable.
+ * @return The header of the named variable.
+ */
+static SharedVariableHeader_T* msh_GetEntryHeader(SegmentNode_T* seg_node, const char_T* name);
+
+
+/**
+ * Counts the name table entries matching the name, starting from the first match.
+ *
+ * @param first_entry The first matching table entry, or NULL if there were no matches.
+ * @param name The name of the variable.
+ * @return The number of matches.
+ */
+static size_t msh_CountTableEntries(SegmentTableEntry_T* first_entry, const char_T* name);
+
+
+/**
+ * Checks whether the input is the column block option.
+ *
+ * @param in_arg The input argument.
+ * @return Whether the input is the character vector '-block'.
+ */
+static int msh_IsBlockOption(const mxArray* in_arg);
+
+
+/**
+ * Finds a tracked segment which holds a variable identical to the input and was shared for deduplication.
+ *
+ * @param in_var The input variable.
+ * @param data_size The shared size of the input variable.
+ * @param content_hash The content hash of the input variable.
+ * @param input_id The name of the input variable, or NULL if unnamed.
+ * @param will_persist Whether the input variable is to be persistent.
+ * @return The matching segment node, or NULL if there was no match.
+ */
+static SegmentNode_T* msh_FindDuplicateSegment(const mxArray* in_var, size_t data_size, uint32_T content_hash, const mxArray* input_id, int will_persist);
+
+
+/**
+ * Creates a single segment holding all of the input variables. Named inputs are
+ * laid out as the fields of a scalar struct and unnamed inputs as a row cell.
+ *
+ * @param in_vars The input variables, each preceded by its name if with_names is set.
+ * @param num_vars The number of input variables.
+ * @param with_names Whether the input variables are named.
+ * @param will_persist Whether the segment is to be persistent.
+ * @return The new segment node, not yet added to any list.
+ */
+static SegmentNode_T* msh_CreateBatchSegment(const mxArray** in_vars, size_t num_vars, int with_names, int will_persist);
+
+
+/**
+ * Points the entries of the temporary batch variable at the inputs, or clears them.
+ *
+ * @param batch_var The temporary batch variable.
+ * @param in_vars The input variables, each preceded by its name if with_names is set.
+ * @param num_vars The number of input variables.
+ * @param with_names Whether the input variables are named.
+ * @param will_set Whether to set the entries rather than clear them.
+ */
+static void msh_SetBatchEntries(mxArray* batch_var, const mxArray** in_vars, size_t num_vars, int with_names, int will_set);
+
+
+/**
+ * Orders batch entry names, for use with qsort.
+ */
+static int msh_CompareEntryNames(const void* a, const void* b);
+
+
+/**
+ * Gets a positive integer option value.
+ *
+ * @param in_arg The input argument.
+ * @return The value.
+ */
+static size_t msh_GetPositiveIntegerOption(const mxArray* in_arg);
+
+
+/**
+ * Gets a class ID from a class name input.
+ *
+ * @param in_arg The input argument.
+ * @return The class ID.
+ */
+static mxClassID msh_GetClassOption(const mxArray* in_arg);
+
+
+/**
+ * Gets dimensions from a dimensions vector input. A scalar dimension N is
+ * interpreted as N-by-N, as with zeros.
+ *
+ * @param in_arg The input argument.
+ * @param num_dims Set to the number of dimensions.
+ * @return The dimensions. Must be freed with mxFree.
+ */
+static mwSize* msh_GetDimensionsOption(const mxArray* in_arg, size_t* num_dims);
+
+
+/**
+ * Closes an array of file handles.
+ *
+ * @param file_handles The file handles.
+ * @param num_files The number of file handles.
+ */
+static void msh_CloseFiles(handle_T* file_handles, size_t num_files);
+
+
+/**
+ * Opens a snapshot file.
+ *
+ * @param in_file_name The file name as a character vector.
+ * @param mode The mode passed to fopen.
+ * @return The opened file.
+ */
+static FILE* msh_OpenSnapshotFile(const mxArray* in_file_name, const char* mode);
+
+
+/**
+ * Writes a chunk of a snapshot file followed by padding to the data alignment.
+ *
+ * @param snapshot_file The snapshot file.
+ * @param chunk The chunk to write.
+ * @param chunk_size The size of the chunk.
+ * @return Whether the write was successful.
+ */
+static int msh_WriteSnapshotChunk(FILE* snapshot_file, const void* chunk, size_t chunk_size);
+
+
+/**
+ * Reads a chunk of a snapshot file and skips the padding after it.
+ *
+ * @param snapshot_file The snapshot file.
+ * @param chunk Where to put the chunk.
+ * @param chunk_size The size of the chunk.
+ * @return Whether the read was successful.
+ */
+static int msh_ReadSnapshotChunk(FILE* snapshot_file, void* chunk, size_t chunk_size);
+
 /* ------------------------------------------------------------------------- */
 /* Matlab gateway function                                                   */
 /* ------------------------------------------------------------------------- */
@@ -171,6 +360,9 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	/* resultant matshare directive */
 	msh_directive_T directive;
 	
+	/* whether to skip local garbage collection */
+	int is_fast_path;
+	
 	/* check the local struct for fatal errors */
 	if(g_local_info.has_fatal_error)
 	{
@@ -220,6 +412,9 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 					mexPrintf("    Number of shared variables:      %lu\n"
 					          "    Total size of shared memory:     "SIZE_FORMAT" bytes\n"
 					          "    PID of the most recent revision: %lu\n", g_shared_info->num_shared_segments, g_shared_info->total_shared_size, g_shared_info->update_pid);
+					mexPrintf("    Number of compressed variables:  %li\n"
+					          "    Compressed size:                 "SIZE_FORMAT" bytes\n"
+					          "    Uncompressed size:               "SIZE_FORMAT" bytes\n", g_shared_info->num_compressed_segments, g_shared_info->total_compressed_size, g_shared_info->total_uncompressed_size);
 					mexPrintf(MSH_CONFIG_STRING_FORMAT "\n", MSH_CONFIG_STRING_ARGS);
 #ifdef MSH_UNIX
 					mexPrintf(MSH_CONFIG_SECURITY_STRING_FORMAT, g_user_config.security);
@@ -254,7 +449,13 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		                 );
 	}
 	
-	msh_CleanSegmentList(&g_local_seg_list);
+	/* in-place operations do not create tracked variables, so leave garbage collection to the next directive */
+	is_fast_path = (directive == msh_VAROP || directive == msh_OVERWRITE || directive == msh_LOCK || directive == msh_UNLOCK);
+	
+	if(!is_fast_path)
+	{
+		msh_CleanSegmentList(&g_local_seg_list);
+	}
 	
 	switch(directive)
 	{
@@ -327,7 +528,53 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		}
 		case(msh_CLEAN):
 		{
-			/* do nothing */
+			/* release whatever crashed processes left behind; unused variables are collected below */
+			msh_ReapDeadProcesses(&g_local_seg_list);
+			break;
+		}
+		case(msh_ALLOC):
+		{
+			/* we use varargin and extract the result */
+			if(num_in_args < 2)
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NotEnoughInputsError", "Not enough inputs. Please use the entry functions provided.");
+			}
+			msh_Alloc(nlhs, plhs, mxGetNumberOfElements(in_args[1]), mxGetData(in_args[1]), (int)mxGetScalar(in_args[0]));
+			break;
+		}
+		case(msh_OVERWRITE):
+		{
+			msh_Overwrite(nlhs, plhs, num_in_args, in_args);
+			break;
+		}
+		case(msh_SNAPSHOT):
+		{
+			msh_Snapshot(num_in_args, in_args);
+			break;
+		}
+		case(msh_RESTORE):
+		{
+			msh_Restore(nlhs, plhs, num_in_args, in_args);
+			break;
+		}
+		case(msh_LOADFILE):
+		{
+			/* we use varargin and extract the result */
+			if(num_in_args < 2)
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NotEnoughInputsError", "Not enough inputs. Please use the entry functions provided.");
+			}
+			msh_LoadFile(nlhs, plhs, mxGetNumberOfElements(in_args[1]), mxGetData(in_args[1]), (int)mxGetScalar(in_args[0]));
+			break;
+		}
+		case(msh_MAPFILE):
+		{
+			/* we use varargin and extract the result */
+			if(num_in_args < 2)
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NotEnoughInputsError", "Not enough inputs. Please use the entry functions provided.");
+			}
+			msh_MapFile(nlhs, plhs, mxGetNumberOfElements(in_args[1]), mxGetData(in_args[1]), (int)mxGetScalar(in_args[0]));
 			break;
 		}
 		default:
@@ -337,7 +584,14 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		}
 	}
 	
-	msh_CleanVariableList(&g_local_var_list, directive == msh_CLEAN);
+	if(directive == msh_CLEAN)
+	{
+		msh_CleanVariableList(&g_local_var_list, SIZE_MAX, TRUE);
+	}
+	else if(!is_fast_path)
+	{
+		msh_CleanVariableList(&g_local_var_list, MSH_VARIABLE_SWEEP_SIZE, FALSE);
+	}
 	
 }
 
@@ -352,6 +606,14 @@ void msh_Share(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 	
 	int                 will_persist = FALSE;
 	int                 with_names   = FALSE;
+	int                 will_dedup   = FALSE;
+	int                 will_compress = FALSE;
+	int                 will_batch   = FALSE;
+	size_t              shared_size, compressed_size;
+	void*               uncompressed_data;
+	uint8_T*            compressed_data;
+	uint32_T            content_hash = 0;
+	size_t              num_blocks   = 0;
 	SegmentNode_T*      new_seg_node = NULL;
 	VariableNode_T*     new_var_node = NULL;
 	
@@ -386,6 +648,30 @@ void msh_Share(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 					with_names = TRUE;
 					break;
 				}
+				case('d'):
+				{
+					will_dedup = TRUE;
+					break;
+				}
+				case('z'):
+				{
+					will_compress = TRUE;
+					break;
+				}
+				case('b'):
+				{
+					if(!msh_IsBlockOption(in_args[i]))
+					{
+						will_batch = TRUE;
+						break;
+					}
+					if(i + 1 >= num_args)
+					{
+						meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "ShareOptionError", "The '-block' option must be followed by the number of column blocks.");
+					}
+					num_blocks = msh_GetPositiveIntegerOption(in_args[++i]);
+					break;
+				}
 				default:
 				{
 					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "ShareOptionError", "Invalid option flag. Note that character vectors longer than 1 starting with '-' are reserved for option flags.");
@@ -413,6 +699,33 @@ void msh_Share(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "OutputError", "Too many outputs.");
 	}
 	
+	if(will_batch)
+	{
+		if(will_dedup || will_compress || num_blocks > 0)
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "ShareOptionError", "The '-b' option cannot be combined with '-d', '-z', or '-block'.");
+		}
+		
+		/* one segment, one lock acquisition, and one revision for all the inputs */
+		new_seg_node = msh_CreateBatchSegment(in_vars, num_vars, with_names, will_persist);
+		msh_AddSegmentToList(&g_local_seg_list, new_seg_node);
+		msh_AddSegmentToSharedList(new_seg_node);
+		
+		new_var_node = msh_CreateVariable(new_seg_node);
+		msh_AddVariableToList(&g_local_var_list, new_var_node);
+		
+		/* each entry is passed back as a sub-variable of the batch */
+		for(j = 0; j < (size_t)nlhs; j++)
+		{
+			new_var_node = msh_CreateSubVariable(new_seg_node, msh_GetChildHeader(msh_GetSegmentData(new_seg_node), j));
+			msh_AddVariableToList(&g_local_var_list, new_var_node);
+			plhs[j] = msh_WrapOutput(new_var_node, j > 0 || !return_to_ans);
+		}
+		
+		mxFree((void*)in_vars);
+		return;
+	}
+	
 	/* main loop */
 	for(i = 0, j = 0, input_id = NULL; i < num_vars; i++)
 	{
@@ -427,28 +740,88 @@ void msh_Share(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 			curr_in_var = in_vars[i];
 		}
 		
-		/* scan input data to get required size and create the segment */
-		new_seg_node = msh_CreateSegment(msh_FindSharedSize(curr_in_var), input_id, will_persist);
-		
-		/* copy data to the shared memory */
-		msh_CopyVariable(msh_GetSegmentData(new_seg_node), curr_in_var);
-		
-		/* segment must also be tracked locally, so do that now */
-		msh_AddSegmentToList(&g_local_seg_list, new_seg_node);
+		new_seg_node = NULL;
+		shared_size = num_blocks > 0? 0 : msh_FindSharedSize(curr_in_var);
+		if(will_dedup && num_blocks == 0)
+		{
+			/* hold the lock until the segment is listed so that concurrent dedups can't both miss and create */
+			msh_AcquireProcessLock(g_process_lock);
+			
+			/* reuse an identical variable if one was already shared for deduplication */
+			content_hash = msh_HashVariableContent(curr_in_var, 'm'+'s'+'h');
+			new_seg_node = msh_FindDuplicateSegment(curr_in_var, shared_size, content_hash, input_id, will_persist);
+		}
 		
-		/* Add the new segment to the shared list */
-		msh_AddSegmentToSharedList(new_seg_node);
+		if(new_seg_node == NULL)
+		{
+			if(num_blocks > 0)
+			{
+				/* lay out as a cell of column blocks which may be fetched independently */
+				new_seg_node = msh_CreateSegment(msh_FindBlockedSharedSize(curr_in_var, num_blocks), input_id, will_persist);
+				msh_CopyVariableBlocked(msh_GetSegmentData(new_seg_node), curr_in_var, num_blocks);
+			}
+			else if(will_compress)
+			{
+				/* lay out the variable privately, then store it compressed */
+				uncompressed_data = mxCalloc(shared_size, 1);
+				msh_CopyVariable(uncompressed_data, curr_in_var);
+				
+				compressed_data = mxMalloc(msh_FindCompressedBound(shared_size));
+				compressed_size = msh_Compress(compressed_data, uncompressed_data, shared_size);
+				mxFree(uncompressed_data);
+				
+				new_seg_node = msh_CreateSegment(compressed_size, input_id, will_persist);
+				memcpy(msh_GetSegmentData(new_seg_node), compressed_data, compressed_size);
+				mxFree(compressed_data);
+				
+				/* set these after copying so the data isn't decompressed yet */
+				msh_GetSegmentMetadata(new_seg_node)->uncompressed_size = shared_size;
+				msh_GetSegmentMetadata(new_seg_node)->is_compressed = TRUE;
+				
+				msh_AtomicIncrement(&g_shared_info->num_compressed_segments);
+				msh_AtomicAddSizeWithMax(&g_shared_info->total_compressed_size, compressed_size, SIZE_MAX);
+				msh_AtomicAddSizeWithMax(&g_shared_info->total_uncompressed_size, shared_size, SIZE_MAX);
+			}
+			else
+			{
+				/* scan input data to get required size and create the segment */
+				new_seg_node = msh_CreateSegment(shared_size, input_id, will_persist);
+				
+				/* copy data to the shared memory */
+				msh_CopyVariable(msh_GetSegmentData(new_seg_node), curr_in_var);
+			}
+			
+			if(will_dedup && num_blocks == 0)
+			{
+				msh_GetSegmentMetadata(new_seg_node)->content_hash = content_hash;
+				msh_GetSegmentMetadata(new_seg_node)->has_content_hash = TRUE;
+			}
+			
+			/* segment must also be tracked locally, so do that now */
+			msh_AddSegmentToList(&g_local_seg_list, new_seg_node);
+			
+			/* Add the new segment to the shared list */
+			msh_AddSegmentToSharedList(new_seg_node);
+		}
 		
-		/* create a shared variable to pass back to the caller */
-		new_var_node = msh_CreateVariable(new_seg_node);
+		if(will_dedup && num_blocks == 0)
+		{
+			msh_ReleaseProcessLock(g_process_lock);
+		}
 		
-		/* add that variable to a tracking list */
-		msh_AddVariableToList(&g_local_var_list, new_var_node);
+		if((new_var_node = msh_GetVariableNode(new_seg_node)) == NULL)
+		{
+			/* create a shared variable to pass back to the caller */
+			new_var_node = msh_CreateVariable(new_seg_node);
+			
+			/* add that variable to a tracking list */
+			msh_AddVariableToList(&g_local_var_list, new_var_node);
+		}
 		
 		/* create and set the return */
 		if(j < (size_t)nlhs)
 		{
-			plhs[j] = msh_WrapOutput(msh_CreateSharedDataCopy(new_var_node, j > 0 || !return_to_ans));
+			plhs[j] = msh_WrapOutput(new_var_node, j > 0 || !return_to_ans);
 			j += 1;
 		}
 	}
@@ -458,69 +831,482 @@ void msh_Share(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 }
 
 
-void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args)
+void msh_Alloc(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args, int return_to_ans)
 {
-	unsigned            arg_num, out_num, num_out;
-	size_t              num_new_vars, num_op_args;
-	char_T              input_str[MSH_NAME_LEN_MAX];
-	SegmentNode_T*      curr_seg_node;
-	
+	size_t              i, num_dims;
+	mxChar*             in_opt;
+	mxClassID           class_id;
+	mwSize*             dims;
+	const mxArray*      input_id = NULL;
 	
-	int                 output_as_struct   = FALSE;
-	int                 will_fetch_default = FALSE;
-	UpdateFunction_t    update_function    = NULL;
-	const char_T*       all_out_names[]    = {"recent", "new", "all", "named"};
+	int                 will_persist = FALSE;
+	int                 is_complex   = FALSE;
+	SegmentNode_T*      new_seg_node = NULL;
+	VariableNode_T*     new_var_node = NULL;
 	
-	if(nlhs < 1)
+	if(nlhs > 1)
 	{
-		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NumOutputsError", "Too few outputs were requested from the fetch operation. Please use the provided entry functions.");
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "OutputError", "Too many outputs.");
 	}
 	
-	if(num_args > INT_MAX)
+	if(num_args < 2)
 	{
-		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NumInputsError", "Too many arguments.");
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NotEnoughInputsError", "A class and dimensions must be supplied to allocate a variable.");
 	}
 	
-	/* preprocessing pass */
-	num_out = (int)num_args;
-	for(arg_num = 0, num_op_args = 0; arg_num < num_args; arg_num++)
+	class_id = msh_GetClassOption(in_args[0]);
+	dims = msh_GetDimensionsOption(in_args[1], &num_dims);
+	
+	/* parse options */
+	for(i = 2; i < num_args; i++)
 	{
-		/* input validation */
-		if(!mxIsChar(in_args[arg_num]))
-		{
-			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "All arguments must be of type 'char'.");
-		}
-		
-		if(mxIsEmpty(in_args[arg_num]))
-		{
-			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "All arguments must have a length more than zero.");
-		}
-		
-		if(mxGetChars(in_args[arg_num])[0] == '-')
+		if(mxIsChar(in_args[i])
+		   && mxGetNumberOfElements(in_args[i]) > 1
+		   && (in_opt = mxGetChars(in_args[i]))[0] == '-')
 		{
-			
-			if(mxGetNumberOfElements(in_args[arg_num]) < 2)
-			{
-				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "Option flags must have length more than 1.");
-			}
-			
-			switch(mxGetChars(in_args[arg_num])[1])
+			switch(in_opt[1])
 			{
-				case(MSH_FETCHOPT_STRUCT):
-					num_out = 1;
-					output_as_struct = TRUE;
+				case('p'):
+				{
+					will_persist = TRUE;
 					break;
-				case(MSH_FETCHOPT_RECENT):
+				}
+				case('c'):
 				{
-					/* only update the most recent (fast-track) */
-					if(update_function != msh_UpdateAllSegments)
+					is_complex = TRUE;
+					break;
+				}
+				case('n'):
+				{
+					if(i + 1 >= num_args)
 					{
-						update_function = msh_UpdateLatestSegment;
+						meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InputError", "A name must follow '-n'.");
 					}
-					num_op_args++;
+					input_id = in_args[++i];
 					break;
 				}
-				case(MSH_FETCHOPT_NEW):
+				default:
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "AllocOptionError", "Invalid option flag.");
+				}
+			}
+		}
+		else
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InputError", "Unexpected input. Only option flags may follow the dimensions.");
+		}
+	}
+	
+	/* create the segment; the new segment memory is already zeroed */
+	new_seg_node = msh_CreateSegment(msh_FindAllocatedSize(class_id, num_dims, dims, is_complex), input_id, will_persist);
+	
+	/* lay out the header without copying any data */
+	msh_AllocateVariable(msh_GetSegmentData(new_seg_node), class_id, num_dims, dims, is_complex);
+	
+	mxFree(dims);
+	
+	/* track the segment locally and in shared memory */
+	msh_AddSegmentToList(&g_local_seg_list, new_seg_node);
+	msh_AddSegmentToSharedList(new_seg_node);
+	
+	/* create a shared variable to pass back to the caller */
+	new_var_node = msh_CreateVariable(new_seg_node);
+	msh_AddVariableToList(&g_local_var_list, new_var_node);
+	
+	plhs[0] = msh_WrapOutput(new_var_node, !return_to_ans);
+	
+}
+
+
+void msh_MapFile(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args, int return_to_ans)
+{
+#ifdef MSH_UNIX
+	size_t              i, num_dims, data_size, file_path_offset;
+	mxChar*             in_opt;
+	mxClassID           class_id;
+	mwSize*             dims;
+	char_T*             in_path;
+	char*               file_path;
+	struct stat         file_stat;
+	const mxArray*      input_id = NULL;
+	
+	int                 will_persist = FALSE;
+	SegmentNode_T*      new_seg_node = NULL;
+	VariableNode_T*     new_var_node = NULL;
+#endif
+	
+	if(nlhs > 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "OutputError", "Too many outputs.");
+	}
+	
+	if(num_args < 3)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NotEnoughInputsError", "A file path, class, and dimensions must be supplied to map a file.");
+	}
+
+#ifdef MSH_WIN
+	meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "FileMappingError", "Variables mapped from files are not supported on Windows.");
+#else
+	
+	if(!mxIsChar(in_args[0]) || mxIsEmpty(in_args[0]))
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFileNameError", "The file path must be a non-empty character vector.");
+	}
+	
+	class_id = msh_GetClassOption(in_args[1]);
+	dims = msh_GetDimensionsOption(in_args[2], &num_dims);
+	
+	/* parse options */
+	for(i = 3; i < num_args; i++)
+	{
+		if(mxIsChar(in_args[i])
+		   && mxGetNumberOfElements(in_args[i]) > 1
+		   && (in_opt = mxGetChars(in_args[i]))[0] == '-')
+		{
+			switch(in_opt[1])
+			{
+				case('p'):
+				{
+					will_persist = TRUE;
+					break;
+				}
+				case('n'):
+				{
+					if(i + 1 >= num_args)
+					{
+						meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InputError", "A name must follow '-n'.");
+					}
+					input_id = in_args[++i];
+					break;
+				}
+				default:
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "MapFileOptionError", "Invalid option flag.");
+				}
+			}
+		}
+		else
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InputError", "Unexpected input. Only option flags may follow the dimensions.");
+		}
+	}
+	
+	data_size = msh_FindMappedDataSize(class_id, num_dims, dims);
+	
+	/* other processes open the file by its path, so resolve it now */
+	in_path = mxArrayToString(in_args[0]);
+	if((file_path = realpath(in_path, NULL)) == NULL)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM | MEU_ERRNO, "FileOpenError", "Could not resolve the file '%s'.", in_path);
+	}
+	mxFree(in_path);
+	
+	if(stat(file_path, &file_stat) != 0 || (size_t)file_stat.st_size < data_size)
+	{
+		free(file_path);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "FileSizeError", "The file is smaller than the requested variable ("SIZE_FORMAT" bytes).", data_size);
+	}
+	
+	/* the side segment only holds the header and ends on a page boundary where the file is mapped */
+	new_seg_node = msh_CreateSegment(msh_FindPageAlignedDataSize(msh_FindMappedHeaderSize(num_dims, file_path)), input_id, will_persist);
+	file_path_offset = msh_MapVariable(msh_GetSegmentData(new_seg_node), class_id, num_dims, dims, file_path, msh_GetSegmentMetadata(new_seg_node)->data_size);
+	msh_SetSegmentFile(new_seg_node, file_path_offset, data_size);
+	
+	free(file_path);
+	mxFree(dims);
+	
+	/* track the segment locally and in shared memory */
+	msh_AddSegmentToList(&g_local_seg_list, new_seg_node);
+	msh_AddSegmentToSharedList(new_seg_node);
+	
+	/* create a shared variable to pass back to the caller */
+	new_var_node = msh_CreateVariable(new_seg_node);
+	msh_AddVariableToList(&g_local_var_list, new_var_node);
+	
+	plhs[0] = msh_WrapOutput(new_var_node, !return_to_ans);
+#endif
+
+}
+
+
+void msh_LoadFile(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args, int return_to_ans)
+{
+	size_t                  i, num_dims, num_files, data_size, total_file_size;
+	mxChar*                 in_opt;
+	mxClassID               class_id;
+	mwSize*                 dims;
+	char_T*                 file_name;
+	handle_T*               file_handles;
+	size_t*                 file_sizes;
+	const mxArray**         in_files;
+	const mxArray*          input_id = NULL;
+	double                  start_time, elapsed_time;
+	int                     error_code;
+	mxArray*                load_stats;
+#ifdef MSH_WIN
+	LARGE_INTEGER           file_size;
+#else
+	struct stat             file_stat;
+#endif
+	
+	int                     will_persist = FALSE;
+	size_t                  num_threads  = msh_GetNumProcessors();
+	SharedVariableHeader_T* new_header;
+	SegmentNode_T*          new_seg_node = NULL;
+	VariableNode_T*         new_var_node = NULL;
+	const char_T*           stats_fields[] = {"bytes", "seconds", "throughput"};
+	
+	if(nlhs > 2)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "OutputError", "Too many outputs.");
+	}
+	
+	if(num_args < 3)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NotEnoughInputsError", "The files, class, and dimensions must be supplied to load a variable.");
+	}
+	
+	/* parse the files */
+	if(mxIsCell(in_args[0]))
+	{
+		num_files = mxGetNumberOfElements(in_args[0]);
+		in_files = mxGetData(in_args[0]);
+	}
+	else
+	{
+		num_files = 1;
+		in_files = in_args;
+	}
+	
+	for(i = 0; i < num_files; i++)
+	{
+		if(!mxIsChar(in_files[i]) || mxIsEmpty(in_files[i]))
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFileNameError", "The files must be specified as a character vector or a cell array of character vectors.");
+		}
+	}
+	
+	class_id = msh_GetClassOption(in_args[1]);
+	dims = msh_GetDimensionsOption(in_args[2], &num_dims);
+	
+	/* parse options */
+	for(i = 3; i < num_args; i++)
+	{
+		if(mxIsChar(in_args[i])
+		   && mxGetNumberOfElements(in_args[i]) > 1
+		   && (in_opt = mxGetChars(in_args[i]))[0] == '-')
+		{
+			switch(in_opt[1])
+			{
+				case('p'):
+				{
+					will_persist = TRUE;
+					break;
+				}
+				case('n'):
+				{
+					if(i + 1 >= num_args)
+					{
+						meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InputError", "A name must follow '-n'.");
+					}
+					input_id = in_args[++i];
+					break;
+				}
+				case('t'):
+				{
+					if(i + 1 >= num_args)
+					{
+						meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InputError", "The number of threads must follow '-t'.");
+					}
+					num_threads = msh_GetPositiveIntegerOption(in_args[++i]);
+					break;
+				}
+				default:
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "LoadFileOptionError", "Invalid option flag.");
+				}
+			}
+		}
+		else
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InputError", "Unexpected input. Only option flags may follow the dimensions.");
+		}
+	}
+	
+	data_size = msh_FindMappedDataSize(class_id, num_dims, dims);
+	
+	/* open all the files up front so that any errors are raised before the segment is created */
+	file_handles = mxMalloc(num_files*sizeof(handle_T));
+	file_sizes = mxMalloc(num_files*sizeof(size_t));
+	for(i = 0, total_file_size = 0; i < num_files; i++)
+	{
+		file_name = mxArrayToString(in_files[i]);
+#ifdef MSH_WIN
+		file_handles[i] = CreateFile(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(file_handles[i] == INVALID_HANDLE_VALUE || GetFileSizeEx(file_handles[i], &file_size) == 0)
+#else
+		file_handles[i] = open(file_name, O_RDONLY);
+		if(file_handles[i] == -1 || fstat(file_handles[i], &file_stat) != 0)
+#endif
+		{
+			msh_CloseFiles(file_handles, (file_handles[i] != MSH_INVALID_HANDLE)? i + 1 : i);
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM, "FileOpenError", "Could not open the file '%s'.", file_name);
+		}
+#ifdef MSH_WIN
+		file_sizes[i] = (size_t)file_size.QuadPart;
+#else
+		file_sizes[i] = (size_t)file_stat.st_size;
+#endif
+		total_file_size += file_sizes[i];
+		mxFree(file_name);
+	}
+	
+	if(total_file_size != data_size)
+	{
+		msh_CloseFiles(file_handles, num_files);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "FileSizeError", "The total size of the files ("SIZE_FORMAT" bytes) does not match the size of the variable ("SIZE_FORMAT" bytes).", total_file_size, data_size);
+	}
+	
+	new_seg_node = msh_CreateSegment(msh_FindAllocatedSize(class_id, num_dims, dims, FALSE), input_id, will_persist);
+	new_header = msh_GetSegmentData(new_seg_node);
+	msh_AllocateVariable(new_header, class_id, num_dims, dims, FALSE);
+	mxFree(dims);
+	
+	/* read straight into the segment */
+	start_time = msh_GetTime();
+	error_code = msh_ReadFiles(msh_GetData(new_header), file_handles, file_sizes, num_files, num_threads);
+	elapsed_time = msh_GetTime() - start_time;
+	
+	msh_CloseFiles(file_handles, num_files);
+	mxFree(file_sizes);
+	
+	if(error_code != 0)
+	{
+		msh_DetachSegment(new_seg_node);
+#ifdef MSH_WIN
+		SetLastError((DWORD)error_code);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM, "FileReadError", "There was an error reading the files.");
+#else
+		errno = error_code;
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM | MEU_ERRNO, "FileReadError", "There was an error reading the files.");
+#endif
+	}
+	
+	/* track the segment locally and in shared memory */
+	msh_AddSegmentToList(&g_local_seg_list, new_seg_node);
+	msh_AddSegmentToSharedList(new_seg_node);
+	
+	/* create a shared variable to pass back to the caller */
+	new_var_node = msh_CreateVariable(new_seg_node);
+	msh_AddVariableToList(&g_local_var_list, new_var_node);
+	
+	plhs[0] = msh_WrapOutput(new_var_node, !return_to_ans);
+	
+	if(nlhs > 1)
+	{
+		load_stats = mxCreateStructMatrix(1, 1, 3, stats_fields);
+		mxSetField(load_stats, 0, "bytes", mxCreateDoubleScalar((double)data_size));
+		mxSetField(load_stats, 0, "seconds", mxCreateDoubleScalar(elapsed_time));
+		mxSetField(load_stats, 0, "throughput", mxCreateDoubleScalar((elapsed_time > 0)? (double)data_size/elapsed_time : 0.0));
+		plhs[1] = load_stats;
+	}
+	
+}
+
+
+void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_args)
+{
+	unsigned            arg_num, out_num, num_out;
+	size_t              num_new_segs, num_op_args, num_subscripted;
+	char_T              input_str[MSH_NAME_LEN_MAX];
+	SegmentNode_T*      curr_seg_node;
+	SegmentNode_T**     new_seg_nodes;
+	mxArray*            blk_subs_struct;
+	mxArray*            blk_subs;
+	
+	
+	int                 output_as_struct   = FALSE;
+	int                 will_fetch_default = FALSE;
+	UpdateFunction_t    update_function    = NULL;
+	const char_T*       all_out_names[]    = {"recent", "new", "all", "named"};
+	const char_T*       blk_subs_fields[]  = {"type", "subs"};
+	
+	if(nlhs < 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NumOutputsError", "Too few outputs were requested from the fetch operation. Please use the provided entry functions.");
+	}
+	
+	if(num_args > INT_MAX)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NumInputsError", "Too many arguments.");
+	}
+	
+	/* preprocessing pass */
+	num_out = (int)num_args;
+	for(arg_num = 0, num_op_args = 0, num_subscripted = 0; arg_num < num_args; arg_num++)
+	{
+		/* subscripts apply to the preceding variable name */
+		if(mxIsStruct(in_args[arg_num]))
+		{
+			if(arg_num == 0 || !mxIsChar(in_args[arg_num - 1]) || mxIsEmpty(in_args[arg_num - 1]) || mxGetChars(in_args[arg_num - 1])[0] == '-')
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "Subscripts must directly follow a variable name.");
+			}
+			num_out -= 1;
+			num_subscripted += 1;
+			continue;
+		}
+		
+		/* input validation */
+		if(!mxIsChar(in_args[arg_num]))
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "All arguments must be of type 'char' or subscript structs.");
+		}
+		
+		if(mxIsEmpty(in_args[arg_num]))
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "All arguments must have a length more than zero.");
+		}
+		
+		if(mxGetChars(in_args[arg_num])[0] == '-')
+		{
+			
+			if(mxGetNumberOfElements(in_args[arg_num]) < 2)
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "Option flags must have length more than 1.");
+			}
+			
+			if(msh_IsBlockOption(in_args[arg_num]))
+			{
+				/* block i of the preceding variable name */
+				if(arg_num == 0 || !mxIsChar(in_args[arg_num - 1]) || mxIsEmpty(in_args[arg_num - 1]) || mxGetChars(in_args[arg_num - 1])[0] == '-' || arg_num + 1 >= num_args)
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "The '-block' option must directly follow a variable name and be followed by a block number.");
+				}
+				msh_GetPositiveIntegerOption(in_args[++arg_num]);
+				num_out -= 2;
+				num_subscripted += 1;
+				continue;
+			}
+			
+			switch(mxGetChars(in_args[arg_num])[1])
+			{
+				case(MSH_FETCHOPT_STRUCT):
+					num_out = 1;
+					output_as_struct = TRUE;
+					break;
+				case(MSH_FETCHOPT_RECENT):
+				{
+					/* only update the most recent (fast-track) */
+					if(update_function != msh_UpdateAllSegments)
+					{
+						update_function = msh_UpdateLatestSegment;
+					}
+					num_op_args++;
+					break;
+				}
+				case(MSH_FETCHOPT_NEW):
 				case(MSH_FETCHOPT_ALL):
 				case(MSH_FETCHOPT_NAMED):
 				{
@@ -567,6 +1353,11 @@ void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 		update_function = msh_UpdateAllSegments;
 	}
 	
+	if(output_as_struct && num_subscripted > 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFetchError", "Subscripted fetches cannot be returned in a struct.");
+	}
+	
 	if((unsigned)nlhs > num_out)
 	{
 		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "TooManyOutputsError", "Too many outputs requested.");
@@ -575,14 +1366,25 @@ void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 	/* run the update operation */
 	update_function(&g_local_seg_list);
 	
-	/* create backing variables for each segment; this isn't very expensive so do it in any case */
-	for(curr_seg_node = g_local_seg_list.first, num_new_vars = 0; curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
+	/* create backing variables for each segment; skip this if only subtrees were requested since the full trees may be large */
+	num_new_segs = 0;
+	
+	/* keep the new segments here since sub-variables are also appended to the variable list while creating outputs */
+	new_seg_nodes = mxMalloc((g_local_seg_list.num_segs > 0? g_local_seg_list.num_segs : 1)*sizeof(SegmentNode_T*));
+	if(num_subscripted == 0 || num_subscripted != num_op_args)
 	{
-		if(msh_GetVariableNode(curr_seg_node) == NULL)
+		for(curr_seg_node = g_local_seg_list.first; curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
 		{
-			/* create the variable node if it hasnt been created yet */
-			msh_AddVariableToList(&g_local_var_list, msh_CreateVariable(curr_seg_node));
-			num_new_vars += 1;
+			if(msh_GetVariableNode(curr_seg_node) == NULL)
+			{
+				/* compressed segments are only decompressed once an output actually needs them */
+				if(!msh_GetSegmentMetadata(curr_seg_node)->is_compressed)
+				{
+					msh_GetOrCreateVariableNode(curr_seg_node);
+				}
+				new_seg_nodes[num_new_segs] = curr_seg_node;
+				num_new_segs += 1;
+			}
 		}
 	}
 	
@@ -621,7 +1423,7 @@ void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 							if(!mxGetField(plhs[0], 0, "new"))
 							{
 								mxAddField(plhs[0], "new");
-								mxSetField(plhs[0], 0, "new", msh_CreateOutputNew(num_new_vars));
+								mxSetField(plhs[0], 0, "new", msh_CreateOutputNew(new_seg_nodes, num_new_segs));
 							}
 							break;
 						}
@@ -669,7 +1471,7 @@ void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 			/* there weren't any other operation arguments, so output everything */
 			plhs[0] = mxCreateStructMatrix(1, 1, 4, all_out_names);
 			mxSetField(plhs[0], 0, "recent", msh_CreateOutputRecent());
-			mxSetField(plhs[0], 0, "new", msh_CreateOutputNew(num_new_vars));
+			mxSetField(plhs[0], 0, "new", msh_CreateOutputNew(new_seg_nodes, num_new_segs));
 			mxSetField(plhs[0], 0, "all", msh_CreateOutputAll());
 			mxSetField(plhs[0], 0, "named", msh_CreateOutputNamed());
 		}
@@ -702,7 +1504,7 @@ void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 					case (MSH_FETCHOPT_NEW):
 					{
 						/* return the new variables detected */
-						plhs[out_num] = msh_CreateOutputNew(num_new_vars);
+						plhs[out_num] = msh_CreateOutputNew(new_seg_nodes, num_new_segs);
 						out_num += 1;
 						break;
 					}
@@ -726,16 +1528,39 @@ void msh_Fetch(int nlhs, mxArray** plhs, size_t num_args, const mxArray** in_arg
 					}
 				}
 			}
+			else if(!will_fetch_default && arg_num + 2 < num_args && msh_IsBlockOption(in_args[arg_num + 1]))
+			{
+				/* materialize only the requested column block */
+				blk_subs_struct = mxCreateStructMatrix(1, 1, 2, blk_subs_fields);
+				blk_subs = mxCreateCellMatrix(1, 1);
+				mxSetCell(blk_subs, 0, mxCreateDoubleScalar((double)msh_GetPositiveIntegerOption(in_args[arg_num + 2])));
+				mxSetField(blk_subs_struct, 0, "type", mxCreateString("{}"));
+				mxSetField(blk_subs_struct, 0, "subs", blk_subs);
+				
+				plhs[out_num] = msh_CreateSubscriptedOutput(input_str, blk_subs_struct);
+				mxDestroyArray(blk_subs_struct);
+				out_num += 1;
+				arg_num += 2;
+			}
+			else if(!will_fetch_default && arg_num + 1 < num_args && mxIsStruct(in_args[arg_num + 1]))
+			{
+				/* materialize only the subtree addressed by the following subscripts */
+				plhs[out_num] = msh_CreateSubscriptedOutput(input_str, in_args[arg_num + 1]);
+				out_num += 1;
+				arg_num += 1;
+			}
 			else
 			{
 				/* find variable by identifier */
-				plhs[arg_num] = msh_CreateNamedOutput(input_str);
+				plhs[out_num] = msh_CreateNamedOutput(input_str);
 				out_num += 1;
 			}
 			
 		}
 	}
 	
+	mxFree(new_seg_nodes);
+	
 }
 
 
@@ -744,25 +1569,36 @@ static mxArray* msh_CreateOutputRecent(void)
 	mxArray* out = mxCreateCellMatrix((size_t)(g_local_seg_list.last != NULL), (size_t)(g_local_seg_list.last != NULL));
 	if(g_local_seg_list.last != NULL)
 	{
-		mxSetCell(out, 0, msh_WrapOutput(msh_CreateSharedDataCopy(msh_GetVariableNode(g_local_seg_list.last), TRUE)));
+		mxSetCell(out, 0, msh_WrapOutput(msh_GetOrCreateVariableNode(g_local_seg_list.last), TRUE));
 	}
 	return out;
 }
 
 
-static mxArray* msh_CreateOutputNew(size_t num_new_vars)
+static mxArray* msh_CreateOutputNew(SegmentNode_T** new_seg_nodes, size_t num_new_segs)
 {
 	size_t i;
-	VariableNode_T* curr_var_node;
-	mxArray* out = mxCreateCellMatrix(num_new_vars, (size_t)(num_new_vars > 0));
-	for(i = 0, curr_var_node = g_local_var_list.last; i < num_new_vars; i++, curr_var_node = msh_GetPreviousVariable(curr_var_node))
+	mxArray* out = mxCreateCellMatrix(num_new_segs, (size_t)(num_new_segs > 0));
+	for(i = 0; i < num_new_segs; i++)
 	{
-		mxSetCell(out, num_new_vars - 1 - i, msh_WrapOutput(msh_CreateSharedDataCopy(curr_var_node, TRUE)));
+		mxSetCell(out, i, msh_WrapOutput(msh_GetOrCreateVariableNode(new_seg_nodes[i]), TRUE));
 	}
 	return out;
 }
 
 
+static VariableNode_T* msh_GetOrCreateVariableNode(SegmentNode_T* seg_node)
+{
+	VariableNode_T* var_node;
+	if((var_node = msh_GetVariableNode(seg_node)) == NULL)
+	{
+		var_node = msh_CreateVariable(seg_node);
+		msh_AddVariableToList(&g_local_var_list, var_node);
+	}
+	return var_node;
+}
+
+
 static mxArray* msh_CreateOutputAll(void)
 {
 	size_t i;
@@ -770,57 +1606,400 @@ static mxArray* msh_CreateOutputAll(void)
 	mxArray* out = mxCreateCellMatrix(g_local_seg_list.num_segs, (size_t)(g_local_seg_list.num_segs > 0));
 	for(i = 0, curr_seg_node = g_local_seg_list.first; i < g_local_seg_list.num_segs; i++, curr_seg_node = msh_GetNextSegment(curr_seg_node))
 	{
-		mxSetCell(out, i, msh_WrapOutput(msh_CreateSharedDataCopy(msh_GetVariableNode(curr_seg_node), TRUE)));
+		mxSetCell(out, i, msh_WrapOutput(msh_GetOrCreateVariableNode(curr_seg_node), TRUE));
+	}
+	return out;
+}
+
+
+static mxArray* msh_CreateOutputNamed(void)
+{
+	size_t i;
+	int field_num, num_fields;
+	SegmentNode_T* curr_seg_node;
+	SharedVariableHeader_T* batch_header;
+	const char* curr_name;
+	mxArray* out = mxCreateStructMatrix(1, 1, 0, NULL);
+	for(i = 0, curr_seg_node = g_local_seg_list.first; i < g_local_seg_list.num_named && curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
+	{
+		if(msh_HasVariableName(curr_seg_node))
+		{
+			curr_name = msh_GetSegmentMetadata(curr_seg_node)->name;
+			if(!mxGetField(out, 0, curr_name))
+			{
+				mxAddField(out, curr_name);
+				mxSetField(out, 0, curr_name, msh_CreateNamedOutput(curr_name));
+			}
+			i += 1;
+		}
+		else if(msh_IsBatchSegment(curr_seg_node) && msh_GetClassID(batch_header = msh_GetSegmentData(curr_seg_node)) == mxSTRUCT_CLASS)
+		{
+			/* each entry of a named batch counts as a named variable */
+			num_fields = msh_GetNumFields(batch_header);
+			curr_name = msh_GetFieldNames(batch_header);
+			for(field_num = 0; field_num < num_fields; field_num++, curr_name += strlen(curr_name) + 1, i++)
+			{
+				if(!mxGetField(out, 0, curr_name))
+				{
+					mxAddField(out, curr_name);
+					mxSetField(out, 0, curr_name, msh_CreateNamedOutput(curr_name));
+				}
+			}
+		}
+	}
+	return out;
+}
+
+
+static mxArray* msh_CreateNamedOutput(const char_T* name)
+{
+	size_t i;
+	SegmentTableEntry_T* first_entry, * curr_entry;
+	SegmentNode_T* curr_seg_node;
+	VariableNode_T* curr_var_node;
+	mxArray* named_var_ret;
+	
+	/* the matches reference the tracked segment nodes, so they are used in place */
+	first_entry = msh_FindTableEntry(g_local_seg_list.name_table, NULL, (void*)name);
+	named_var_ret = mxCreateCellMatrix(msh_CountTableEntries(first_entry, name), (size_t)(first_entry != NULL));
+	for(i = 0, curr_entry = first_entry; curr_entry != NULL; i++, curr_entry = msh_FindTableEntry(g_local_seg_list.name_table, curr_entry, (void*)name))
+	{
+		curr_seg_node = curr_entry->seg_node;
+		if(msh_IsBatchSegment(curr_seg_node))
+		{
+			/* entries of a batch are passed back as sub-variables; these are not new variables, so
+			 * they are kept out of the '-w' output, which is built from the nodes created by the fetch */
+			curr_var_node = msh_CreateSubVariable(curr_seg_node, msh_GetEntryHeader(curr_seg_node, name));
+			msh_AddVariableToList(&g_local_var_list, curr_var_node);
+		}
+		else
+		{
+			curr_var_node = msh_GetOrCreateVariableNode(curr_seg_node);
+		}
+		mxSetCell(named_var_ret, i, msh_WrapOutput(curr_var_node, TRUE));
+	}
+	return named_var_ret;
+}
+
+
+static mxArray* msh_CreateSubscriptedOutput(const char_T* name, const mxArray* subs_struct)
+{
+	size_t i, num_segs;
+	SegmentTableEntry_T* first_entry, * curr_entry;
+	SegmentNode_T** seg_nodes;
+	SharedVariableHeader_T** sub_headers;
+	VariableNode_T* new_var_node;
+	mxArray* subscripted_ret;
+	
+	first_entry = msh_FindTableEntry(g_local_seg_list.name_table, NULL, (void*)name);
+	num_segs = msh_CountTableEntries(first_entry, name);
+	seg_nodes = mxMalloc((num_segs > 0? num_segs : 1)*sizeof(SegmentNode_T*));
+	sub_headers = mxMalloc((num_segs > 0? num_segs : 1)*sizeof(SharedVariableHeader_T*));
+	
+	/* resolve all of the subscripts before creating any variables in case they are invalid */
+	for(i = 0, curr_entry = first_entry; curr_entry != NULL; i++, curr_entry = msh_FindTableEntry(g_local_seg_list.name_table, curr_entry, (void*)name))
+	{
+		seg_nodes[i] = curr_entry->seg_node;
+		sub_headers[i] = msh_GetSubscriptedHeader(msh_GetEntryHeader(seg_nodes[i], name), subs_struct);
+	}
+	
+	subscripted_ret = mxCreateCellMatrix(num_segs, (size_t)(num_segs > 0));
+	for(i = 0; i < num_segs; i++)
+	{
+		new_var_node = msh_CreateSubVariable(seg_nodes[i], sub_headers[i]);
+		msh_AddVariableToList(&g_local_var_list, new_var_node);
+		mxSetCell(subscripted_ret, i, msh_WrapOutput(new_var_node, TRUE));
+	}
+	
+	mxFree(seg_nodes);
+	mxFree(sub_headers);
+	
+	return subscripted_ret;
+}
+
+
+static size_t msh_CountTableEntries(SegmentTableEntry_T* first_entry, const char_T* name)
+{
+	size_t num_matches;
+	SegmentTableEntry_T* curr_entry;
+	for(num_matches = 0, curr_entry = first_entry; curr_entry != NULL; num_matches++)
+	{
+		curr_entry = msh_FindTableEntry(g_local_seg_list.name_table, curr_entry, (void*)name);
+	}
+	return num_matches;
+}
+
+
+static SharedVariableHeader_T* msh_GetEntryHeader(SegmentNode_T* seg_node, const char_T* name)
+{
+	SharedVariableHeader_T* entry_header = msh_GetSegmentData(seg_node);
+	if(msh_IsBatchSegment(seg_node) && (entry_header = msh_GetFieldHeader(entry_header, name)) == NULL)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "BatchEntryError", "Could not find the entry '%s' in the batch.", name);
+	}
+	return entry_header;
+}
+
+
+static SegmentNode_T* msh_FindDuplicateSegment(const mxArray* in_var, size_t data_size, uint32_T content_hash, const mxArray* input_id, int will_persist)
+{
+	SegmentNode_T*     curr_seg_node;
+	SegmentMetadata_T* curr_metadata;
+	char_T             input_name[MSH_NAME_LEN_MAX] = {0};
+	
+	if(input_id != NULL && (!mxIsChar(input_id) || mxGetString(input_id, input_name, sizeof(input_name)) != 0))
+	{
+		/* let segment creation report the invalid name */
+		return NULL;
+	}
+	
+	/* the segment metadata acts as the content index, so make sure we are tracking everything */
+	msh_UpdateAllSegments(&g_local_seg_list);
+	
+	for(curr_seg_node = g_local_seg_list.first; curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
+	{
+		curr_metadata = msh_GetSegmentMetadata(curr_seg_node);
+		if(curr_metadata->has_content_hash
+		   && curr_metadata->content_hash == content_hash
+		   && (curr_metadata->is_compressed? curr_metadata->uncompressed_size : curr_metadata->data_size) == data_size
+		   && !curr_metadata->is_invalid
+		   && (curr_metadata->is_persistent != 0) == (will_persist != 0)
+		   && strcmp(curr_metadata->name, input_name) == 0
+		   && msh_CompareVariableContent(msh_GetSegmentData(curr_seg_node), in_var))
+		{
+			return curr_seg_node;
+		}
+	}
+	
+	return NULL;
+}
+
+
+static SegmentNode_T* msh_CreateBatchSegment(const mxArray** in_vars, size_t num_vars, int with_names, int will_persist)
+{
+	size_t         i, data_size;
+	char_T*        entry_names;
+	const char_T** field_names;
+	const char_T** sorted_names;
+	mxArray*       batch_var;
+	SegmentNode_T* new_seg_node;
+	
+	/* check the inputs first so that errors aren't raised while they are borrowed by batch_var */
+	for(i = 0; i < num_vars; i++)
+	{
+		msh_FindSharedSize(with_names? in_vars[2*i + 1] : in_vars[i]);
+	}
+	
+	if(with_names)
+	{
+		entry_names = mxMalloc((num_vars > 0? num_vars : 1)*MSH_NAME_LEN_MAX*sizeof(char_T));
+		field_names = mxMalloc((num_vars > 0? num_vars : 1)*sizeof(const char_T*));
+		sorted_names = mxMalloc((num_vars > 0? num_vars : 1)*sizeof(const char_T*));
+		for(i = 0; i < num_vars; i++)
+		{
+			msh_CheckVarname(in_vars[2*i]);
+			mxGetString(in_vars[2*i], entry_names + i*MSH_NAME_LEN_MAX, MSH_NAME_LEN_MAX);
+			field_names[i] = sorted_names[i] = entry_names + i*MSH_NAME_LEN_MAX;
+		}
+		
+		/* sort a copy of the names to find duplicates rather than looking up each field in turn */
+		qsort((void*)sorted_names, num_vars, sizeof(const char_T*), msh_CompareEntryNames);
+		for(i = 1; i < num_vars; i++)
+		{
+			if(strcmp(sorted_names[i - 1], sorted_names[i]) == 0)
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "DuplicateNameError", "The name '%s' was specified more than once in the batch.", sorted_names[i]);
+			}
+		}
+		
+		/* the fields are created in input order so that field i holds input i */
+		if((batch_var = mxCreateStructMatrix(1, 1, (int)num_vars, field_names)) == NULL)
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidNameError", "Could not use the names as batch entry names.");
+		}
+		
+		mxFree((void*)sorted_names);
+		mxFree((void*)field_names);
+		mxFree(entry_names);
+	}
+	else
+	{
+		batch_var = mxCreateCellMatrix(1, num_vars);
+	}
+	
+	/* the inputs are borrowed rather than duplicated, so they must be unset before anything can fail */
+	msh_SetBatchEntries(batch_var, in_vars, num_vars, with_names, TRUE);
+	data_size = msh_FindSharedSize(batch_var);
+	msh_SetBatchEntries(batch_var, in_vars, num_vars, with_names, FALSE);
+	
+	new_seg_node = msh_CreateSegment(data_size, NULL, will_persist);
+	msh_GetSegmentMetadata(new_seg_node)->is_batch = TRUE;
+	
+	msh_SetBatchEntries(batch_var, in_vars, num_vars, with_names, TRUE);
+	msh_CopyVariable(msh_GetSegmentData(new_seg_node), batch_var);
+	msh_SetBatchEntries(batch_var, in_vars, num_vars, with_names, FALSE);
+	
+	mxDestroyArray(batch_var);
+	
+	return new_seg_node;
+}
+
+
+static void msh_SetBatchEntries(mxArray* batch_var, const mxArray** in_vars, size_t num_vars, int with_names, int will_set)
+{
+	size_t i;
+	for(i = 0; i < num_vars; i++)
+	{
+		if(with_names)
+		{
+			mxSetFieldByNumber(batch_var, 0, (int)i, will_set? (mxArray*)in_vars[2*i + 1] : NULL);
+		}
+		else
+		{
+			mxSetCell(batch_var, i, will_set? (mxArray*)in_vars[i] : NULL);
+		}
+	}
+}
+
+
+static int msh_CompareEntryNames(const void* a, const void* b)
+{
+	return strcmp(*(const char_T* const*)a, *(const char_T* const*)b);
+}
+
+
+static int msh_IsBlockOption(const mxArray* in_arg)
+{
+	char_T opt_str[7];
+	return mxIsChar(in_arg) && mxGetNumberOfElements(in_arg) == 6 && mxGetString(in_arg, opt_str, sizeof(opt_str)) == 0 && strcmp(opt_str, "-block") == 0;
+}
+
+
+static size_t msh_GetPositiveIntegerOption(const mxArray* in_arg)
+{
+	double opt_val;
+	
+	/* SIZE_MAX + 1 exactly; (double)SIZE_MAX rounds up to this on 64-bit */
+	double size_bound = (double)(SIZE_MAX/2 + 1)*2.0;
+	
+	if(!mxIsNumeric(in_arg) || mxIsComplex(in_arg) || mxGetNumberOfElements(in_arg) != 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidOptionError", "Expected a positive integer scalar option value.");
+	}
+	
+	opt_val = mxGetScalar(in_arg);
+	if(!(opt_val >= 1) || opt_val >= size_bound || opt_val != (double)(size_t)opt_val)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidOptionError", "Expected a positive integer scalar option value.");
+	}
+	
+	return (size_t)opt_val;
+}
+
+
+static mxClassID msh_GetClassOption(const mxArray* in_arg)
+{
+	mxClassID class_id;
+	char_T    class_name[MSH_NAME_LEN_MAX];
+	
+	if(!mxIsChar(in_arg) || mxGetString(in_arg, class_name, MSH_NAME_LEN_MAX) != 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidClassError", "The class must be specified as a character vector.");
+	}
+	
+	if((class_id = mxClassIDFromClassName(class_name)) == mxUNKNOWN_CLASS)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidClassError", "Unrecognized class '%s'.", class_name);
+	}
+	
+	return class_id;
+}
+
+
+static mwSize* msh_GetDimensionsOption(const mxArray* in_arg, size_t* num_dims)
+{
+	size_t  i;
+	double  dim_bound;
+	double* in_dims;
+	mwSize* dims;
+	
+	if(!mxIsDouble(in_arg) || mxIsComplex(in_arg) || mxIsSparse(in_arg) || mxGetNumberOfElements(in_arg) < 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidDimensionsError", "The dimensions must be a non-empty, real, full double vector.");
+	}
+	
+	/* (double)MWSIZE_MAX rounds up to a power of two, so compare against that power exactly */
+	dim_bound = (double)(MWSIZE_MAX/2 + 1)*2.0;
+	
+	in_dims = mxGetData(in_arg);
+	*num_dims = mxGetNumberOfElements(in_arg);
+	for(i = 0; i < *num_dims; i++)
+	{
+		if(!(in_dims[i] >= 0) || in_dims[i] >= dim_bound || in_dims[i] != (double)(mwSize)in_dims[i])
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidDimensionsError", "The dimensions must be finite non-negative integers.");
+		}
+	}
+	
+	dims = mxMalloc((*num_dims < 2? 2 : *num_dims)*sizeof(mwSize));
+	for(i = 0; i < *num_dims; i++)
+	{
+		dims[i] = (mwSize)in_dims[i];
+	}
+	if(*num_dims < 2)
+	{
+		dims[1] = dims[0];
+		*num_dims = 2;
 	}
-	return out;
+	
+	return dims;
 }
 
 
-static mxArray* msh_CreateOutputNamed(void)
+static mxArray* msh_WrapOutput(VariableNode_T* var_node, int will_set_used)
 {
-	size_t i;
-	SegmentNode_T* curr_seg_node;
-	const char* curr_name;
-	mxArray* out = mxCreateStructMatrix(1, 1, 0, NULL);
-	for(i = 0, curr_seg_node = g_local_seg_list.first; i < g_local_seg_list.num_named && curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
+	SegmentNode_T* seg_node = msh_GetSegmentNode(var_node);
+	mxArray* output = mxCreateCellMatrix(1, 2);
+	mxSetCell(output, 0, msh_CreateSharedDataCopy(var_node, will_set_used));
+	if(seg_node != NULL)
 	{
-		if(msh_HasVariableName(curr_seg_node))
-		{
-			curr_name = msh_GetSegmentMetadata(curr_seg_node)->name;
-			if(!mxGetField(out, 0, curr_name))
-			{
-				mxAddField(out, curr_name);
-				mxSetField(out, 0, curr_name, msh_CreateNamedOutput(curr_name));
-			}
-			i += 1;
-		}
+		mxSetCell(output, 1, msh_CreateSegmentHandle(seg_node, msh_GetVariableNode(seg_node) == var_node));
 	}
-	return out;
+	return output;
 }
 
 
-static mxArray* msh_CreateNamedOutput(const char_T* name)
+static SegmentNode_T* msh_FindWrappedSegmentNode(const mxArray* wrapped_var, int* is_primary)
 {
-	size_t i;
-	SegmentList_T named_var_list;
-	mxArray* named_var_ret;
+	SegmentNode_T* seg_node;
+	const mxArray* wrapped_data, * curr_link;
 	
-	msh_FindAllSegmentNodes(g_local_seg_list.name_table, &named_var_list, (void*)name);
-	named_var_ret = mxCreateCellMatrix(named_var_list.num_segs, (size_t)(named_var_list.num_segs > 0));
-	for(i = 0; named_var_list.first != NULL; i++)
+	if(mxGetNumberOfElements(wrapped_var) > 1 && (seg_node = msh_FindSegmentNodeFromHandle(g_local_seg_list.seg_table, mxGetCell(wrapped_var, 1), is_primary)) != NULL)
 	{
-		mxSetCell(named_var_ret, i, msh_WrapOutput(msh_CreateSharedDataCopy(msh_GetVariableNode(named_var_list.first), TRUE)));
-		msh_DestroySegmentNode(msh_RemoveSegmentFromList(named_var_list.first));
+		return seg_node;
 	}
-	return named_var_ret;
-}
-
-
-static mxArray* msh_WrapOutput(mxArray* shared_data_copy)
-{
-	mxArray* output = mxCreateCellMatrix(1, 1);
-	mxSetCell(output, 0, shared_data_copy);
-	return output;
+	
+	/* otherwise walk the crosslinks */
+	wrapped_data = mxGetCell(wrapped_var, 0);
+	if((seg_node = msh_FindSegmentNodeFromCrosslink(g_local_var_list.mvar_table, wrapped_data)) != NULL && is_primary != NULL)
+	{
+		*is_primary = FALSE;
+		if(msh_GetVariableNode(seg_node) != NULL)
+		{
+			curr_link = wrapped_data;
+			do
+			{
+				if(curr_link == msh_GetVariableData(msh_GetVariableNode(seg_node)))
+				{
+					*is_primary = TRUE;
+					break;
+				}
+				curr_link = met_GetCrosslink(curr_link);
+			} while(curr_link != NULL && curr_link != wrapped_data);
+		}
+	}
+	
+	return seg_node;
 }
 
 
@@ -868,11 +2047,8 @@ void msh_Copy(int nlhs, mxArray** plhs, int num_inputs, const mxArray** in_vars)
 void msh_Clear(int num_inputs, const mxArray** in_vars)
 {
 	SegmentNode_T* clear_seg_node;
-	VariableNode_T* curr_var_node;
-	mxArray* link;
-	const mxArray* clear_var, * curr_in_var;
+	const mxArray* curr_in_var;
 	char input_str[MSH_NAME_LEN_MAX];
-	bool_T found_variable;
 	int input_num;
 	
 	msh_AcquireProcessLock(g_process_lock);
@@ -886,24 +2062,11 @@ void msh_Clear(int num_inputs, const mxArray** in_vars)
 			curr_in_var = in_vars[input_num];
 			if(mxIsCell(curr_in_var))
 			{
-				clear_var = mxGetCell(curr_in_var, 0);
-				for(curr_var_node = g_local_var_list.first, found_variable = FALSE; curr_var_node != NULL && !found_variable; curr_var_node = msh_GetNextVariable(curr_var_node))
+				if((clear_seg_node = msh_FindWrappedSegmentNode(curr_in_var, NULL)) != NULL)
 				{
-					/* begin hack */
-					link = msh_GetVariableData(curr_var_node);
-					do
-					{
-						if(link == clear_var)
-						{
-							msh_RemoveSegmentFromSharedList(msh_GetSegmentNode(curr_var_node));
-							msh_RemoveSegmentFromList(msh_GetSegmentNode(curr_var_node));
-							msh_DetachSegment(msh_GetSegmentNode(curr_var_node));
-							found_variable = TRUE;
-							break;
-						}
-						link = met_GetCrosslink(link);
-					} while(link != NULL && link != msh_GetVariableData(curr_var_node));
-					/* end hack */
+					msh_RemoveSegmentFromSharedList(clear_seg_node);
+					msh_RemoveSegmentFromList(clear_seg_node);
+					msh_DetachSegment(clear_seg_node);
 				}
 			}
 			else if(mxIsChar(curr_in_var))
@@ -931,7 +2094,7 @@ void msh_Config(size_t num_params, const mxArray** in_params)
 {
 	size_t              i, j, ps_len, vs_len, maxsize_temp;
 	long                opts;
-	unsigned long       maxvars_temp;
+	unsigned long       maxvars_temp, numthreads_temp;
 	const mxArray*      param;
 	const mxArray*      val;
 	
@@ -1158,6 +2321,52 @@ void msh_Config(size_t num_params, const mxArray** in_params)
 				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidValueError", "Unrecognised value \"%s\" for parameter \"%s\".", val_str, MSH_PARAM_VAROP_OPTS_DEFAULT);
 			}
 		}
+		else if(strcmp(param_str_l, MSH_PARAM_EVICTION_POLICY_L) == 0 || strcmp(param_str_l, MSH_PARAM_EVICTION_POLICY_AB) == 0)
+		{
+			if(strcmp(val_str_l, "none") == 0)
+			{
+				g_user_config.eviction_policy = msh_EVICT_NONE;
+			}
+			else if(strcmp(val_str_l, "lru") == 0)
+			{
+				g_user_config.eviction_policy = msh_EVICT_LRU;
+			}
+			else if(strcmp(val_str_l, "size") == 0)
+			{
+				g_user_config.eviction_policy = msh_EVICT_SIZE;
+			}
+			else
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidValueError", "Unrecognised value \"%s\" for parameter \"%s\".", val_str, MSH_PARAM_EVICTION_POLICY);
+			}
+		}
+		else if(strcmp(param_str_l, MSH_PARAM_VAROP_THREADS_L) == 0 || strcmp(param_str_l, MSH_PARAM_VAROP_THREADS_AB) == 0)
+		{
+			if(strcmp(val_str_l, "auto") == 0)
+			{
+				g_user_config.varop_threads = 0;
+			}
+			else
+			{
+				/* this can't be negative */
+				if(val_str_l[0] == '-')
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "NegativeNumThreadsError", "The number of variable operation threads must be non-negative.");
+				}
+				
+				errno = 0;
+				numthreads_temp = strtoul(val_str_l, NULL, 0);
+				if(errno)
+				{
+					meu_PrintMexError(MEU_FL,
+					                  MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM | MEU_ERRNO,
+					                  "NumThreadsParsingError",
+					                  "There was an error parsing the value for the number of variable operation threads.");
+				}
+				
+				g_user_config.varop_threads = numthreads_temp;
+			}
+		}
 		else
 		{
 			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidParamError", "Unrecognised parameter \"%s\".", param_str);
@@ -1265,6 +2474,12 @@ void msh_VarOps(int nlhs, mxArray** plhs, int num_args, const mxArray** in_args,
 							opts &= ~MSH_USE_ATOMIC_OPS;
 							break;
 						}
+						case('o'):
+						{
+							/* return the old values */
+							opts |= MSH_RETURN_OLD_VALS;
+							break;
+						}
 						default:
 						{
 							/* normally the string produced here should be freed with mxFree, but since we have an error just let MATLAB do the GC */
@@ -1290,15 +2505,383 @@ void msh_VarOps(int nlhs, mxArray** plhs, int num_args, const mxArray** in_args,
 		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "TooManyOutputsError", "Too many outputs");
 	}
 	
-	if(opts & MSH_IS_SYNCHRONOUS)
+	if((shared_seg_node = msh_FindWrappedSegmentNode(in_args[0], NULL)) != NULL)
 	{
-		if((shared_seg_node = msh_FindSegmentNodeFromCrosslink(g_local_var_list.mvar_table, parent_var)) != NULL)
+		/* reductions only read the decompressed copy */
+		if(msh_GetSegmentMetadata(shared_seg_node)->is_compressed && !msh_IsReadOnlyVarOp(varop))
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "CompressedVariableError", "Compressed variables are read-only and cannot be operated on in-place.");
+		}
+		
+		if(opts & MSH_IS_SYNCHRONOUS)
 		{
 			filelock = msh_GetSegmentInfo(shared_seg_node)->lock;
 		}
 	}
 	
-	/* returns output only if requested to save time and memory */
-	msh_VariableOperation(parent_var, subs_struct, in_vars, num_in_vars, varop, opts, filelock, (nlhs==1)? plhs : NULL);
+	/* returns output only if requested to save time and memory, reductions always return their result */
+	msh_VariableOperation(parent_var, subs_struct, in_vars, num_in_vars, varop, opts, filelock, (nlhs == 1 || msh_IsReadOnlyVarOp(varop))? plhs : NULL);
+	
+}
+
+
+void msh_Overwrite(int nlhs, mxArray** plhs, int num_args, const mxArray** in_args)
+{
+	
+	/* input order (including arguments handled by mexFunction)
+	 *
+	 * 0. directive
+	 * 1. parent_var
+	 * 2. {in_var}
+	 * 3. {opt1, opt2, ...}
+	 */
+	
+	size_t                  i, num_varargin;
+	mxArray*                opt_input;
+	SegmentNode_T*          shared_seg_node;
+	SharedVariableHeader_T* shared_header;
+	const mxArray*          parent_var;
+	const mxArray*          in_var;
+	
+	mxChar*                 input_option    = NULL;
+	int                     is_primary;
+	int                     will_delta      = FALSE;
+	size_t                  num_changed;
+	long                    opts            = g_user_config.varop_opts_default;
+	
+	if(num_args != 3)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidNumberOfArgumentsError", "Too many or too few arguments. Please use the provided entry functions.");
+	}
+	
+	if(!mxIsCell(in_args[1]) || mxGetNumberOfElements(in_args[1]) != 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "InvalidInputTypeError", "Expected a single element cell input for in_var.");
+	}
+	
+	parent_var = mxGetCell(in_args[0], 0);
+	in_var = mxGetCell(in_args[1], 0);
+	
+	for(i = 0, num_varargin = mxGetNumberOfElements(in_args[2]); i < num_varargin; i++)
+	{
+		opt_input = mxGetCell(in_args[2], i);
+		if(!mxIsChar(opt_input) || mxGetNumberOfElements(opt_input) < 2 || (input_option = mxGetChars(opt_input))[0] != '-')
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidOptionError", "Options must be character vectors of length more than 1 starting with '-'.");
+		}
+		
+		switch(input_option[1])
+		{
+			case('s'):
+			{
+				opts |= MSH_IS_SYNCHRONOUS;
+				break;
+			}
+			case('a'):
+			{
+				opts &= ~MSH_IS_SYNCHRONOUS;
+				break;
+			}
+			case('t'):
+			{
+				opts |= MSH_USE_ATOMIC_OPS;
+				break;
+			}
+			case('n'):
+			{
+				opts &= ~MSH_USE_ATOMIC_OPS;
+				break;
+			}
+			case('d'):
+			{
+				will_delta = TRUE;
+				break;
+			}
+			default:
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "UnrecognizedOptionError", "Unrecognized option.");
+			}
+		}
+	}
+	
+	if(nlhs > (will_delta? 3 : 1))
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "TooManyOutputsError", "Too many outputs");
+	}
+	
+	if((shared_seg_node = msh_FindWrappedSegmentNode(in_args[0], &is_primary)) == NULL)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "VariableNotFoundError", "Could not find the shared variable to overwrite.");
+	}
+	
+	if(msh_GetSegmentMetadata(shared_seg_node)->is_compressed)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "CompressedVariableError", "Compressed variables are read-only and cannot be overwritten.");
+	}
+	
+	shared_header = msh_GetSegmentData(shared_seg_node);
+	
+	/* element-wise atomics, class conversions, and subtrees are handled by the generic runner */
+	if(!is_primary || (opts & MSH_USE_ATOMIC_OPS) || !msh_CompareHeaderSize(shared_header, in_var))
+	{
+		if(will_delta)
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "DeltaOverwriteError", "Delta overwrites require a whole shared variable, an input of the same class and size, and no atomic operations.");
+		}
+		msh_VariableOperation(parent_var, NULL, in_args[1], 1, VAROP_CPY, opts, msh_GetSegmentInfo(shared_seg_node)->lock, (nlhs == 1)? plhs : NULL);
+		return;
+	}
+	
+	if(opts & MSH_IS_SYNCHRONOUS) msh_AcquireProcessLock(msh_GetSegmentInfo(shared_seg_node)->lock);
+	
+	if(will_delta)
+	{
+		/* only blocks which differ are written so unchanged pages are not dirtied for readers */
+		if((num_changed = msh_OverwriteHeaderDelta(shared_header, in_var)) > 0)
+		{
+			msh_AtomicIncrement(&msh_GetSegmentMetadata(shared_seg_node)->data_version);
+		}
+	}
+	else
+	{
+		msh_OverwriteHeader(shared_header, in_var);
+	}
+	
+	if(opts & MSH_IS_SYNCHRONOUS) msh_ReleaseProcessLock(msh_GetSegmentInfo(shared_seg_node)->lock);
+	
+	if(will_delta)
+	{
+		/* the copy of the data comes last so that the counts can be had without copying the whole variable */
+		if(nlhs >= 1)
+		{
+			plhs[0] = mxCreateDoubleScalar((double)num_changed);
+		}
+		if(nlhs >= 2)
+		{
+			plhs[1] = mxCreateDoubleScalar((double)msh_GetSegmentMetadata(shared_seg_node)->data_version);
+		}
+		if(nlhs == 3)
+		{
+			plhs[2] = mxDuplicateArray(parent_var);
+		}
+	}
+	else if(nlhs >= 1)
+	{
+		plhs[0] = mxDuplicateArray(parent_var);
+	}
+	
+}
+
+
+void msh_Snapshot(int num_args, const mxArray** in_args)
+{
+	FILE*              snapshot_file;
+	SnapshotHeader_T   snapshot_header;
+	SnapshotRecord_T   snapshot_record;
+	SegmentNode_T*     curr_seg_node;
+	SegmentMetadata_T* curr_metadata;
+	
+	if(num_args != 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidNumberOfArgumentsError", "A single file name must be supplied.");
+	}
+	
+	/* hold the lock so that the snapshot is consistent */
+	msh_AcquireProcessLock(g_process_lock);
+	
+	msh_UpdateAllSegments(&g_local_seg_list);
+	
+	memset(&snapshot_header, 0, sizeof(SnapshotHeader_T));
+	memcpy(snapshot_header.magic, MSH_SNAPSHOT_MAGIC, sizeof(MSH_SNAPSHOT_MAGIC));
+	snapshot_header.version = MSH_SNAPSHOT_VERSION;
+	snapshot_header.bitness = MSH_BITNESS;
+	for(curr_seg_node = g_local_seg_list.first; curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
+	{
+		if(!msh_GetSegmentMetadata(curr_seg_node)->is_invalid)
+		{
+			snapshot_header.num_segments += 1;
+		}
+	}
+	
+	snapshot_file = msh_OpenSnapshotFile(in_args[0], "wb");
+	
+	if(!msh_WriteSnapshotChunk(snapshot_file, &snapshot_header, sizeof(SnapshotHeader_T)))
+	{
+		fclose(snapshot_file);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM | MEU_ERRNO, "SnapshotWriteError", "Could not write to the snapshot file.");
+	}
+	
+	for(curr_seg_node = g_local_seg_list.first; curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
+	{
+		curr_metadata = msh_GetSegmentMetadata(curr_seg_node);
+		if(curr_metadata->is_invalid)
+		{
+			continue;
+		}
+		
+		memset(&snapshot_record, 0, sizeof(SnapshotRecord_T));
+		memcpy(snapshot_record.name, curr_metadata->name, sizeof(snapshot_record.name));
+		snapshot_record.data_size         = curr_metadata->data_size;
+		snapshot_record.uncompressed_size = curr_metadata->uncompressed_size;
+		snapshot_record.file_size         = curr_metadata->file_size;
+		snapshot_record.file_path_offset  = curr_metadata->file_path_offset;
+		snapshot_record.content_hash      = curr_metadata->content_hash;
+		snapshot_record.is_persistent     = curr_metadata->is_persistent;
+		snapshot_record.has_content_hash  = curr_metadata->has_content_hash;
+		snapshot_record.is_compressed     = curr_metadata->is_compressed;
+		snapshot_record.is_batch          = curr_metadata->is_batch;
+		
+		/* the data is written as stored, so compressed segments stay compressed and mapped files are not copied */
+		if(!msh_WriteSnapshotChunk(snapshot_file, &snapshot_record, sizeof(SnapshotRecord_T))
+		   || !msh_WriteSnapshotChunk(snapshot_file, msh_GetSegmentRawData(curr_seg_node), curr_metadata->data_size))
+		{
+			fclose(snapshot_file);
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM | MEU_ERRNO, "SnapshotWriteError", "Could not write to the snapshot file.");
+		}
+	}
+	
+	msh_ReleaseProcessLock(g_process_lock);
+	
+	if(fclose(snapshot_file) != 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM | MEU_ERRNO, "SnapshotWriteError", "Could not close the snapshot file.");
+	}
+	
+}
+
+
+void msh_Restore(int nlhs, mxArray** plhs, int num_args, const mxArray** in_args)
+{
+	size_t             i;
+	FILE*              snapshot_file;
+	SnapshotHeader_T   snapshot_header;
+	SnapshotRecord_T   snapshot_record;
+	SegmentNode_T*     new_seg_node;
+	SegmentMetadata_T* new_metadata;
+	
+	if(num_args != 1)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidNumberOfArgumentsError", "A single file name must be supplied.");
+	}
+	
+	snapshot_file = msh_OpenSnapshotFile(in_args[0], "rb");
+	
+	if(!msh_ReadSnapshotChunk(snapshot_file, &snapshot_header, sizeof(SnapshotHeader_T))
+	   || memcmp(snapshot_header.magic, MSH_SNAPSHOT_MAGIC, sizeof(MSH_SNAPSHOT_MAGIC)) != 0)
+	{
+		fclose(snapshot_file);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "SnapshotFormatError", "The file is not a matshare snapshot.");
+	}
+	
+	if(snapshot_header.version != MSH_SNAPSHOT_VERSION || snapshot_header.bitness != MSH_BITNESS)
+	{
+		fclose(snapshot_file);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "SnapshotVersionError", "The snapshot was written by an incompatible version or build of matshare.");
+	}
+	
+	for(i = 0; i < snapshot_header.num_segments; i++)
+	{
+		if(!msh_ReadSnapshotChunk(snapshot_file, &snapshot_record, sizeof(SnapshotRecord_T)))
+		{
+			fclose(snapshot_file);
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "SnapshotFormatError", "The snapshot file is truncated.");
+		}
+		
+		/* read the data straight into the new segment */
+		new_seg_node = msh_CreateSegment(snapshot_record.data_size, NULL, snapshot_record.is_persistent);
+		if(!msh_ReadSnapshotChunk(snapshot_file, msh_GetSegmentRawData(new_seg_node), snapshot_record.data_size))
+		{
+			msh_DetachSegment(new_seg_node);
+			fclose(snapshot_file);
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "SnapshotFormatError", "The snapshot file is truncated.");
+		}
+		
+		/* the name is set directly since it was already validated when first shared */
+		new_metadata = msh_GetSegmentMetadata(new_seg_node);
+		snapshot_record.name[MSH_NAME_LEN_MAX - 1] = '\0';
+		memcpy(new_metadata->name, snapshot_record.name, sizeof(new_metadata->name));
+		new_metadata->content_hash      = snapshot_record.content_hash;
+		new_metadata->has_content_hash  = snapshot_record.has_content_hash;
+		new_metadata->uncompressed_size = snapshot_record.uncompressed_size;
+		new_metadata->is_compressed     = snapshot_record.is_compressed;
+		new_metadata->is_batch          = snapshot_record.is_batch;
+		
+		/* variables mapped from files are mapped from the same file again */
+		if(snapshot_record.file_size > 0)
+		{
+			msh_SetSegmentFile(new_seg_node, snapshot_record.file_path_offset, snapshot_record.file_size);
+		}
+		
+		if(new_metadata->is_compressed)
+		{
+			msh_AtomicIncrement(&g_shared_info->num_compressed_segments);
+			msh_AtomicAddSizeWithMax(&g_shared_info->total_compressed_size, new_metadata->data_size, SIZE_MAX);
+			msh_AtomicAddSizeWithMax(&g_shared_info->total_uncompressed_size, new_metadata->uncompressed_size, SIZE_MAX);
+		}
+		
+		msh_AddSegmentToList(&g_local_seg_list, new_seg_node);
+		msh_AddSegmentToSharedList(new_seg_node);
+	}
+	
+	fclose(snapshot_file);
 	
+	if(nlhs > 0)
+	{
+		plhs[0] = mxCreateDoubleScalar((double)snapshot_header.num_segments);
+	}
+	
+}
+
+
+static FILE* msh_OpenSnapshotFile(const mxArray* in_file_name, const char* mode)
+{
+	FILE*   snapshot_file;
+	char_T* file_name;
+	
+	if(!mxIsChar(in_file_name) || mxIsEmpty(in_file_name))
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "InvalidFileNameError", "The file name must be a non-empty character vector.");
+	}
+	
+	file_name = mxArrayToString(in_file_name);
+	if((snapshot_file = fopen(file_name, mode)) == NULL)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM | MEU_ERRNO, "FileOpenError", "Could not open the file '%s'.", file_name);
+	}
+	mxFree(file_name);
+	
+	return snapshot_file;
+}
+
+
+static int msh_WriteSnapshotChunk(FILE* snapshot_file, const void* chunk, size_t chunk_size)
+{
+	static const byte_T padding[MSH_ALIGNMENT] = {0};
+	size_t padding_size = msh_PadToAlignData(chunk_size) - chunk_size;
+	return fwrite(chunk, 1, chunk_size, snapshot_file) == chunk_size
+	       && fwrite(padding, 1, padding_size, snapshot_file) == padding_size;
+}
+
+
+static int msh_ReadSnapshotChunk(FILE* snapshot_file, void* chunk, size_t chunk_size)
+{
+	byte_T padding[MSH_ALIGNMENT];
+	size_t padding_size = msh_PadToAlignData(chunk_size) - chunk_size;
+	return fread(chunk, 1, chunk_size, snapshot_file) == chunk_size
+	       && fread(padding, 1, padding_size, snapshot_file) == padding_size;
+}
+
+
+static void msh_CloseFiles(handle_T* file_handles, size_t num_files)
+{
+	size_t i;
+	for(i = 0; i < num_files; i++)
+	{
+#ifdef MSH_WIN
+		CloseHandle(file_handles[i]);
+#else
+		close(file_handles[i]);
+#endif
+	}
+	mxFree(file_handles);
 }
@@ -19,6 +19,8 @@
 #include "mshvariables.h"
 #include "mshtable.h"
 #include "mshlockfree.h"
+#include "mshpool.h"
+#include "mshprocs.h"
 
 #ifdef MSH_UNIX
 #  include <unistd.h>
@@ -97,6 +99,9 @@ void msh_InitializeMatshare(void)
 		msh_InitializeTable(g_local_var_list.mvar_table);
 	}
 	
+	/* this may reap dead processes, so the tables need to be ready */
+	msh_AcquireProcessSlot();
+	
 	g_local_info.is_initialized = TRUE;
 	
 	/* init == TRUE, deinit == FALSE */
@@ -271,9 +276,12 @@ void msh_OnExit(void)
 	/* init == FALSE, deinit == FALSE */
 	
 	msh_DetachSegmentList(&g_local_seg_list);
+	msh_ReleaseProcessSlot();
 	msh_DestroyTable(g_local_seg_list.seg_table);
 	msh_DestroyTable(g_local_seg_list.name_table);
 	msh_DestroyTable(g_local_var_list.mvar_table);
+	msh_DestroyNodePool(&g_seg_node_pool);
+	msh_DestroyNodePool(&g_var_node_pool);
 	
 	if(g_local_info.shared_info_wrapper.ptr != NULL)
 	{
@@ -326,6 +334,9 @@ void msh_OnExit(void)
 	/* make sure this is reset so there aren't any collisions with the shared state */
 	g_local_info.rev_num  = MSH_INITIAL_STATE;
 	
+	/* the shared revision number restarts on the next init, so a stale value here could skip a needed clean */
+	g_local_seg_list.clean_rev_num = MSH_INITIAL_STATE;
+	
 	g_local_info.is_deinitialized = TRUE;
 	
 	/* init == FALSE, deinit == TRUE */
@@ -345,6 +356,8 @@ void msh_SetDefaultConfiguration(UserConfig_T* user_config)
 	user_config->fetch_default[MSH_NAME_LEN_MAX-1] = '\0';
 	user_config->varop_opts_default = MSH_DEFAULT_VAROP_OPTS_DEFAULT;
 	user_config->version = MSH_VERSION_NUM;
+	user_config->eviction_policy = MSH_DEFAULT_EVICTION_POLICY;
+	user_config->varop_threads = MSH_DEFAULT_VAROP_THREADS;
 }
 
 
@@ -450,6 +450,74 @@ double VO_FCN_CASNAME(Double)(volatile double* dest, double comp_val, double set
 #endif
 }
 
+
+#define ATOMIC_CX_INT_DEF(TYPE, TYPEN) \
+bool_T VO_FCN_CXNAME(TYPEN)(volatile TYPE* dest, TYPE* expected, TYPE set_val) \
+{ \
+	TYPE prev_val = VO_FCN_CASNAME(TYPEN)(dest, *expected, set_val); \
+	if(prev_val == *expected) \
+	{ \
+		return TRUE; \
+	} \
+	*expected = prev_val; \
+	return FALSE; \
+}
+
+ATOMIC_CX_INT_DEF(int8_T, Int8)
+ATOMIC_CX_INT_DEF(int16_T, Int16)
+ATOMIC_CX_INT_DEF(int32_T, Int32)
+ATOMIC_CX_INT_DEF(int64_T, Int64)
+
+ATOMIC_CX_INT_DEF(uint8_T, UInt8)
+ATOMIC_CX_INT_DEF(uint16_T, UInt16)
+ATOMIC_CX_INT_DEF(uint32_T, UInt32)
+ATOMIC_CX_INT_DEF(uint64_T, UInt64)
+
+
+bool_T VO_FCN_CXNAME(Single)(volatile single* dest, single* expected, single set_val)
+{
+	/* exchange the bit patterns, since a NaN never compares equal to itself */
+	union singlepun_T
+	{
+		single val;
+		int32_T as_int;
+	};
+	
+	union singlepun_T prev_val;
+	union singlepun_T comp_val_pun = {*expected};
+	union singlepun_T set_val_pun = {set_val};
+	
+	prev_val.as_int = VO_FCN_CASNAME(Int32)((volatile int32_T*)dest, comp_val_pun.as_int, set_val_pun.as_int);
+	if(prev_val.as_int == comp_val_pun.as_int)
+	{
+		return TRUE;
+	}
+	*expected = prev_val.val;
+	return FALSE;
+}
+
+
+bool_T VO_FCN_CXNAME(Double)(volatile double* dest, double* expected, double set_val)
+{
+	union doublepun_T
+	{
+		double val;
+		int64_T as_int;
+	};
+	
+	union doublepun_T prev_val;
+	union doublepun_T comp_val_pun = {*expected};
+	union doublepun_T set_val_pun = {set_val};
+	
+	prev_val.as_int = VO_FCN_CASNAME(Int64)((volatile int64_T*)dest, comp_val_pun.as_int, set_val_pun.as_int);
+	if(prev_val.as_int == comp_val_pun.as_int)
+	{
+		return TRUE;
+	}
+	*expected = prev_val.val;
+	return FALSE;
+}
+
 int8_T VO_FCN_SNAME(Int8)(volatile int8_T* dest, int8_T set_val)
 {
 #ifdef MSH_WIN
@@ -670,3 +738,53 @@ double VO_FCN_SNAME(Double)(volatile double* dest, double set_val)
 	return old_val;
 #endif
 }
+
+
+/* the bitwise operations have native locked instructions, except for 64 bit integers on 32 bit Windows */
+#if defined(MSH_WIN) && defined(_MSC_VER)
+#  define ATOMIC_FETCH_OP_DEF(NAME, TYPE, WIN_TYPE, WIN_FCN, GNU_FCN) \
+TYPE NAME(volatile TYPE* dest, TYPE val) \
+{ \
+	return (TYPE)WIN_FCN((volatile WIN_TYPE*)dest, (WIN_TYPE)val); \
+}
+#else
+#  define ATOMIC_FETCH_OP_DEF(NAME, TYPE, WIN_TYPE, WIN_FCN, GNU_FCN) \
+TYPE NAME(volatile TYPE* dest, TYPE val) \
+{ \
+	return GNU_FCN(dest, val); \
+}
+#endif
+
+#define ATOMIC_FETCH_OP_CX_DEF(NAME, TYPE, TYPEN, OPERATOR) \
+TYPE NAME(volatile TYPE* dest, TYPE val) \
+{ \
+	TYPE old_val = *dest; \
+	while(!VO_FCN_CXNAME(TYPEN)(dest, &old_val, (TYPE)(old_val OPERATOR val))); \
+	return old_val; \
+}
+
+#define ATOMIC_FETCH_OP_METADEF(OPNAME, WIN_OPNAME, GNU_OPNAME, OPERATOR) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##Int8, int8_T, char, _Interlocked##WIN_OPNAME##8, __sync_fetch_and_##GNU_OPNAME) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##Int16, int16_T, short, _Interlocked##WIN_OPNAME##16, __sync_fetch_and_##GNU_OPNAME) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##Int32, int32_T, long, _Interlocked##WIN_OPNAME, __sync_fetch_and_##GNU_OPNAME) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##UInt8, uint8_T, char, _Interlocked##WIN_OPNAME##8, __sync_fetch_and_##GNU_OPNAME) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##UInt16, uint16_T, short, _Interlocked##WIN_OPNAME##16, __sync_fetch_and_##GNU_OPNAME) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##UInt32, uint32_T, long, _Interlocked##WIN_OPNAME, __sync_fetch_and_##GNU_OPNAME)
+
+#if defined(MSH_WIN) && defined(_MSC_VER) && MSH_BITNESS==32
+#  define ATOMIC_FETCH_OP_64_METADEF(OPNAME, WIN_OPNAME, GNU_OPNAME, OPERATOR) \
+ATOMIC_FETCH_OP_CX_DEF(msh_Atomic##OPNAME##Int64, int64_T, Int64, OPERATOR) \
+ATOMIC_FETCH_OP_CX_DEF(msh_Atomic##OPNAME##UInt64, uint64_T, UInt64, OPERATOR)
+#else
+#  define ATOMIC_FETCH_OP_64_METADEF(OPNAME, WIN_OPNAME, GNU_OPNAME, OPERATOR) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##Int64, int64_T, __int64, _Interlocked##WIN_OPNAME##64, __sync_fetch_and_##GNU_OPNAME) \
+ATOMIC_FETCH_OP_DEF(msh_Atomic##OPNAME##UInt64, uint64_T, __int64, _Interlocked##WIN_OPNAME##64, __sync_fetch_and_##GNU_OPNAME)
+#endif
+
+ATOMIC_FETCH_OP_METADEF(And, And, and, &)
+ATOMIC_FETCH_OP_METADEF(Or, Or, or, |)
+ATOMIC_FETCH_OP_METADEF(Xor, Xor, xor, ^)
+
+ATOMIC_FETCH_OP_64_METADEF(And, And, and, &)
+ATOMIC_FETCH_OP_64_METADEF(Or, Or, or, |)
+ATOMIC_FETCH_OP_64_METADEF(Xor, Xor, xor, ^)
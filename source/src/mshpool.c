@@ -0,0 +1,95 @@
+/** mshpool.c
+ * Defines fixed-size node pools backed by persistent slabs.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "mex.h"
+
+#include "mshpool.h"
+
+/* nodes and slab headers are padded to this so any member type is aligned */
+#define MSH_POOL_ALIGNMENT 16
+#define msh_PadToPoolAlignment(SIZE) (((SIZE) + (MSH_POOL_ALIGNMENT - 1)) & ~((size_t)MSH_POOL_ALIGNMENT - 1))
+
+#define MSH_SLAB_HEADER_SIZE msh_PadToPoolAlignment(sizeof(void*))
+
+
+/**
+ * Allocates a new slab and pushes all of its nodes onto the free list.
+ *
+ * @param node_pool The node pool.
+ */
+static void msh_AddSlab(NodePool_T* node_pool);
+
+
+void* msh_AllocateNode(NodePool_T* node_pool)
+{
+	void* node;
+	
+	if(node_pool->free_list == NULL)
+	{
+		msh_AddSlab(node_pool);
+	}
+	
+	node = node_pool->free_list;
+	node_pool->free_list = *(void**)node;
+	node_pool->num_used += 1;
+	
+	return node;
+}
+
+
+void msh_FreeNode(NodePool_T* node_pool, void* node)
+{
+	*(void**)node = node_pool->free_list;
+	node_pool->free_list = node;
+	node_pool->num_used -= 1;
+}
+
+
+void msh_DestroyNodePool(NodePool_T* node_pool)
+{
+	void* curr_slab, * next_slab;
+	
+	/* leak rather than leave dangling nodes */
+	if(node_pool->num_used > 0)
+	{
+		return;
+	}
+	
+	for(curr_slab = node_pool->slabs; curr_slab != NULL; curr_slab = next_slab)
+	{
+		next_slab = *(void**)curr_slab;
+		mxFree(curr_slab);
+	}
+	
+	node_pool->slabs = NULL;
+	node_pool->free_list = NULL;
+	node_pool->num_slabs = 0;
+}
+
+
+static void msh_AddSlab(NodePool_T* node_pool)
+{
+	size_t i, node_size = msh_PadToPoolAlignment(node_pool->node_size);
+	byte_T* new_slab, * curr_node;
+	
+	new_slab = mxMalloc(MSH_SLAB_HEADER_SIZE + node_pool->nodes_per_slab*node_size);
+	mexMakeMemoryPersistent(new_slab);
+	
+	*(void**)new_slab = node_pool->slabs;
+	node_pool->slabs = new_slab;
+	node_pool->num_slabs += 1;
+	
+	/* push in reverse so that nodes are handed out in address order */
+	for(i = node_pool->nodes_per_slab, curr_node = new_slab + MSH_SLAB_HEADER_SIZE + node_pool->nodes_per_slab*node_size; i > 0; i--)
+	{
+		curr_node -= node_size;
+		*(void**)curr_node = node_pool->free_list;
+		node_pool->free_list = curr_node;
+	}
+}
@@ -0,0 +1,326 @@
+/** mshprocs.c
+ * Defines functions for recording the references held by each
+ * process and reclaiming those of processes which have died.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "mex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mshprocs.h"
+#include "mshsegments.h"
+#include "mshutils.h"
+#include "mshlockfree.h"
+
+#ifdef MSH_UNIX
+#  include <signal.h>
+#  include <unistd.h>
+#endif
+
+
+/**
+ * Finds whether the process exists and gets its start time.
+ *
+ * @param pid The process ID.
+ * @param start_time Set to the start time of the process, or zero if unavailable.
+ * @return Whether a process with the ID exists.
+ */
+static bool_T msh_GetProcessStartTime(pid_T pid, uint64_T* start_time);
+
+
+/**
+ * Checks whether the process which claimed the slot still exists.
+ *
+ * @param process_slot The process slot.
+ * @return Whether the process is alive.
+ */
+static bool_T msh_IsProcessAlive(volatile ProcessSlot_T* process_slot);
+
+
+/**
+ * Subtracts the shares of the dead process slots from the segment counters.
+ *
+ * @param metadata The segment metadata.
+ * @param dead_slots The indices of the dead process slots.
+ * @param num_dead_slots The number of dead process slots.
+ * @return Whether the dead processes held the last uses of the segment.
+ */
+static bool_T msh_ReleaseDeadReferences(SegmentMetadata_T* metadata, const uint32_T* dead_slots, uint32_T num_dead_slots);
+
+
+/** public function definitions **/
+
+
+void msh_AcquireProcessSlot(void)
+{
+	uint32_T i;
+	uint64_T start_time;
+	volatile ProcessSlot_T* process_slot;
+	
+	if(g_local_info.process_slot != MSH_INVALID_PROCESS_SLOT)
+	{
+		return;
+	}
+	
+	msh_GetProcessStartTime(g_local_info.this_pid, &start_time);
+	
+	msh_AcquireProcessLock(g_process_lock);
+	
+	msh_ReapDeadProcesses(&g_local_seg_list);
+	
+	for(i = 0; i < MSH_MAX_PROCESS_SLOTS; i++)
+	{
+		process_slot = &g_shared_info->process_slots[i];
+		
+		/* reuse a slot left by this process if it was not released when matshare last exited */
+		if(process_slot->pid == 0 || (process_slot->pid == g_local_info.this_pid && process_slot->start_time == start_time))
+		{
+			process_slot->pid = g_local_info.this_pid;
+			process_slot->start_time = start_time;
+			g_local_info.process_slot = i;
+			break;
+		}
+	}
+	
+	msh_ReleaseProcessLock(g_process_lock);
+	
+}
+
+
+void msh_ReleaseProcessSlot(void)
+{
+	if(g_local_info.process_slot == MSH_INVALID_PROCESS_SLOT)
+	{
+		return;
+	}
+	
+	msh_AcquireProcessLock(g_process_lock);
+	g_shared_info->process_slots[g_local_info.process_slot].pid = 0;
+	g_shared_info->process_slots[g_local_info.process_slot].start_time = 0;
+	msh_ReleaseProcessLock(g_process_lock);
+	
+	g_local_info.process_slot = MSH_INVALID_PROCESS_SLOT;
+}
+
+
+uint32_T msh_ReapDeadProcesses(SegmentList_T* seg_list)
+{
+	uint32_T i, num_dead_slots = 0;
+	uint32_T dead_slots[MSH_MAX_PROCESS_SLOTS];
+	SegmentNode_T* curr_seg_node, * next_seg_node;
+	SegmentNode_T* dead_seg_nodes[MSH_RECLAIM_BATCH_SIZE];
+	size_t num_dead_segs = 0;
+	
+	msh_AcquireProcessLock(g_process_lock);
+	
+	for(i = 0; i < MSH_MAX_PROCESS_SLOTS; i++)
+	{
+		if(i != g_local_info.process_slot && g_shared_info->process_slots[i].pid != 0 && !msh_IsProcessAlive(&g_shared_info->process_slots[i]))
+		{
+			dead_slots[num_dead_slots++] = i;
+		}
+	}
+	
+	if(num_dead_slots > 0)
+	{
+		/* track every shared segment so the counters of each can be corrected */
+		msh_UpdateAllSegments(seg_list);
+		
+		for(curr_seg_node = seg_list->first; curr_seg_node != NULL; curr_seg_node = next_seg_node)
+		{
+			next_seg_node = msh_GetNextSegment(curr_seg_node);
+			if(msh_ReleaseDeadReferences(msh_GetSegmentMetadata(curr_seg_node), dead_slots, num_dead_slots)
+			   && g_user_config.will_shared_gc
+			   && !msh_GetSegmentMetadata(curr_seg_node)->is_persistent)
+			{
+				dead_seg_nodes[num_dead_segs++] = curr_seg_node;
+				if(num_dead_segs == MSH_RECLAIM_BATCH_SIZE)
+				{
+					msh_ReclaimSegments(dead_seg_nodes, num_dead_segs);
+					num_dead_segs = 0;
+				}
+			}
+		}
+		msh_ReclaimSegments(dead_seg_nodes, num_dead_segs);
+		
+		for(i = 0; i < num_dead_slots; i++)
+		{
+			/* this process is still attached, so the count cannot reach zero here */
+#ifdef MSH_WIN
+			msh_AtomicDecrement(&g_shared_info->num_procs);
+#else
+			msh_DecrementCounter(&g_shared_info->num_procs, FALSE);
+#endif
+			g_shared_info->process_slots[dead_slots[i]].pid = 0;
+			g_shared_info->process_slots[dead_slots[i]].start_time = 0;
+		}
+	}
+	
+	msh_ReleaseProcessLock(g_process_lock);
+	
+	return num_dead_slots;
+	
+}
+
+
+long msh_IncrementProcsUsing(SegmentMetadata_T* metadata)
+{
+	/* record after incrementing so that a crash in between leaks a reference rather than releasing one twice */
+	long ret = msh_AtomicIncrement(&metadata->procs_using);
+	if(g_local_info.process_slot != MSH_INVALID_PROCESS_SLOT)
+	{
+		metadata->slot_using[g_local_info.process_slot] += 1;
+	}
+	return ret;
+}
+
+
+long msh_DecrementProcsUsing(SegmentMetadata_T* metadata)
+{
+	if(g_local_info.process_slot != MSH_INVALID_PROCESS_SLOT)
+	{
+		metadata->slot_using[g_local_info.process_slot] -= 1;
+	}
+	return msh_AtomicDecrement(&metadata->procs_using);
+}
+
+
+void msh_RecordTracking(SegmentMetadata_T* metadata)
+{
+	if(g_local_info.process_slot != MSH_INVALID_PROCESS_SLOT)
+	{
+		metadata->slot_tracking[g_local_info.process_slot] += 1;
+	}
+}
+
+
+void msh_RecordUntracking(SegmentMetadata_T* metadata)
+{
+	if(g_local_info.process_slot != MSH_INVALID_PROCESS_SLOT)
+	{
+		metadata->slot_tracking[g_local_info.process_slot] -= 1;
+	}
+}
+
+
+/** static function definitions **/
+
+
+static bool_T msh_GetProcessStartTime(pid_T pid, uint64_T* start_time)
+{
+#ifdef MSH_WIN
+	HANDLE process_handle;
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	DWORD exit_code;
+	bool_T is_alive;
+	
+	*start_time = 0;
+	
+	if((process_handle = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, pid)) == NULL)
+	{
+		/* access may be denied to processes which exist */
+		return (bool_T)(GetLastError() != ERROR_INVALID_PARAMETER);
+	}
+	
+	is_alive = (bool_T)(GetExitCodeProcess(process_handle, &exit_code) == 0 || exit_code == STILL_ACTIVE);
+	
+	if(GetProcessTimes(process_handle, &creation_time, &exit_time, &kernel_time, &user_time) != 0)
+	{
+		*start_time = ((uint64_T)creation_time.dwHighDateTime << 32) | (uint64_T)creation_time.dwLowDateTime;
+	}
+	
+	CloseHandle(process_handle);
+	
+	return is_alive;
+#else
+	FILE* stat_file;
+	char_T stat_path[MSH_NAME_LEN_MAX];
+	char_T stat_buffer[1024];
+	char_T* stat_field;
+	size_t num_read;
+	int field_num;
+	
+	*start_time = 0;
+	
+	/* a process exists if it can be signaled, or if it exists but belongs to another user */
+	if(kill(pid, 0) != 0 && errno != EPERM)
+	{
+		return FALSE;
+	}
+	
+	/* the start time is only available through procfs */
+	sprintf(stat_path, "/proc/%ld/stat", (long)pid);
+	if((stat_file = fopen(stat_path, "r")) == NULL)
+	{
+		return TRUE;
+	}
+	
+	num_read = fread(stat_buffer, 1, sizeof(stat_buffer) - 1, stat_file);
+	fclose(stat_file);
+	stat_buffer[num_read] = '\0';
+	
+	/* the command name may contain spaces, so count fields from its closing parenthesis; the start time is field 22 */
+	if((stat_field = strrchr(stat_buffer, ')')) != NULL)
+	{
+		for(field_num = 2; field_num < 22 && stat_field != NULL; field_num++)
+		{
+			stat_field = strchr(stat_field + 1, ' ');
+		}
+		
+		if(stat_field != NULL)
+		{
+			*start_time = (uint64_T)strtoul(stat_field + 1, NULL, 10);
+		}
+	}
+	
+	return TRUE;
+#endif
+}
+
+
+static bool_T msh_IsProcessAlive(volatile ProcessSlot_T* process_slot)
+{
+	uint64_T start_time;
+	
+	if(!msh_GetProcessStartTime(process_slot->pid, &start_time))
+	{
+		return FALSE;
+	}
+	
+	/* a different start time means the PID was recycled */
+	return (bool_T)(start_time == 0 || process_slot->start_time == 0 || start_time == process_slot->start_time);
+}
+
+
+static bool_T msh_ReleaseDeadReferences(SegmentMetadata_T* metadata, const uint32_T* dead_slots, uint32_T num_dead_slots)
+{
+	uint32_T i;
+	long num_refs, procs_using = 1;
+	bool_T had_uses = FALSE;
+	
+	for(i = 0; i < num_dead_slots; i++)
+	{
+		for(num_refs = metadata->slot_using[dead_slots[i]]; num_refs > 0; num_refs--)
+		{
+			procs_using = msh_AtomicDecrement(&metadata->procs_using);
+			had_uses = TRUE;
+		}
+		metadata->slot_using[dead_slots[i]] = 0;
+		
+		/* this process tracks the segment too, so the count will not hit zero */
+		for(num_refs = metadata->slot_tracking[dead_slots[i]]; num_refs > 0; num_refs--)
+		{
+			msh_DecrementCounter(&metadata->procs_tracking, FALSE);
+		}
+		metadata->slot_tracking[dead_slots[i]] = 0;
+	}
+	
+	return (bool_T)(had_uses && procs_using == 0);
+}
@@ -21,11 +21,13 @@
 #include "mshutils.h"
 #include "mshexterntypes.h"
 #include "mshlockfree.h"
+#include "mshprocs.h"
 
 #ifdef MSH_UNIX
 #  include <unistd.h>
 #  include <fcntl.h>
 #  include <sys/mman.h>
+#  include <sys/stat.h>
 #endif
 
 
@@ -41,6 +43,16 @@ static void msh_WriteSegmentName(char* name_buffer, segmentnumber_T seg_num);
 static void msh_WriteSegmentLockName(char* name_buffer, segmentnumber_T seg_num);
 
 
+/**
+ * Adds or removes the entry names of a batch segment in the name table of the list.
+ *
+ * @param seg_list The segment list holding the name table.
+ * @param seg_node The batch segment node.
+ * @param will_add Whether to add the names rather than remove them.
+ */
+static void msh_TrackBatchNames(SegmentList_T* seg_list, SegmentNode_T* seg_node, int will_add);
+
+
 /**
  * Does the actual segment creation operation. Write information on the segment
  * to seg_info_cache to be used immediately after.
@@ -67,6 +79,48 @@ static void msh_OpenSegmentWorker(SegmentInfo_T* new_seg_info, segmentnumber_T s
 static void msh_IncrementRevisionNumber(void);
 
 
+/**
+ * Evicts segments which are not used by any process according to the eviction
+ * policy, until enough space is freed for a new segment of the given size.
+ * Nothing is evicted if that would not free enough space.
+ *
+ * @param new_segment_size The total size of the segment to be created.
+ * @return Whether any segments were evicted.
+ */
+static bool_T msh_EvictSegments(size_t new_segment_size);
+
+
+/**
+ * Checks whether any variable of the segment is referenced in this MATLAB session.
+ *
+ * @param seg_node The segment node.
+ * @return Whether a variable of the segment has a crosslink.
+ */
+static bool_T msh_IsReferencedLocally(SegmentNode_T* seg_node);
+
+
+/**
+ * Orders segment nodes by ascending access time, for use with qsort.
+ */
+static int msh_CompareLastAccess(const void* a, const void* b);
+
+
+/**
+ * Orders segment nodes by descending size, for use with qsort.
+ */
+static int msh_CompareSegmentSize(const void* a, const void* b);
+
+
+/**
+ * Unlinks the segment from the shared segment list and marks it as invalid.
+ * The caller must hold the process lock and increment the revision number.
+ *
+ * @param seg_node The segment node to unlink.
+ * @return Whether the segment was unlinked; FALSE if it was already invalid.
+ */
+static int msh_UnlinkSegment(SegmentNode_T* seg_node);
+
+
 /**
  * Initializer for the segment info struct.
  *
@@ -112,6 +166,15 @@ void msh_DetachSegment(SegmentNode_T* seg_node)
 	/* cache the segment info */
 	SegmentInfo_T* seg_info = msh_GetSegmentInfo(seg_node);
 	
+	while(msh_GetSubVariableNode(seg_node) != NULL)
+	{
+		msh_RemoveVariableFromList(msh_GetSubVariableNode(seg_node));
+		if(msh_DestroyVariable(msh_GetSubVariableNode(seg_node)))
+		{
+			return;
+		}
+	}
+	
 	if(msh_GetVariableNode(seg_node) != NULL)
 	{
 		msh_RemoveVariableFromList(msh_GetVariableNode(seg_node));
@@ -123,6 +186,8 @@ void msh_DetachSegment(SegmentNode_T* seg_node)
 	
 	if(seg_info->metadata != NULL)
 	{
+		msh_RecordUntracking(seg_info->metadata);
+		
 		/* lockfree */
 		do
 		{
@@ -149,6 +214,12 @@ void msh_DetachSegment(SegmentNode_T* seg_node)
 #endif
 			msh_SetCounterPost(&seg_info->metadata->procs_tracking, TRUE);
 			msh_AtomicSubtractSize(&g_shared_info->total_shared_size, seg_info->total_segment_size);
+			if(seg_info->metadata->is_compressed)
+			{
+				msh_AtomicDecrement(&g_shared_info->num_compressed_segments);
+				msh_AtomicSubtractSize(&g_shared_info->total_compressed_size, seg_info->metadata->data_size);
+				msh_AtomicSubtractSize(&g_shared_info->total_uncompressed_size, seg_info->metadata->uncompressed_size);
+			}
 		}
 		
 		msh_UnmapMemory(seg_info->metadata, sizeof(SegmentMetadata_T));
@@ -158,10 +229,17 @@ void msh_DetachSegment(SegmentNode_T* seg_node)
 	
 	if(seg_info->raw_ptr != NULL)
 	{
-		msh_UnmapMemory(seg_info->raw_ptr, seg_info->total_segment_size);
+		msh_UnmapMemory(seg_info->raw_ptr, seg_info->total_segment_size + seg_info->file_size);
 		seg_info->raw_ptr = NULL;
 	}
 	
+	if(seg_info->cache_alloc != NULL)
+	{
+		mxFree(seg_info->cache_alloc);
+		seg_info->cache_alloc = NULL;
+		seg_info->cache_ptr = NULL;
+	}
+	
 	if(seg_info->handle != MSH_INVALID_HANDLE)
 	{
 		msh_CloseSharedMemory(seg_info->handle);
@@ -255,72 +333,70 @@ void msh_AddSegmentToSharedList(SegmentNode_T* seg_node)
 void msh_RemoveSegmentFromSharedList(SegmentNode_T* seg_node)
 {
 	
-	SegmentNode_T* prev_seg_node, * next_seg_node;
-	SegmentList_T* segment_cache_list = msh_GetSegmentList(seg_node) != NULL? msh_GetSegmentList(seg_node) : &g_local_seg_list;
-	SegmentMetadata_T* segment_metadata = msh_GetSegmentMetadata(seg_node);
-	
-	if(segment_metadata->is_invalid)
+	if(msh_GetSegmentMetadata(seg_node)->is_invalid)
 	{
 		return;
 	}
 	
 	msh_AcquireProcessLock(g_process_lock);
 	
-	/* double check volatile flag */
-	if(segment_metadata->is_invalid)
+	if(msh_UnlinkSegment(seg_node))
 	{
-		msh_ReleaseProcessLock(g_process_lock);
-		return;
+		/* update the revision number to tell processes to update their segment lists */
+		msh_IncrementRevisionNumber();
 	}
 	
-	/* signal that this segment is to be freed by all processes */
-	segment_metadata->is_invalid = TRUE;
+	msh_ReleaseProcessLock(g_process_lock);
 	
-	if(msh_GetSegmentInfo(seg_node)->seg_num == g_shared_info->first_seg_num)
-	{
-		g_shared_info->first_seg_num = segment_metadata->next_seg_num;
-	}
-	else
+}
+
+
+void msh_RemoveSegmentsFromSharedList(SegmentNode_T** seg_nodes, size_t num_segs)
+{
+	size_t i;
+	int did_unlink = FALSE;
+	
+	if(num_segs == 0)
 	{
-		if((prev_seg_node = msh_FindSegmentNode(segment_cache_list->seg_table, (void*)&segment_metadata->prev_seg_num)) == NULL)
-		{
-			/* track the new segment since the mxMalloc should be cheaper than upmapping and closing the handle */
-			prev_seg_node = msh_OpenSegment(segment_metadata->prev_seg_num);
-			msh_AddSegmentToList(segment_cache_list, prev_seg_node);
-		}
-		msh_GetSegmentMetadata(prev_seg_node)->next_seg_num = segment_metadata->next_seg_num;
+		return;
 	}
 	
-	if(msh_GetSegmentInfo(seg_node)->seg_num == g_shared_info->last_seg_num)
+	msh_AcquireProcessLock(g_process_lock);
+	
+	for(i = 0; i < num_segs; i++)
 	{
-		g_shared_info->last_seg_num = segment_metadata->prev_seg_num;
+		did_unlink |= msh_UnlinkSegment(seg_nodes[i]);
 	}
-	else
+	
+	if(did_unlink)
 	{
-		if((next_seg_node = msh_FindSegmentNode(segment_cache_list->seg_table, (void*)&segment_metadata->next_seg_num)) == NULL)
-		{
-			/* track the new segment since the mxMalloc should be cheaper than upmapping and closing the handle */
-			next_seg_node = msh_OpenSegment(segment_metadata->next_seg_num);
-			msh_AddSegmentToList(segment_cache_list, next_seg_node);
-		}
-		msh_GetSegmentMetadata(next_seg_node)->prev_seg_num = segment_metadata->prev_seg_num;
+		/* one revision for the whole batch */
+		msh_IncrementRevisionNumber();
 	}
 	
-	/* reset these to reduce confusion when debugging */
-	segment_metadata->next_seg_num = MSH_INVALID_SEG_NUM;
-	segment_metadata->prev_seg_num = MSH_INVALID_SEG_NUM;
-	
-	/* sign the update with this process */
-	g_shared_info->update_pid = g_local_info.this_pid;
-	
-	/* update number of vars in shared memory */
-	g_shared_info->num_shared_segments -= 1;
+	msh_ReleaseProcessLock(g_process_lock);
 	
-	/* update the revision number to tell processes to update their segment lists */
-	msh_IncrementRevisionNumber();
+}
+
+
+void msh_ReclaimSegments(SegmentNode_T** seg_nodes, size_t num_segs)
+{
+	size_t i;
 	
-	msh_ReleaseProcessLock(g_process_lock);
+	msh_RemoveSegmentsFromSharedList(seg_nodes, num_segs);
 	
+	/* the segments are already invalid, so detaching will unlink them without taking the lock */
+	for(i = 0; i < num_segs; i++)
+	{
+		msh_RemoveSegmentFromList(seg_nodes[i]);
+		msh_DetachSegment(seg_nodes[i]);
+	}
+}
+
+
+void msh_TouchSegment(SegmentNode_T* seg_node)
+{
+	msh_GetSegmentMetadata(seg_node)->last_access = msh_AtomicIncrement(&g_shared_info->access_clock);
 }
 
 
@@ -485,6 +561,11 @@ SegmentNode_T* msh_AddSegmentToList(SegmentList_T* seg_list, SegmentNode_T* seg_
 		seg_list->num_named += 1;
 	}
 	
+	if(seg_list->name_table != NULL && msh_IsBatchSegment(seg_node))
+	{
+		msh_TrackBatchNames(seg_list, seg_node, TRUE);
+	}
+	
 	return seg_node;
 	
 }
@@ -544,6 +625,11 @@ SegmentNode_T* msh_RemoveSegmentFromList(SegmentNode_T* seg_node)
 		seg_list->num_named -= 1;
 	}
 	
+	if(seg_list->name_table != NULL && msh_IsBatchSegment(seg_node))
+	{
+		msh_TrackBatchNames(seg_list, seg_node, FALSE);
+	}
+	
 	/* remove the segment from the table */
 	if(seg_list->seg_table != NULL)
 	{
@@ -586,6 +672,15 @@ SegmentNode_T* msh_RemoveSegmentFromList(SegmentNode_T* seg_node)
 void msh_CleanSegmentList(SegmentList_T* seg_list)
 {
 	SegmentNode_T* curr_seg_node, * next_seg_node;
+	size_t curr_rev_num = g_shared_info->rev_num;
+	
+	if(seg_list->clean_rev_num == curr_rev_num)
+	{
+		return;
+	}
+	
+	/* record the revision before walking so that segments invalidated during the walk are caught by the next clean */
+	seg_list->clean_rev_num = curr_rev_num;
 	
 	for(curr_seg_node = seg_list->first; curr_seg_node != NULL; curr_seg_node = next_seg_node)
 	{
@@ -623,14 +718,17 @@ static void msh_CreateSegmentWorker(SegmentInfo_T* new_seg_info, size_t data_siz
 	/* create a unique new segment */
 	new_seg_info->seg_num = g_shared_info->last_seg_num;
 	
-	if(!msh_AtomicAddSizeWithMax(&g_shared_info->total_shared_size, new_seg_info->total_segment_size, g_user_config.max_shared_size))
+	/* on failure evict unused segments if the policy allows, then try once more */
+	if(!msh_AtomicAddSizeWithMax(&g_shared_info->total_shared_size, new_seg_info->total_segment_size, g_user_config.max_shared_size)
+	   && !(msh_EvictSegments(new_seg_info->total_segment_size) && msh_AtomicAddSizeWithMax(&g_shared_info->total_shared_size, new_seg_info->total_segment_size, g_user_config.max_shared_size)))
 	{
 		meu_PrintMexError(MEU_FL,
 		                  MEU_SEVERITY_USER,
 		                  "SegmentSizeError",
 		                  "The total size of currently shared memory is " SIZE_FORMAT " bytes. "
 		                  "The variable shared has a size of " SIZE_FORMAT " bytes and will exceed the "
-		                  "total shared size limit of " SIZE_FORMAT " bytes. You may change this limit by using mshconfig. "
+		                  "total shared size limit of " SIZE_FORMAT " bytes. You may change this limit, or let unused variables "
+		                  "be evicted with the EvictionPolicy parameter, by using mshconfig. "
 		                  "For more information refer to `help mshconfig`.",
 		                  g_shared_info->total_shared_size,
 		                  new_seg_info->total_segment_size,
@@ -660,12 +758,15 @@ static void msh_CreateSegmentWorker(SegmentInfo_T* new_seg_info, size_t data_siz
 	/* number of processes with variables instantiated using this segment */
 	new_seg_info->metadata->procs_using = 0;
 	
+	new_seg_info->metadata->last_access = msh_AtomicIncrement(&g_shared_info->access_clock);
+	
 	/* number of processes with a handle on this segment */
 #ifdef MSH_WIN
 	msh_IncrementCounter(&new_seg_info->metadata->procs_tracking);
 #else
 	msh_IncrementCounter(&new_seg_info->metadata->procs_tracking);
 #endif
+	msh_RecordTracking(new_seg_info->metadata);
 	
 	/* set this to FALSE when it gets added to the shared list */
 	new_seg_info->metadata->is_invalid = TRUE;
@@ -710,6 +811,7 @@ static void msh_OpenSegmentWorker(SegmentInfo_T* new_seg_info, segmentnumber_T s
 	/* tell everyone else that another process is tracking this */
 #ifdef MSH_WIN
 	msh_IncrementCounter(&new_seg_info->metadata->procs_tracking);
+	msh_RecordTracking(new_seg_info->metadata);
 #else
 	msh_IncrementCounter(&new_seg_info->metadata->procs_tracking);
 	
@@ -727,6 +829,10 @@ static void msh_OpenSegmentWorker(SegmentInfo_T* new_seg_info, segmentnumber_T s
 		
 		msh_OpenSegmentWorker(new_seg_info, seg_num);
 	}
+	else
+	{
+		msh_RecordTracking(new_seg_info->metadata);
+	}
 #endif
 	
 	/* get the segment size */
@@ -838,6 +944,101 @@ handle_T msh_OpenSharedMemory(char_T* segment_name)
 }
 
 
+size_t msh_FindPageAlignedDataSize(size_t min_data_size)
+{
+	size_t page_size;
+#ifdef MSH_WIN
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	page_size = system_info.dwAllocationGranularity;
+#else
+	page_size = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+	return (msh_FindSegmentSize(min_data_size) + page_size - 1)/page_size*page_size - msh_FindSegmentSize(0);
+}
+
+
+void msh_SetSegmentFile(SegmentNode_T* seg_node, size_t file_path_offset, size_t file_size)
+{
+	SegmentInfo_T* seg_info = msh_GetSegmentInfo(seg_node);
+	
+	seg_info->metadata->file_path_offset = file_path_offset;
+	seg_info->metadata->file_size = file_size;
+	
+	/* drop any plain mapping so that the file is mapped alongside the segment next time */
+	if(seg_info->raw_ptr != NULL)
+	{
+		msh_UnmapMemory(seg_info->raw_ptr, seg_info->total_segment_size + seg_info->file_size);
+		seg_info->raw_ptr = NULL;
+	}
+}
+
+
+void* msh_MapSegmentMemory(SegmentInfo_T* seg_info)
+{
+#ifdef MSH_UNIX
+	byte_T*     seg_ptr;
+	char_T*     file_path;
+	handle_T    file_handle;
+	struct stat file_stat;
+#endif
+	
+	if(seg_info->metadata->file_size == 0)
+	{
+		return msh_MapMemory(seg_info->handle, seg_info->total_segment_size);
+	}
+
+#ifdef MSH_WIN
+	meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "FileMappingError", "Variables mapped from files are not supported on Windows.");
+	return NULL;
+#else
+	
+	/* reserve a contiguous range so the file lies directly after the segment */
+	seg_ptr = mmap(NULL, seg_info->total_segment_size + seg_info->metadata->file_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(seg_ptr == MAP_FAILED)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_SYSTEM, "MemoryMappingError", "There was an error reserving memory for the mapped file");
+	}
+	
+	if(mmap(seg_ptr, seg_info->total_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, seg_info->handle, 0) == MAP_FAILED)
+	{
+		munmap(seg_ptr, seg_info->total_segment_size + seg_info->metadata->file_size);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_SYSTEM, "MemoryMappingError", "There was an error memory mapping the segment");
+	}
+	
+	file_path = (char_T*)seg_ptr + msh_FindSegmentSize(0) + seg_info->metadata->file_path_offset;
+	if((file_handle = open(file_path, O_RDWR)) == -1)
+	{
+		munmap(seg_ptr, seg_info->total_segment_size + seg_info->metadata->file_size);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER | MEU_SEVERITY_SYSTEM, "FileOpenError", "There was an error opening the mapped file '%s'.", file_path);
+	}
+	
+	/* mapping past the end of the file would fault on access */
+	if(fstat(file_handle, &file_stat) != 0 || (size_t)file_stat.st_size < seg_info->metadata->file_size)
+	{
+		close(file_handle);
+		munmap(seg_ptr, seg_info->total_segment_size + seg_info->metadata->file_size);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "FileSizeError", "The mapped file '%s' is smaller than the variable.", file_path);
+	}
+	
+	if(mmap(seg_ptr + seg_info->total_segment_size, seg_info->metadata->file_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file_handle, 0) == MAP_FAILED)
+	{
+		close(file_handle);
+		munmap(seg_ptr, seg_info->total_segment_size + seg_info->metadata->file_size);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_SYSTEM, "MemoryMappingError", "There was an error memory mapping the file");
+	}
+	
+	/* the mapping holds its own reference to the file */
+	close(file_handle);
+	
+	seg_info->file_size = seg_info->metadata->file_size;
+	
+	return seg_ptr;
+#endif
+
+}
+
+
 void* msh_MapMemory(handle_T segment_handle, size_t map_sz)
 {
 	
@@ -944,10 +1145,10 @@ static void msh_WriteSegmentLockName(char* name_buffer, segmentnumber_T seg_num)
 #endif
 
 
-uint32_T msh_GetSegmentHashByNumber(SegmentTable_T* seg_table, void* seg_num)
+uint32_T msh_GetSegmentHashByNumber(void* seg_num)
 {
 	/* a dumb hash should be fine because segment numbers are generated incrementally */
-	return *((segmentnumber_T*)seg_num) % seg_table->table_sz;
+	return (uint32_T)*((segmentnumber_T*)seg_num);
 }
 
 
@@ -957,9 +1158,9 @@ int msh_CompareNumericKey(void* node_seg_num, void* comp_seg_num)
 }
 
 
-uint32_T msh_GetSegmentHashByName(SegmentTable_T* seg_table, void* varname)
+uint32_T msh_GetSegmentHashByName(void* varname)
 {
-	return msh_MurmurHash3(varname, strlen(varname), 'm'+'s'+'h') % seg_table->table_sz;
+	return msh_MurmurHash3(varname, strlen(varname), 'm'+'s'+'h');
 }
 
 
@@ -969,10 +1170,10 @@ int msh_CompareStringKey(void* node_str, void* comp_str)
 }
 
 
-uint32_T msh_GetSegmentHashByVariableAddress(SegmentTable_T* seg_table, void* var_address)
+uint32_T msh_GetSegmentHashByVariableAddress(void* var_address)
 {
-	/* divide by the alignment to avoid crowding */
-	return (uint32_T)(((size_t)var_address/MATLAB_ALIGNMENT) % seg_table->table_sz);
+	/* addresses share their low bits, so mix them before they are masked into the table */
+	return msh_MurmurHash3((uint8_T*)&var_address, sizeof(void*), 'm'+'s'+'h');
 }
 
 
@@ -998,12 +1199,54 @@ SegmentNode_T* msh_FindSegmentNodeFromCrosslink(SegmentTable_T* seg_table, const
 }
 
 
+mxArray* msh_CreateSegmentHandle(SegmentNode_T* seg_node, int is_primary)
+{
+	mxArray* seg_handle = mxCreateNumericMatrix(1, 3, mxUINT32_CLASS, mxREAL);
+	uint32_T* handle_data = mxGetData(seg_handle);
+	handle_data[0] = (uint32_T)msh_GetSegmentInfo(seg_node)->seg_num;
+	handle_data[1] = msh_GetSegmentGeneration(seg_node);
+	handle_data[2] = (uint32_T)(is_primary != 0);
+	return seg_handle;
+}
+
+
+SegmentNode_T* msh_FindSegmentNodeFromHandle(SegmentTable_T* seg_table, const mxArray* seg_handle, int* is_primary)
+{
+	segmentnumber_T seg_num;
+	SegmentNode_T* seg_node;
+	uint32_T* handle_data;
+	
+	if(seg_handle == NULL || mxGetClassID(seg_handle) != mxUINT32_CLASS || mxIsComplex(seg_handle) || mxGetNumberOfElements(seg_handle) != 3)
+	{
+		return NULL;
+	}
+	
+	/* the generation rejects handles to segment nodes which were since detached */
+	handle_data = mxGetData(seg_handle);
+	seg_num = (segmentnumber_T)handle_data[0];
+	if((seg_node = msh_FindSegmentNode(seg_table, (void*)&seg_num)) == NULL || msh_GetSegmentGeneration(seg_node) != handle_data[1])
+	{
+		return NULL;
+	}
+	
+	if(is_primary != NULL)
+	{
+		*is_primary = (int)handle_data[2];
+	}
+	
+	return seg_node;
+}
+
+
 static void msh_InitializeSegmentInfo(SegmentInfo_T* seg_info)
 {
 	seg_info->raw_ptr            = NULL;
 	seg_info->metadata           = NULL;
 	seg_info->total_segment_size = 0;
 	seg_info->handle             = MSH_INVALID_HANDLE;
+	seg_info->cache_alloc        = NULL;
+	seg_info->cache_ptr          = NULL;
+	seg_info->file_size          = 0;
 #ifdef MSH_WIN
 	seg_info->lock               = MSH_INVALID_HANDLE;
 #else
@@ -1019,3 +1262,201 @@ static void msh_IncrementRevisionNumber(void)
 	/* make sure to avoid setting this as MSH_INITIAL_STATE */
 	g_shared_info->rev_num = (g_shared_info->rev_num == SIZE_MAX)? 1 : g_shared_info->rev_num + 1;
 }
+
+
+static bool_T msh_EvictSegments(size_t new_segment_size)
+{
+	SegmentNode_T* curr_seg_node, ** candidates;
+	SegmentMetadata_T* curr_metadata;
+	size_t num_candidates = 0, num_evicted, excess_size, evicted_size = 0;
+	
+	if(g_user_config.eviction_policy == msh_EVICT_NONE)
+	{
+		return FALSE;
+	}
+	
+	msh_AcquireProcessLock(g_process_lock);
+	
+	msh_UpdateAllSegments(&g_local_seg_list);
+	
+	if(g_local_seg_list.num_segs == 0)
+	{
+		msh_ReleaseProcessLock(g_process_lock);
+		return FALSE;
+	}
+	
+	candidates = mxMalloc(g_local_seg_list.num_segs * sizeof(SegmentNode_T*));
+	for(curr_seg_node = g_local_seg_list.first; curr_seg_node != NULL; curr_seg_node = msh_GetNextSegment(curr_seg_node))
+	{
+		curr_metadata = msh_GetSegmentMetadata(curr_seg_node);
+		
+		/* segments still mapped by other processes aren't freed when unlinked, so they can't count toward the space needed */
+		if(!curr_metadata->is_invalid && !curr_metadata->is_persistent && curr_metadata->procs_using == 0
+		   && msh_GetCounterCount(&curr_metadata->procs_tracking) == 1 && !msh_IsReferencedLocally(curr_seg_node))
+		{
+			candidates[num_candidates++] = curr_seg_node;
+		}
+	}
+	
+	qsort(candidates, num_candidates, sizeof(SegmentNode_T*), (g_user_config.eviction_policy == msh_EVICT_LRU)? msh_CompareLastAccess : msh_CompareSegmentSize);
+	
+	/* the new segment may not fit even if everything were evicted */
+	if(g_shared_info->total_shared_size > g_user_config.max_shared_size)
+	{
+		excess_size = new_segment_size + (g_shared_info->total_shared_size - g_user_config.max_shared_size);
+	}
+	else
+	{
+		excess_size = new_segment_size - (g_user_config.max_shared_size - g_shared_info->total_shared_size);
+	}
+	
+	for(num_evicted = 0; num_evicted < num_candidates && evicted_size < excess_size; num_evicted++)
+	{
+		evicted_size += msh_GetSegmentInfo(candidates[num_evicted])->total_segment_size;
+	}
+	
+	if(evicted_size >= excess_size)
+	{
+		msh_ReclaimSegments(candidates, num_evicted);
+	}
+	else
+	{
+		num_evicted = 0;
+	}
+	
+	mxFree(candidates);
+	
+	msh_ReleaseProcessLock(g_process_lock);
+	
+	return (bool_T)(num_evicted > 0);
+	
+}
+
+
+static bool_T msh_IsReferencedLocally(SegmentNode_T* seg_node)
+{
+	VariableNode_T* curr_var_node;
+	
+	if(msh_GetVariableNode(seg_node) != NULL && met_GetCrosslink(msh_GetVariableData(msh_GetVariableNode(seg_node))) != NULL)
+	{
+		return TRUE;
+	}
+	
+	for(curr_var_node = msh_GetSubVariableNode(seg_node); curr_var_node != NULL; curr_var_node = msh_GetNextSubVariable(curr_var_node))
+	{
+		if(met_GetCrosslink(msh_GetVariableData(curr_var_node)) != NULL)
+		{
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+
+static int msh_CompareLastAccess(const void* a, const void* b)
+{
+	long access_a = msh_GetSegmentMetadata(*(SegmentNode_T* const*)a)->last_access;
+	long access_b = msh_GetSegmentMetadata(*(SegmentNode_T* const*)b)->last_access;
+	return (access_a > access_b) - (access_a < access_b);
+}
+
+
+static int msh_CompareSegmentSize(const void* a, const void* b)
+{
+	size_t size_a = msh_GetSegmentInfo(*(SegmentNode_T* const*)a)->total_segment_size;
+	size_t size_b = msh_GetSegmentInfo(*(SegmentNode_T* const*)b)->total_segment_size;
+	return (size_a < size_b) - (size_a > size_b);
+}
+
+
+static int msh_UnlinkSegment(SegmentNode_T* seg_node)
+{
+	
+	SegmentNode_T* prev_seg_node, * next_seg_node;
+	SegmentList_T* segment_cache_list = msh_GetSegmentList(seg_node) != NULL? msh_GetSegmentList(seg_node) : &g_local_seg_list;
+	SegmentMetadata_T* segment_metadata = msh_GetSegmentMetadata(seg_node);
+	
+	/* double check volatile flag */
+	if(segment_metadata->is_invalid)
+	{
+		return FALSE;
+	}
+	
+	/* signal that this segment is to be freed by all processes */
+	segment_metadata->is_invalid = TRUE;
+	
+	if(msh_GetSegmentInfo(seg_node)->seg_num == g_shared_info->first_seg_num)
+	{
+		g_shared_info->first_seg_num = segment_metadata->next_seg_num;
+	}
+	else
+	{
+		if((prev_seg_node = msh_FindSegmentNode(segment_cache_list->seg_table, (void*)&segment_metadata->prev_seg_num)) == NULL)
+		{
+			/* track the new segment since the mxMalloc should be cheaper than upmapping and closing the handle */
+			prev_seg_node = msh_OpenSegment(segment_metadata->prev_seg_num);
+			msh_AddSegmentToList(segment_cache_list, prev_seg_node);
+		}
+		msh_GetSegmentMetadata(prev_seg_node)->next_seg_num = segment_metadata->next_seg_num;
+	}
+	
+	if(msh_GetSegmentInfo(seg_node)->seg_num == g_shared_info->last_seg_num)
+	{
+		g_shared_info->last_seg_num = segment_metadata->prev_seg_num;
+	}
+	else
+	{
+		if((next_seg_node = msh_FindSegmentNode(segment_cache_list->seg_table, (void*)&segment_metadata->next_seg_num)) == NULL)
+		{
+			/* track the new segment since the mxMalloc should be cheaper than upmapping and closing the handle */
+			next_seg_node = msh_OpenSegment(segment_metadata->next_seg_num);
+			msh_AddSegmentToList(segment_cache_list, next_seg_node);
+		}
+		msh_GetSegmentMetadata(next_seg_node)->prev_seg_num = segment_metadata->prev_seg_num;
+	}
+	
+	/* reset these to reduce confusion when debugging */
+	segment_metadata->next_seg_num = MSH_INVALID_SEG_NUM;
+	segment_metadata->prev_seg_num = MSH_INVALID_SEG_NUM;
+	
+	/* sign the update with this process */
+	g_shared_info->update_pid = g_local_info.this_pid;
+	
+	/* update number of vars in shared memory */
+	g_shared_info->num_shared_segments -= 1;
+	
+	return TRUE;
+	
+}
+
+
+static void msh_TrackBatchNames(SegmentList_T* seg_list, SegmentNode_T* seg_node, int will_add)
+{
+	int field_num, num_fields;
+	char_T* field_name;
+	SharedVariableHeader_T* batch_header = msh_GetSegmentData(seg_node);
+	
+	/* unnamed batches are laid out as cells and have no entries to look up */
+	if(msh_GetClassID(batch_header) != mxSTRUCT_CLASS)
+	{
+		return;
+	}
+	
+	/* the keys point into the segment, which stays mapped for as long as it is in the list */
+	num_fields = msh_GetNumFields(batch_header);
+	field_name = msh_GetFieldNames(batch_header);
+	for(field_num = 0; field_num < num_fields; field_num++, field_name += strlen(field_name) + 1)
+	{
+		if(will_add)
+		{
+			msh_AddSegmentToTable(seg_list->name_table, seg_node, field_name);
+			seg_list->num_named += 1;
+		}
+		else
+		{
+			msh_RemoveSegmentFromTable(seg_list->name_table, seg_node, field_name);
+			seg_list->num_named -= 1;
+		}
+	}
+}
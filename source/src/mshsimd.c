@@ -0,0 +1,1027 @@
+/** mshsimd.c
+ * Defines vectorized kernels for the variable operations and
+ * the runtime dispatch to them.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "mex.h"
+
+#include "mshsimd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  if defined(MSH_USE_SSE2)
+#    define MSH_SSE2_KERNELS
+#  endif
+#  if defined(MSH_USE_AVX2)
+#    define MSH_AVX2_KERNELS
+#  endif
+#endif
+
+#if defined(MSH_SSE2_KERNELS) || defined(MSH_AVX2_KERNELS)
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+/* gcc and clang only allow intrinsics in functions compiled for the instruction set */
+#if defined(__GNUC__)
+#  define MSH_TARGET_SSE2 __attribute__((target("sse2")))
+#  define MSH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#  define MSH_TARGET_SSE2
+#  define MSH_TARGET_AVX2
+#endif
+
+typedef size_t (*simdkernel_T)(void*, const void*, size_t, bool_T);
+typedef size_t (*simdconvert_T)(void*, const void*, size_t);
+typedef size_t (*simdreduce_T)(void*, size_t*, const void*, size_t);
+
+/**
+ * Checks which instruction sets the processor and operating system support.
+ *
+ * @return The widest instruction set level with kernels compiled in.
+ */
+static msh_simdlevel_T msh_DetectSIMDLevel(void);
+
+#if defined(MSH_SSE2_KERNELS) || defined(MSH_AVX2_KERNELS)
+
+/**
+ * Defines a kernel which applies VOP to whole vectors of the accumulator.
+ * The kernel returns the number of elements processed.
+ */
+#define SIMD_KERNEL_DEF(NAME, TARGET, TYPE, VEC_T, LOAD, STORE, SET1, VOP)                     \
+TARGET static size_t NAME(void* accum, const void* in, size_t num_elems, bool_T is_scalar_in) \
+{                                                                                             \
+	size_t i;                                                                                 \
+	size_t num_lanes = sizeof(VEC_T)/sizeof(TYPE);                                            \
+	size_t num_vec_elems = num_elems - num_elems%num_lanes;                                   \
+	TYPE* accum_data = (TYPE*)accum;                                                          \
+	const TYPE* in_data = (const TYPE*)in;                                                    \
+	VEC_T in_vec;                                                                             \
+	if(is_scalar_in)                                                                          \
+	{                                                                                         \
+		in_vec = SET1(*in_data);                                                              \
+		for(i = 0; i < num_vec_elems; i += num_lanes)                                         \
+		{                                                                                     \
+			STORE(accum_data + i, VOP(LOAD(accum_data + i), in_vec));                         \
+		}                                                                                     \
+	}                                                                                         \
+	else                                                                                      \
+	{                                                                                         \
+		for(i = 0; i < num_vec_elems; i += num_lanes)                                         \
+		{                                                                                     \
+			STORE(accum_data + i, VOP(LOAD(accum_data + i), LOAD(in_data + i)));              \
+		}                                                                                     \
+	}                                                                                         \
+	return num_vec_elems;                                                                     \
+}
+
+/**
+ * Defines a converter which runs STEP on each block of NUM_LANES elements.
+ * The converter returns the number of elements converted.
+ */
+#define SIMD_CONVERT_DEF(NAME, TARGET, OUT_TYPE, IN_TYPE, NUM_LANES, STEP)     \
+TARGET static size_t NAME(void* out, const void* in, size_t num_elems)        \
+{                                                                             \
+	size_t i;                                                                 \
+	size_t num_vec_elems = num_elems - num_elems%(NUM_LANES);                 \
+	OUT_TYPE* out_data = (OUT_TYPE*)out;                                      \
+	const IN_TYPE* in_data = (const IN_TYPE*)in;                              \
+	for(i = 0; i < num_vec_elems; i += (NUM_LANES))                           \
+	{                                                                         \
+		STEP(out_data + i, in_data + i);                                      \
+	}                                                                         \
+	return num_vec_elems;                                                     \
+}
+
+/**
+ * Defines a reduction which loads NUM_LANES elements at a time with LOAD and
+ * folds them into a single vector with VOP, then stores the lanes of that
+ * vector as LANE_TYPE. The reduction returns the number of elements reduced.
+ */
+#define SIMD_FOLD_DEF(NAME, TARGET, TYPE, LANE_TYPE, VEC_T, NUM_LANES, LOAD, STORE, VOP)  \
+TARGET static size_t NAME(void* lanes, size_t* num_lanes, const void* in, size_t num_elems) \
+{                                                                                          \
+	size_t i;                                                                              \
+	size_t num_vec_elems = num_elems - num_elems%(NUM_LANES);                              \
+	const TYPE* in_data = (const TYPE*)in;                                                 \
+	VEC_T acc;                                                                             \
+	*num_lanes = 0;                                                                        \
+	if(num_vec_elems == 0)                                                                 \
+	{                                                                                      \
+		return 0;                                                                          \
+	}                                                                                      \
+	acc = LOAD(in_data);                                                                   \
+	for(i = (NUM_LANES); i < num_vec_elems; i += (NUM_LANES))                              \
+	{                                                                                      \
+		acc = VOP(acc, LOAD(in_data + i));                                                 \
+	}                                                                                      \
+	STORE((LANE_TYPE*)lanes, acc);                                                         \
+	*num_lanes = sizeof(VEC_T)/sizeof(LANE_TYPE);                                          \
+	return num_vec_elems;                                                                  \
+}
+
+/* the number of set bits in each nibble of a movemask result */
+static const unsigned char msh_nibble_bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+/**
+ * Defines a reduction which counts the elements for which ISCOUNTED sets the
+ * mask. The count is stored as a single uint64_T lane.
+ */
+#define SIMD_COUNT_DEF(NAME, TARGET, TYPE, VEC_T, LOAD, ISCOUNTED, MOVEMASK)                \
+TARGET static size_t NAME(void* lanes, size_t* num_lanes, const void* in, size_t num_elems) \
+{                                                                                          \
+	size_t i;                                                                              \
+	int mask;                                                                              \
+	uint64_T count = 0;                                                                    \
+	size_t lanes_per_vec = sizeof(VEC_T)/sizeof(TYPE);                                     \
+	size_t num_vec_elems = num_elems - num_elems%lanes_per_vec;                            \
+	const TYPE* in_data = (const TYPE*)in;                                                 \
+	for(i = 0; i < num_vec_elems; i += lanes_per_vec)                                      \
+	{                                                                                      \
+		mask = MOVEMASK(ISCOUNTED(LOAD(in_data + i)));                                     \
+		count += msh_nibble_bits[mask & 0xF] + msh_nibble_bits[(mask >> 4) & 0xF];         \
+	}                                                                                      \
+	*(uint64_T*)lanes = count;                                                             \
+	*num_lanes = (num_vec_elems == 0)? 0 : 1;                                              \
+	return num_vec_elems;                                                                  \
+}
+
+#endif
+
+#ifdef MSH_SSE2_KERNELS
+
+#define SSE2_LOADI(PTR) _mm_loadu_si128((const __m128i*)(PTR))
+#define SSE2_STOREI(PTR, VEC) _mm_storeu_si128((__m128i*)(PTR), VEC)
+#define SSE2_SET1_8(VAL) _mm_set1_epi8((char)(VAL))
+#define SSE2_SET1_16(VAL) _mm_set1_epi16((short)(VAL))
+#define SSE2_SET1_32(VAL) _mm_set1_epi32((int)(VAL))
+#define SSE2_SET1_64(VAL) _mm_set1_epi64x((long long)(VAL))
+
+/**
+ * There are no saturating instructions for 32 bit integers, so these are
+ * emulated with the same overflow checks as the scalar operations.
+ */
+
+MSH_TARGET_SSE2 static __m128i msh_AddsInt32SSE2(__m128i augend, __m128i addend)
+{
+	__m128i uadd = _mm_add_epi32(augend, addend);
+	__m128i overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(uadd, augend), _mm_xor_si128(uadd, addend)), 31);
+	__m128i saturated = _mm_xor_si128(_mm_srai_epi32(augend, 31), _mm_set1_epi32(INT32_MAX));
+	return _mm_or_si128(_mm_and_si128(overflow, saturated), _mm_andnot_si128(overflow, uadd));
+}
+
+
+MSH_TARGET_SSE2 static __m128i msh_SubsInt32SSE2(__m128i minuend, __m128i subtrahend)
+{
+	__m128i usub = _mm_sub_epi32(minuend, subtrahend);
+	__m128i overflow = _mm_srai_epi32(_mm_andnot_si128(_mm_xor_si128(usub, subtrahend), _mm_xor_si128(usub, minuend)), 31);
+	__m128i saturated = _mm_xor_si128(_mm_srai_epi32(minuend, 31), _mm_set1_epi32(INT32_MAX));
+	return _mm_or_si128(_mm_and_si128(overflow, saturated), _mm_andnot_si128(overflow, usub));
+}
+
+
+MSH_TARGET_SSE2 static __m128i msh_AddsUInt32SSE2(__m128i augend, __m128i addend)
+{
+	/* flip the sign bits to compare as unsigned */
+	__m128i bias = _mm_set1_epi32(INT32_MIN);
+	__m128i ret = _mm_add_epi32(augend, addend);
+	return _mm_or_si128(ret, _mm_cmpgt_epi32(_mm_xor_si128(augend, bias), _mm_xor_si128(ret, bias)));
+}
+
+
+MSH_TARGET_SSE2 static __m128i msh_SubsUInt32SSE2(__m128i minuend, __m128i subtrahend)
+{
+	__m128i bias = _mm_set1_epi32(INT32_MIN);
+	__m128i ret = _mm_sub_epi32(minuend, subtrahend);
+	return _mm_andnot_si128(_mm_cmpgt_epi32(_mm_xor_si128(ret, bias), _mm_xor_si128(minuend, bias)), ret);
+}
+
+SIMD_KERNEL_DEF(msh_AddInt8SSE2, MSH_TARGET_SSE2, int8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, _mm_adds_epi8)
+SIMD_KERNEL_DEF(msh_SubInt8SSE2, MSH_TARGET_SSE2, int8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, _mm_subs_epi8)
+SIMD_KERNEL_DEF(msh_AddInt16SSE2, MSH_TARGET_SSE2, int16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, _mm_adds_epi16)
+SIMD_KERNEL_DEF(msh_SubInt16SSE2, MSH_TARGET_SSE2, int16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, _mm_subs_epi16)
+SIMD_KERNEL_DEF(msh_AddInt32SSE2, MSH_TARGET_SSE2, int32_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_32, msh_AddsInt32SSE2)
+SIMD_KERNEL_DEF(msh_SubInt32SSE2, MSH_TARGET_SSE2, int32_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_32, msh_SubsInt32SSE2)
+
+SIMD_KERNEL_DEF(msh_AddUInt8SSE2, MSH_TARGET_SSE2, uint8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, _mm_adds_epu8)
+SIMD_KERNEL_DEF(msh_SubUInt8SSE2, MSH_TARGET_SSE2, uint8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, _mm_subs_epu8)
+SIMD_KERNEL_DEF(msh_AddUInt16SSE2, MSH_TARGET_SSE2, uint16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, _mm_adds_epu16)
+SIMD_KERNEL_DEF(msh_SubUInt16SSE2, MSH_TARGET_SSE2, uint16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, _mm_subs_epu16)
+SIMD_KERNEL_DEF(msh_AddUInt32SSE2, MSH_TARGET_SSE2, uint32_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_32, msh_AddsUInt32SSE2)
+SIMD_KERNEL_DEF(msh_SubUInt32SSE2, MSH_TARGET_SSE2, uint32_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_32, msh_SubsUInt32SSE2)
+
+SIMD_KERNEL_DEF(msh_AddSingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_add_ps)
+SIMD_KERNEL_DEF(msh_SubSingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_sub_ps)
+SIMD_KERNEL_DEF(msh_MulSingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_mul_ps)
+SIMD_KERNEL_DEF(msh_DivSingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_div_ps)
+
+SIMD_KERNEL_DEF(msh_AddDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_add_pd)
+SIMD_KERNEL_DEF(msh_SubDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_sub_pd)
+SIMD_KERNEL_DEF(msh_MulDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_mul_pd)
+SIMD_KERNEL_DEF(msh_DivDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_div_pd)
+
+/**
+ * MATLAB's min and max ignore NaNs, so the input is taken wherever the
+ * accumulator is NaN, the same as the scalar operations.
+ */
+
+MSH_TARGET_SSE2 static __m128 msh_MinSingleVecSSE2(__m128 accum, __m128 in)
+{
+	__m128 take_in = _mm_or_ps(_mm_cmplt_ps(in, accum), _mm_cmpunord_ps(accum, accum));
+	return _mm_or_ps(_mm_and_ps(take_in, in), _mm_andnot_ps(take_in, accum));
+}
+
+
+MSH_TARGET_SSE2 static __m128 msh_MaxSingleVecSSE2(__m128 accum, __m128 in)
+{
+	__m128 take_in = _mm_or_ps(_mm_cmpgt_ps(in, accum), _mm_cmpunord_ps(accum, accum));
+	return _mm_or_ps(_mm_and_ps(take_in, in), _mm_andnot_ps(take_in, accum));
+}
+
+
+MSH_TARGET_SSE2 static __m128d msh_MinDoubleVecSSE2(__m128d accum, __m128d in)
+{
+	__m128d take_in = _mm_or_pd(_mm_cmplt_pd(in, accum), _mm_cmpunord_pd(accum, accum));
+	return _mm_or_pd(_mm_and_pd(take_in, in), _mm_andnot_pd(take_in, accum));
+}
+
+
+MSH_TARGET_SSE2 static __m128d msh_MaxDoubleVecSSE2(__m128d accum, __m128d in)
+{
+	__m128d take_in = _mm_or_pd(_mm_cmpgt_pd(in, accum), _mm_cmpunord_pd(accum, accum));
+	return _mm_or_pd(_mm_and_pd(take_in, in), _mm_andnot_pd(take_in, accum));
+}
+
+/* SSE2 only has 16 bit signed and 8 bit unsigned integer min and max */
+SIMD_KERNEL_DEF(msh_MinInt16SSE2, MSH_TARGET_SSE2, int16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, _mm_min_epi16)
+SIMD_KERNEL_DEF(msh_MaxInt16SSE2, MSH_TARGET_SSE2, int16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, _mm_max_epi16)
+SIMD_KERNEL_DEF(msh_MinUInt8SSE2, MSH_TARGET_SSE2, uint8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, _mm_min_epu8)
+SIMD_KERNEL_DEF(msh_MaxUInt8SSE2, MSH_TARGET_SSE2, uint8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, _mm_max_epu8)
+SIMD_KERNEL_DEF(msh_MinSingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, msh_MinSingleVecSSE2)
+SIMD_KERNEL_DEF(msh_MaxSingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, msh_MaxSingleVecSSE2)
+SIMD_KERNEL_DEF(msh_MinDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, msh_MinDoubleVecSSE2)
+SIMD_KERNEL_DEF(msh_MaxDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, msh_MaxDoubleVecSSE2)
+
+#define SSE2_BITWISE_METADEF(OP, VOP)                                                                             \
+SIMD_KERNEL_DEF(msh_##OP##Int8SSE2, MSH_TARGET_SSE2, int8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, VOP)     \
+SIMD_KERNEL_DEF(msh_##OP##Int16SSE2, MSH_TARGET_SSE2, int16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, VOP)  \
+SIMD_KERNEL_DEF(msh_##OP##Int32SSE2, MSH_TARGET_SSE2, int32_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_32, VOP)  \
+SIMD_KERNEL_DEF(msh_##OP##Int64SSE2, MSH_TARGET_SSE2, int64_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_64, VOP)  \
+SIMD_KERNEL_DEF(msh_##OP##UInt8SSE2, MSH_TARGET_SSE2, uint8_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_8, VOP)    \
+SIMD_KERNEL_DEF(msh_##OP##UInt16SSE2, MSH_TARGET_SSE2, uint16_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_16, VOP) \
+SIMD_KERNEL_DEF(msh_##OP##UInt32SSE2, MSH_TARGET_SSE2, uint32_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_32, VOP) \
+SIMD_KERNEL_DEF(msh_##OP##UInt64SSE2, MSH_TARGET_SSE2, uint64_T, __m128i, SSE2_LOADI, SSE2_STOREI, SSE2_SET1_64, VOP)
+
+SSE2_BITWISE_METADEF(And, _mm_and_si128)
+SSE2_BITWISE_METADEF(Or, _mm_or_si128)
+SSE2_BITWISE_METADEF(Xor, _mm_xor_si128)
+
+/**
+ * Rounds half away from zero and saturates like the scalar converter, with NaN going to zero.
+ * The results are in the lower two lanes.
+ */
+MSH_TARGET_SSE2 static __m128i msh_RoundInt32FromDoubleSSE2(__m128d in_vec)
+{
+	__m128d zero = _mm_setzero_pd();
+	__m128d half;
+	in_vec = _mm_and_pd(in_vec, _mm_cmpord_pd(in_vec, in_vec));
+	half = _mm_or_pd(_mm_and_pd(_mm_cmpgt_pd(in_vec, zero), _mm_set1_pd(0.5)), _mm_and_pd(_mm_cmplt_pd(in_vec, zero), _mm_set1_pd(-0.5)));
+	in_vec = _mm_min_pd(_mm_max_pd(in_vec, _mm_set1_pd(INT32_MIN)), _mm_set1_pd(INT32_MAX));
+	return _mm_cvttpd_epi32(_mm_add_pd(in_vec, half));
+}
+
+
+MSH_TARGET_SSE2 static void msh_CvtInt32FromDoubleSSE2(int32_T* out, const double* in)
+{
+	__m128i lo = msh_RoundInt32FromDoubleSSE2(_mm_loadu_pd(in));
+	__m128i hi = msh_RoundInt32FromDoubleSSE2(_mm_loadu_pd(in + 2));
+	_mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi64(lo, hi));
+}
+
+
+MSH_TARGET_SSE2 static void msh_CvtSingleFromDoubleSSE2(single* out, const double* in)
+{
+	_mm_storeu_ps(out, _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in)), _mm_cvtpd_ps(_mm_loadu_pd(in + 2))));
+}
+
+
+MSH_TARGET_SSE2 static void msh_CvtDoubleFromSingleSSE2(double* out, const single* in)
+{
+	__m128 in_vec = _mm_loadu_ps(in);
+	_mm_storeu_pd(out, _mm_cvtps_pd(in_vec));
+	_mm_storeu_pd(out + 2, _mm_cvtps_pd(_mm_movehl_ps(in_vec, in_vec)));
+}
+
+
+MSH_TARGET_SSE2 static void msh_CvtDoubleFromInt32SSE2(double* out, const int32_T* in)
+{
+	__m128i in_vec = SSE2_LOADI(in);
+	_mm_storeu_pd(out, _mm_cvtepi32_pd(in_vec));
+	_mm_storeu_pd(out + 2, _mm_cvtepi32_pd(_mm_srli_si128(in_vec, 8)));
+}
+
+SIMD_CONVERT_DEF(msh_ConvertInt32FromDoubleSSE2, MSH_TARGET_SSE2, int32_T, double, 4, msh_CvtInt32FromDoubleSSE2)
+SIMD_CONVERT_DEF(msh_ConvertSingleFromDoubleSSE2, MSH_TARGET_SSE2, single, double, 4, msh_CvtSingleFromDoubleSSE2)
+SIMD_CONVERT_DEF(msh_ConvertDoubleFromSingleSSE2, MSH_TARGET_SSE2, double, single, 4, msh_CvtDoubleFromSingleSSE2)
+SIMD_CONVERT_DEF(msh_ConvertDoubleFromInt32SSE2, MSH_TARGET_SSE2, double, int32_T, 4, msh_CvtDoubleFromInt32SSE2)
+
+/** reductions **/
+
+#define SSE2_WIDEN_SINGLE(PTR) _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)(PTR))))
+#define SSE2_WIDEN_INT32(PTR) _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i*)(PTR)))
+
+/* sums are accumulated in double precision */
+SIMD_FOLD_DEF(msh_SumInt32SSE2, MSH_TARGET_SSE2, int32_T, double, __m128d, 2, SSE2_WIDEN_INT32, _mm_storeu_pd, _mm_add_pd)
+SIMD_FOLD_DEF(msh_SumSingleSSE2, MSH_TARGET_SSE2, single, double, __m128d, 2, SSE2_WIDEN_SINGLE, _mm_storeu_pd, _mm_add_pd)
+SIMD_FOLD_DEF(msh_SumDoubleSSE2, MSH_TARGET_SSE2, double, double, __m128d, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd)
+
+SIMD_FOLD_DEF(msh_MinValInt16SSE2, MSH_TARGET_SSE2, int16_T, int16_T, __m128i, 8, SSE2_LOADI, SSE2_STOREI, _mm_min_epi16)
+SIMD_FOLD_DEF(msh_MaxValInt16SSE2, MSH_TARGET_SSE2, int16_T, int16_T, __m128i, 8, SSE2_LOADI, SSE2_STOREI, _mm_max_epi16)
+SIMD_FOLD_DEF(msh_MinValUInt8SSE2, MSH_TARGET_SSE2, uint8_T, uint8_T, __m128i, 16, SSE2_LOADI, SSE2_STOREI, _mm_min_epu8)
+SIMD_FOLD_DEF(msh_MaxValUInt8SSE2, MSH_TARGET_SSE2, uint8_T, uint8_T, __m128i, 16, SSE2_LOADI, SSE2_STOREI, _mm_max_epu8)
+SIMD_FOLD_DEF(msh_MinValSingleSSE2, MSH_TARGET_SSE2, single, single, __m128, 4, _mm_loadu_ps, _mm_storeu_ps, msh_MinSingleVecSSE2)
+SIMD_FOLD_DEF(msh_MaxValSingleSSE2, MSH_TARGET_SSE2, single, single, __m128, 4, _mm_loadu_ps, _mm_storeu_ps, msh_MaxSingleVecSSE2)
+SIMD_FOLD_DEF(msh_MinValDoubleSSE2, MSH_TARGET_SSE2, double, double, __m128d, 2, _mm_loadu_pd, _mm_storeu_pd, msh_MinDoubleVecSSE2)
+SIMD_FOLD_DEF(msh_MaxValDoubleSSE2, MSH_TARGET_SSE2, double, double, __m128d, 2, _mm_loadu_pd, _mm_storeu_pd, msh_MaxDoubleVecSSE2)
+
+/* nnz counts NaNs, while any ignores them */
+
+MSH_TARGET_SSE2 static __m128 msh_IsNonzeroSingleSSE2(__m128 in)
+{
+	return _mm_cmpneq_ps(in, _mm_setzero_ps());
+}
+
+
+MSH_TARGET_SSE2 static __m128 msh_IsTrueSingleSSE2(__m128 in)
+{
+	return _mm_and_ps(_mm_cmpneq_ps(in, _mm_setzero_ps()), _mm_cmpord_ps(in, in));
+}
+
+
+MSH_TARGET_SSE2 static __m128d msh_IsNonzeroDoubleSSE2(__m128d in)
+{
+	return _mm_cmpneq_pd(in, _mm_setzero_pd());
+}
+
+
+MSH_TARGET_SSE2 static __m128d msh_IsTrueDoubleSSE2(__m128d in)
+{
+	return _mm_and_pd(_mm_cmpneq_pd(in, _mm_setzero_pd()), _mm_cmpord_pd(in, in));
+}
+
+SIMD_COUNT_DEF(msh_NnzSingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, msh_IsNonzeroSingleSSE2, _mm_movemask_ps)
+SIMD_COUNT_DEF(msh_AnySingleSSE2, MSH_TARGET_SSE2, single, __m128, _mm_loadu_ps, msh_IsTrueSingleSSE2, _mm_movemask_ps)
+SIMD_COUNT_DEF(msh_NnzDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, msh_IsNonzeroDoubleSSE2, _mm_movemask_pd)
+SIMD_COUNT_DEF(msh_AnyDoubleSSE2, MSH_TARGET_SSE2, double, __m128d, _mm_loadu_pd, msh_IsTrueDoubleSSE2, _mm_movemask_pd)
+
+#endif
+
+#ifdef MSH_AVX2_KERNELS
+
+#define AVX2_LOADI(PTR) _mm256_loadu_si256((const __m256i*)(PTR))
+#define AVX2_STOREI(PTR, VEC) _mm256_storeu_si256((__m256i*)(PTR), VEC)
+#define AVX2_SET1_8(VAL) _mm256_set1_epi8((char)(VAL))
+#define AVX2_SET1_16(VAL) _mm256_set1_epi16((short)(VAL))
+#define AVX2_SET1_32(VAL) _mm256_set1_epi32((int)(VAL))
+#define AVX2_SET1_64(VAL) _mm256_set1_epi64x((long long)(VAL))
+
+MSH_TARGET_AVX2 static __m256i msh_AddsInt32AVX2(__m256i augend, __m256i addend)
+{
+	__m256i uadd = _mm256_add_epi32(augend, addend);
+	__m256i overflow = _mm256_srai_epi32(_mm256_and_si256(_mm256_xor_si256(uadd, augend), _mm256_xor_si256(uadd, addend)), 31);
+	__m256i saturated = _mm256_xor_si256(_mm256_srai_epi32(augend, 31), _mm256_set1_epi32(INT32_MAX));
+	return _mm256_blendv_epi8(uadd, saturated, overflow);
+}
+
+
+MSH_TARGET_AVX2 static __m256i msh_SubsInt32AVX2(__m256i minuend, __m256i subtrahend)
+{
+	__m256i usub = _mm256_sub_epi32(minuend, subtrahend);
+	__m256i overflow = _mm256_srai_epi32(_mm256_andnot_si256(_mm256_xor_si256(usub, subtrahend), _mm256_xor_si256(usub, minuend)), 31);
+	__m256i saturated = _mm256_xor_si256(_mm256_srai_epi32(minuend, 31), _mm256_set1_epi32(INT32_MAX));
+	return _mm256_blendv_epi8(usub, saturated, overflow);
+}
+
+
+MSH_TARGET_AVX2 static __m256i msh_AddsUInt32AVX2(__m256i augend, __m256i addend)
+{
+	__m256i ret = _mm256_add_epi32(augend, addend);
+	/* the sum wrapped if and only if it is less than the augend */
+	return _mm256_or_si256(ret, _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(ret, augend), ret), _mm256_set1_epi32(-1)));
+}
+
+
+MSH_TARGET_AVX2 static __m256i msh_SubsUInt32AVX2(__m256i minuend, __m256i subtrahend)
+{
+	/* max(a, b) - b is a - b when a >= b and zero otherwise */
+	return _mm256_sub_epi32(_mm256_max_epu32(minuend, subtrahend), subtrahend);
+}
+
+/* 64 bit integers need the 64 bit comparison, which is not available before SSE4.2 */
+
+MSH_TARGET_AVX2 static __m256i msh_AddsInt64AVX2(__m256i augend, __m256i addend)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i uadd = _mm256_add_epi64(augend, addend);
+	__m256i overflow = _mm256_cmpgt_epi64(zero, _mm256_and_si256(_mm256_xor_si256(uadd, augend), _mm256_xor_si256(uadd, addend)));
+	__m256i saturated = _mm256_xor_si256(_mm256_cmpgt_epi64(zero, augend), AVX2_SET1_64(INT64_MAX));
+	return _mm256_blendv_epi8(uadd, saturated, overflow);
+}
+
+
+MSH_TARGET_AVX2 static __m256i msh_SubsInt64AVX2(__m256i minuend, __m256i subtrahend)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i usub = _mm256_sub_epi64(minuend, subtrahend);
+	__m256i overflow = _mm256_cmpgt_epi64(zero, _mm256_andnot_si256(_mm256_xor_si256(usub, subtrahend), _mm256_xor_si256(usub, minuend)));
+	__m256i saturated = _mm256_xor_si256(_mm256_cmpgt_epi64(zero, minuend), AVX2_SET1_64(INT64_MAX));
+	return _mm256_blendv_epi8(usub, saturated, overflow);
+}
+
+
+MSH_TARGET_AVX2 static __m256i msh_AddsUInt64AVX2(__m256i augend, __m256i addend)
+{
+	__m256i bias = AVX2_SET1_64(INT64_MIN);
+	__m256i ret = _mm256_add_epi64(augend, addend);
+	return _mm256_or_si256(ret, _mm256_cmpgt_epi64(_mm256_xor_si256(augend, bias), _mm256_xor_si256(ret, bias)));
+}
+
+
+MSH_TARGET_AVX2 static __m256i msh_SubsUInt64AVX2(__m256i minuend, __m256i subtrahend)
+{
+	__m256i bias = AVX2_SET1_64(INT64_MIN);
+	__m256i ret = _mm256_sub_epi64(minuend, subtrahend);
+	return _mm256_andnot_si256(_mm256_cmpgt_epi64(_mm256_xor_si256(ret, bias), _mm256_xor_si256(minuend, bias)), ret);
+}
+
+SIMD_KERNEL_DEF(msh_AddInt8AVX2, MSH_TARGET_AVX2, int8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_adds_epi8)
+SIMD_KERNEL_DEF(msh_SubInt8AVX2, MSH_TARGET_AVX2, int8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_subs_epi8)
+SIMD_KERNEL_DEF(msh_AddInt16AVX2, MSH_TARGET_AVX2, int16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_adds_epi16)
+SIMD_KERNEL_DEF(msh_SubInt16AVX2, MSH_TARGET_AVX2, int16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_subs_epi16)
+SIMD_KERNEL_DEF(msh_AddInt32AVX2, MSH_TARGET_AVX2, int32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, msh_AddsInt32AVX2)
+SIMD_KERNEL_DEF(msh_SubInt32AVX2, MSH_TARGET_AVX2, int32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, msh_SubsInt32AVX2)
+SIMD_KERNEL_DEF(msh_AddInt64AVX2, MSH_TARGET_AVX2, int64_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_64, msh_AddsInt64AVX2)
+SIMD_KERNEL_DEF(msh_SubInt64AVX2, MSH_TARGET_AVX2, int64_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_64, msh_SubsInt64AVX2)
+
+SIMD_KERNEL_DEF(msh_AddUInt8AVX2, MSH_TARGET_AVX2, uint8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_adds_epu8)
+SIMD_KERNEL_DEF(msh_SubUInt8AVX2, MSH_TARGET_AVX2, uint8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_subs_epu8)
+SIMD_KERNEL_DEF(msh_AddUInt16AVX2, MSH_TARGET_AVX2, uint16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_adds_epu16)
+SIMD_KERNEL_DEF(msh_SubUInt16AVX2, MSH_TARGET_AVX2, uint16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_subs_epu16)
+SIMD_KERNEL_DEF(msh_AddUInt32AVX2, MSH_TARGET_AVX2, uint32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, msh_AddsUInt32AVX2)
+SIMD_KERNEL_DEF(msh_SubUInt32AVX2, MSH_TARGET_AVX2, uint32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, msh_SubsUInt32AVX2)
+SIMD_KERNEL_DEF(msh_AddUInt64AVX2, MSH_TARGET_AVX2, uint64_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_64, msh_AddsUInt64AVX2)
+SIMD_KERNEL_DEF(msh_SubUInt64AVX2, MSH_TARGET_AVX2, uint64_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_64, msh_SubsUInt64AVX2)
+
+SIMD_KERNEL_DEF(msh_AddSingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_add_ps)
+SIMD_KERNEL_DEF(msh_SubSingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_sub_ps)
+SIMD_KERNEL_DEF(msh_MulSingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_mul_ps)
+SIMD_KERNEL_DEF(msh_DivSingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_div_ps)
+
+SIMD_KERNEL_DEF(msh_AddDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_add_pd)
+SIMD_KERNEL_DEF(msh_SubDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_sub_pd)
+SIMD_KERNEL_DEF(msh_MulDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_mul_pd)
+SIMD_KERNEL_DEF(msh_DivDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_div_pd)
+
+MSH_TARGET_AVX2 static __m256 msh_MinSingleVecAVX2(__m256 accum, __m256 in)
+{
+	return _mm256_blendv_ps(accum, in, _mm256_or_ps(_mm256_cmp_ps(in, accum, _CMP_LT_OQ), _mm256_cmp_ps(accum, accum, _CMP_UNORD_Q)));
+}
+
+
+MSH_TARGET_AVX2 static __m256 msh_MaxSingleVecAVX2(__m256 accum, __m256 in)
+{
+	return _mm256_blendv_ps(accum, in, _mm256_or_ps(_mm256_cmp_ps(in, accum, _CMP_GT_OQ), _mm256_cmp_ps(accum, accum, _CMP_UNORD_Q)));
+}
+
+
+MSH_TARGET_AVX2 static __m256d msh_MinDoubleVecAVX2(__m256d accum, __m256d in)
+{
+	return _mm256_blendv_pd(accum, in, _mm256_or_pd(_mm256_cmp_pd(in, accum, _CMP_LT_OQ), _mm256_cmp_pd(accum, accum, _CMP_UNORD_Q)));
+}
+
+
+MSH_TARGET_AVX2 static __m256d msh_MaxDoubleVecAVX2(__m256d accum, __m256d in)
+{
+	return _mm256_blendv_pd(accum, in, _mm256_or_pd(_mm256_cmp_pd(in, accum, _CMP_GT_OQ), _mm256_cmp_pd(accum, accum, _CMP_UNORD_Q)));
+}
+
+SIMD_KERNEL_DEF(msh_MinInt8AVX2, MSH_TARGET_AVX2, int8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_min_epi8)
+SIMD_KERNEL_DEF(msh_MaxInt8AVX2, MSH_TARGET_AVX2, int8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_max_epi8)
+SIMD_KERNEL_DEF(msh_MinInt16AVX2, MSH_TARGET_AVX2, int16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_min_epi16)
+SIMD_KERNEL_DEF(msh_MaxInt16AVX2, MSH_TARGET_AVX2, int16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_max_epi16)
+SIMD_KERNEL_DEF(msh_MinInt32AVX2, MSH_TARGET_AVX2, int32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, _mm256_min_epi32)
+SIMD_KERNEL_DEF(msh_MaxInt32AVX2, MSH_TARGET_AVX2, int32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, _mm256_max_epi32)
+
+SIMD_KERNEL_DEF(msh_MinUInt8AVX2, MSH_TARGET_AVX2, uint8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_min_epu8)
+SIMD_KERNEL_DEF(msh_MaxUInt8AVX2, MSH_TARGET_AVX2, uint8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, _mm256_max_epu8)
+SIMD_KERNEL_DEF(msh_MinUInt16AVX2, MSH_TARGET_AVX2, uint16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_min_epu16)
+SIMD_KERNEL_DEF(msh_MaxUInt16AVX2, MSH_TARGET_AVX2, uint16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, _mm256_max_epu16)
+SIMD_KERNEL_DEF(msh_MinUInt32AVX2, MSH_TARGET_AVX2, uint32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, _mm256_min_epu32)
+SIMD_KERNEL_DEF(msh_MaxUInt32AVX2, MSH_TARGET_AVX2, uint32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, _mm256_max_epu32)
+
+SIMD_KERNEL_DEF(msh_MinSingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, msh_MinSingleVecAVX2)
+SIMD_KERNEL_DEF(msh_MaxSingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, msh_MaxSingleVecAVX2)
+SIMD_KERNEL_DEF(msh_MinDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, msh_MinDoubleVecAVX2)
+SIMD_KERNEL_DEF(msh_MaxDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, msh_MaxDoubleVecAVX2)
+
+#define AVX2_BITWISE_METADEF(OP, VOP)                                                                             \
+SIMD_KERNEL_DEF(msh_##OP##Int8AVX2, MSH_TARGET_AVX2, int8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, VOP)     \
+SIMD_KERNEL_DEF(msh_##OP##Int16AVX2, MSH_TARGET_AVX2, int16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, VOP)  \
+SIMD_KERNEL_DEF(msh_##OP##Int32AVX2, MSH_TARGET_AVX2, int32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, VOP)  \
+SIMD_KERNEL_DEF(msh_##OP##Int64AVX2, MSH_TARGET_AVX2, int64_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_64, VOP)  \
+SIMD_KERNEL_DEF(msh_##OP##UInt8AVX2, MSH_TARGET_AVX2, uint8_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_8, VOP)    \
+SIMD_KERNEL_DEF(msh_##OP##UInt16AVX2, MSH_TARGET_AVX2, uint16_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_16, VOP) \
+SIMD_KERNEL_DEF(msh_##OP##UInt32AVX2, MSH_TARGET_AVX2, uint32_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_32, VOP) \
+SIMD_KERNEL_DEF(msh_##OP##UInt64AVX2, MSH_TARGET_AVX2, uint64_T, __m256i, AVX2_LOADI, AVX2_STOREI, AVX2_SET1_64, VOP)
+
+AVX2_BITWISE_METADEF(And, _mm256_and_si256)
+AVX2_BITWISE_METADEF(Or, _mm256_or_si256)
+AVX2_BITWISE_METADEF(Xor, _mm256_xor_si256)
+
+MSH_TARGET_AVX2 static void msh_CvtInt32FromDoubleAVX2(int32_T* out, const double* in)
+{
+	__m256d in_vec = _mm256_loadu_pd(in);
+	__m256d zero = _mm256_setzero_pd();
+	__m256d half;
+	in_vec = _mm256_and_pd(in_vec, _mm256_cmp_pd(in_vec, in_vec, _CMP_ORD_Q));
+	half = _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(in_vec, zero, _CMP_GT_OQ), _mm256_set1_pd(0.5)), _mm256_and_pd(_mm256_cmp_pd(in_vec, zero, _CMP_LT_OQ), _mm256_set1_pd(-0.5)));
+	in_vec = _mm256_min_pd(_mm256_max_pd(in_vec, _mm256_set1_pd(INT32_MIN)), _mm256_set1_pd(INT32_MAX));
+	_mm_storeu_si128((__m128i*)out, _mm256_cvttpd_epi32(_mm256_add_pd(in_vec, half)));
+}
+
+
+MSH_TARGET_AVX2 static void msh_CvtSingleFromDoubleAVX2(single* out, const double* in)
+{
+	_mm_storeu_ps(out, _mm256_cvtpd_ps(_mm256_loadu_pd(in)));
+}
+
+
+MSH_TARGET_AVX2 static void msh_CvtDoubleFromSingleAVX2(double* out, const single* in)
+{
+	_mm256_storeu_pd(out, _mm256_cvtps_pd(_mm_loadu_ps(in)));
+}
+
+
+MSH_TARGET_AVX2 static void msh_CvtDoubleFromInt32AVX2(double* out, const int32_T* in)
+{
+	_mm256_storeu_pd(out, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)in)));
+}
+
+SIMD_CONVERT_DEF(msh_ConvertInt32FromDoubleAVX2, MSH_TARGET_AVX2, int32_T, double, 4, msh_CvtInt32FromDoubleAVX2)
+SIMD_CONVERT_DEF(msh_ConvertSingleFromDoubleAVX2, MSH_TARGET_AVX2, single, double, 4, msh_CvtSingleFromDoubleAVX2)
+SIMD_CONVERT_DEF(msh_ConvertDoubleFromSingleAVX2, MSH_TARGET_AVX2, double, single, 4, msh_CvtDoubleFromSingleAVX2)
+SIMD_CONVERT_DEF(msh_ConvertDoubleFromInt32AVX2, MSH_TARGET_AVX2, double, int32_T, 4, msh_CvtDoubleFromInt32AVX2)
+
+/** reductions **/
+
+#define AVX2_WIDEN_SINGLE(PTR) _mm256_cvtps_pd(_mm_loadu_ps(PTR))
+#define AVX2_WIDEN_INT32(PTR) _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(PTR)))
+
+SIMD_FOLD_DEF(msh_SumInt32AVX2, MSH_TARGET_AVX2, int32_T, double, __m256d, 4, AVX2_WIDEN_INT32, _mm256_storeu_pd, _mm256_add_pd)
+SIMD_FOLD_DEF(msh_SumSingleAVX2, MSH_TARGET_AVX2, single, double, __m256d, 4, AVX2_WIDEN_SINGLE, _mm256_storeu_pd, _mm256_add_pd)
+SIMD_FOLD_DEF(msh_SumDoubleAVX2, MSH_TARGET_AVX2, double, double, __m256d, 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd)
+
+#define AVX2_FOLD_INT_METADEF(OP, SIZE, NUM_LANES, VOP, UVOP)                                                                                   \
+SIMD_FOLD_DEF(msh_##OP##Int##SIZE##AVX2, MSH_TARGET_AVX2, int##SIZE##_T, int##SIZE##_T, __m256i, NUM_LANES, AVX2_LOADI, AVX2_STOREI, VOP)     \
+SIMD_FOLD_DEF(msh_##OP##UInt##SIZE##AVX2, MSH_TARGET_AVX2, uint##SIZE##_T, uint##SIZE##_T, __m256i, NUM_LANES, AVX2_LOADI, AVX2_STOREI, UVOP)
+
+AVX2_FOLD_INT_METADEF(MinVal, 8, 32, _mm256_min_epi8, _mm256_min_epu8)
+AVX2_FOLD_INT_METADEF(MaxVal, 8, 32, _mm256_max_epi8, _mm256_max_epu8)
+AVX2_FOLD_INT_METADEF(MinVal, 16, 16, _mm256_min_epi16, _mm256_min_epu16)
+AVX2_FOLD_INT_METADEF(MaxVal, 16, 16, _mm256_max_epi16, _mm256_max_epu16)
+AVX2_FOLD_INT_METADEF(MinVal, 32, 8, _mm256_min_epi32, _mm256_min_epu32)
+AVX2_FOLD_INT_METADEF(MaxVal, 32, 8, _mm256_max_epi32, _mm256_max_epu32)
+
+SIMD_FOLD_DEF(msh_MinValSingleAVX2, MSH_TARGET_AVX2, single, single, __m256, 8, _mm256_loadu_ps, _mm256_storeu_ps, msh_MinSingleVecAVX2)
+SIMD_FOLD_DEF(msh_MaxValSingleAVX2, MSH_TARGET_AVX2, single, single, __m256, 8, _mm256_loadu_ps, _mm256_storeu_ps, msh_MaxSingleVecAVX2)
+SIMD_FOLD_DEF(msh_MinValDoubleAVX2, MSH_TARGET_AVX2, double, double, __m256d, 4, _mm256_loadu_pd, _mm256_storeu_pd, msh_MinDoubleVecAVX2)
+SIMD_FOLD_DEF(msh_MaxValDoubleAVX2, MSH_TARGET_AVX2, double, double, __m256d, 4, _mm256_loadu_pd, _mm256_storeu_pd, msh_MaxDoubleVecAVX2)
+
+MSH_TARGET_AVX2 static __m256 msh_IsNonzeroSingleAVX2(__m256 in)
+{
+	return _mm256_cmp_ps(in, _mm256_setzero_ps(), _CMP_NEQ_UQ);
+}
+
+
+MSH_TARGET_AVX2 static __m256 msh_IsTrueSingleAVX2(__m256 in)
+{
+	return _mm256_cmp_ps(in, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+}
+
+
+MSH_TARGET_AVX2 static __m256d msh_IsNonzeroDoubleAVX2(__m256d in)
+{
+	return _mm256_cmp_pd(in, _mm256_setzero_pd(), _CMP_NEQ_UQ);
+}
+
+
+MSH_TARGET_AVX2 static __m256d msh_IsTrueDoubleAVX2(__m256d in)
+{
+	return _mm256_cmp_pd(in, _mm256_setzero_pd(), _CMP_NEQ_OQ);
+}
+
+SIMD_COUNT_DEF(msh_NnzSingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, msh_IsNonzeroSingleAVX2, _mm256_movemask_ps)
+SIMD_COUNT_DEF(msh_AnySingleAVX2, MSH_TARGET_AVX2, single, __m256, _mm256_loadu_ps, msh_IsTrueSingleAVX2, _mm256_movemask_ps)
+SIMD_COUNT_DEF(msh_NnzDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, msh_IsNonzeroDoubleAVX2, _mm256_movemask_pd)
+SIMD_COUNT_DEF(msh_AnyDoubleAVX2, MSH_TARGET_AVX2, double, __m256d, _mm256_loadu_pd, msh_IsTrueDoubleAVX2, _mm256_movemask_pd)
+
+#endif
+
+/** kernel choosers **/
+
+/* logical and char use the int8 and int16 operations, same as the scalar runners */
+#define SIMD_INT_SWITCH_CASES(OP, ISET, CLASS_ID_NAME)    \
+switch(CLASS_ID_NAME)                                     \
+{                                                         \
+	case(mxINT8_CLASS):    return msh_##OP##Int8##ISET;   \
+	case(mxINT16_CLASS):   return msh_##OP##Int16##ISET;  \
+	case(mxINT32_CLASS):   return msh_##OP##Int32##ISET;  \
+	                                                      \
+	case(mxUINT8_CLASS):   return msh_##OP##UInt8##ISET;  \
+	case(mxUINT16_CLASS):  return msh_##OP##UInt16##ISET; \
+	case(mxUINT32_CLASS):  return msh_##OP##UInt32##ISET; \
+	                                                      \
+	case(mxSINGLE_CLASS):  return msh_##OP##Single##ISET; \
+	case(mxDOUBLE_CLASS):  return msh_##OP##Double##ISET; \
+	                                                      \
+	case(mxLOGICAL_CLASS): return msh_##OP##Int8##ISET;   \
+	case(mxCHAR_CLASS):    return msh_##OP##Int16##ISET;  \
+	default:               return 0;                      \
+}
+
+#define SIMD_BITWISE_SWITCH_CASES(OP, ISET, CLASS_ID_NAME) \
+switch(CLASS_ID_NAME)                                      \
+{                                                          \
+	case(mxINT8_CLASS):    return msh_##OP##Int8##ISET;    \
+	case(mxINT16_CLASS):   return msh_##OP##Int16##ISET;   \
+	case(mxINT32_CLASS):   return msh_##OP##Int32##ISET;   \
+	case(mxINT64_CLASS):   return msh_##OP##Int64##ISET;   \
+	                                                       \
+	case(mxUINT8_CLASS):   return msh_##OP##UInt8##ISET;   \
+	case(mxUINT16_CLASS):  return msh_##OP##UInt16##ISET;  \
+	case(mxUINT32_CLASS):  return msh_##OP##UInt32##ISET;  \
+	case(mxUINT64_CLASS):  return msh_##OP##UInt64##ISET;  \
+	                                                       \
+	case(mxLOGICAL_CLASS): return msh_##OP##Int8##ISET;    \
+	case(mxCHAR_CLASS):    return msh_##OP##Int16##ISET;   \
+	default:               return 0;                       \
+}
+
+#define SIMD_FLOAT_SWITCH_CASES(OP, ISET, CLASS_ID_NAME)  \
+switch(CLASS_ID_NAME)                                     \
+{                                                         \
+	case(mxSINGLE_CLASS):  return msh_##OP##Single##ISET; \
+	case(mxDOUBLE_CLASS):  return msh_##OP##Double##ISET; \
+	default:               return 0;                      \
+}
+
+#ifdef MSH_SSE2_KERNELS
+
+static simdkernel_T msh_ChooseSSE2Kernel(msh_varop_T varop, mxClassID class_id)
+{
+	switch(varop)
+	{
+		case(VAROP_ADD): SIMD_INT_SWITCH_CASES(Add, SSE2, class_id);
+		case(VAROP_SUB): SIMD_INT_SWITCH_CASES(Sub, SSE2, class_id);
+		case(VAROP_MUL): SIMD_FLOAT_SWITCH_CASES(Mul, SSE2, class_id);
+		case(VAROP_DIV): SIMD_FLOAT_SWITCH_CASES(Div, SSE2, class_id);
+		case(VAROP_MIN):
+			switch(class_id)
+			{
+				case(mxINT16_CLASS): return msh_MinInt16SSE2;
+				case(mxUINT8_CLASS): return msh_MinUInt8SSE2;
+				default: SIMD_FLOAT_SWITCH_CASES(Min, SSE2, class_id);
+			}
+		case(VAROP_MAX):
+			switch(class_id)
+			{
+				case(mxINT16_CLASS): return msh_MaxInt16SSE2;
+				case(mxUINT8_CLASS): return msh_MaxUInt8SSE2;
+				default: SIMD_FLOAT_SWITCH_CASES(Max, SSE2, class_id);
+			}
+		case(VAROP_AND): SIMD_BITWISE_SWITCH_CASES(And, SSE2, class_id);
+		case(VAROP_OR):  SIMD_BITWISE_SWITCH_CASES(Or, SSE2, class_id);
+		case(VAROP_XOR): SIMD_BITWISE_SWITCH_CASES(Xor, SSE2, class_id);
+		default: return 0;
+	}
+	return 0;
+}
+
+#endif
+
+#ifdef MSH_AVX2_KERNELS
+
+static simdkernel_T msh_ChooseAVX2Kernel(msh_varop_T varop, mxClassID class_id)
+{
+	switch(varop)
+	{
+		case(VAROP_ADD):
+			switch(class_id)
+			{
+				case(mxINT64_CLASS):  return msh_AddInt64AVX2;
+				case(mxUINT64_CLASS): return msh_AddUInt64AVX2;
+				default: SIMD_INT_SWITCH_CASES(Add, AVX2, class_id);
+			}
+		case(VAROP_SUB):
+			switch(class_id)
+			{
+				case(mxINT64_CLASS):  return msh_SubInt64AVX2;
+				case(mxUINT64_CLASS): return msh_SubUInt64AVX2;
+				default: SIMD_INT_SWITCH_CASES(Sub, AVX2, class_id);
+			}
+		case(VAROP_MUL): SIMD_FLOAT_SWITCH_CASES(Mul, AVX2, class_id);
+		case(VAROP_DIV): SIMD_FLOAT_SWITCH_CASES(Div, AVX2, class_id);
+		case(VAROP_MIN): SIMD_INT_SWITCH_CASES(Min, AVX2, class_id);
+		case(VAROP_MAX): SIMD_INT_SWITCH_CASES(Max, AVX2, class_id);
+		case(VAROP_AND): SIMD_BITWISE_SWITCH_CASES(And, AVX2, class_id);
+		case(VAROP_OR):  SIMD_BITWISE_SWITCH_CASES(Or, AVX2, class_id);
+		case(VAROP_XOR): SIMD_BITWISE_SWITCH_CASES(Xor, AVX2, class_id);
+		default: return 0;
+	}
+	return 0;
+}
+
+#endif
+
+#ifdef MSH_SSE2_KERNELS
+
+static simdreduce_T msh_ChooseSSE2Reduction(msh_varop_T varop, mxClassID class_id)
+{
+	switch(varop)
+	{
+		case(VAROP_SUM):
+			switch(class_id)
+			{
+				case(mxINT32_CLASS): return msh_SumInt32SSE2;
+				default: SIMD_FLOAT_SWITCH_CASES(Sum, SSE2, class_id);
+			}
+		case(VAROP_MINVAL):
+			switch(class_id)
+			{
+				case(mxINT16_CLASS): return msh_MinValInt16SSE2;
+				case(mxUINT8_CLASS): return msh_MinValUInt8SSE2;
+				default: SIMD_FLOAT_SWITCH_CASES(MinVal, SSE2, class_id);
+			}
+		case(VAROP_MAXVAL):
+			switch(class_id)
+			{
+				case(mxINT16_CLASS): return msh_MaxValInt16SSE2;
+				case(mxUINT8_CLASS): return msh_MaxValUInt8SSE2;
+				default: SIMD_FLOAT_SWITCH_CASES(MaxVal, SSE2, class_id);
+			}
+		case(VAROP_ANY): SIMD_FLOAT_SWITCH_CASES(Any, SSE2, class_id);
+		case(VAROP_NNZ): SIMD_FLOAT_SWITCH_CASES(Nnz, SSE2, class_id);
+		default: return 0;
+	}
+	return 0;
+}
+
+#endif
+
+#ifdef MSH_AVX2_KERNELS
+
+static simdreduce_T msh_ChooseAVX2Reduction(msh_varop_T varop, mxClassID class_id)
+{
+	switch(varop)
+	{
+		case(VAROP_SUM):
+			switch(class_id)
+			{
+				case(mxINT32_CLASS): return msh_SumInt32AVX2;
+				default: SIMD_FLOAT_SWITCH_CASES(Sum, AVX2, class_id);
+			}
+		case(VAROP_MINVAL): SIMD_INT_SWITCH_CASES(MinVal, AVX2, class_id);
+		case(VAROP_MAXVAL): SIMD_INT_SWITCH_CASES(MaxVal, AVX2, class_id);
+		case(VAROP_ANY):    SIMD_FLOAT_SWITCH_CASES(Any, AVX2, class_id);
+		case(VAROP_NNZ):    SIMD_FLOAT_SWITCH_CASES(Nnz, AVX2, class_id);
+		default: return 0;
+	}
+	return 0;
+}
+
+#endif
+
+/* the converters are chosen by output and input type */
+#define SIMD_CONVERT_SWITCH_CASES(ISET, OUT_CLASS_ID_NAME, IN_CLASS_ID_NAME)                                       \
+switch(OUT_CLASS_ID_NAME)                                                                                         \
+{                                                                                                                 \
+	case(mxINT32_CLASS):  return (IN_CLASS_ID_NAME == mxDOUBLE_CLASS)? msh_ConvertInt32FromDouble##ISET : 0;     \
+	case(mxSINGLE_CLASS): return (IN_CLASS_ID_NAME == mxDOUBLE_CLASS)? msh_ConvertSingleFromDouble##ISET : 0;    \
+	case(mxDOUBLE_CLASS):                                                                                         \
+		switch(IN_CLASS_ID_NAME)                                                                                  \
+		{                                                                                                         \
+			case(mxSINGLE_CLASS): return msh_ConvertDoubleFromSingle##ISET;                                       \
+			case(mxINT32_CLASS):  return msh_ConvertDoubleFromInt32##ISET;                                        \
+			default:              return 0;                                                                       \
+		}                                                                                                         \
+	default: return 0;                                                                                            \
+}
+
+#ifdef MSH_SSE2_KERNELS
+
+static simdconvert_T msh_ChooseSSE2Converter(mxClassID out_class_id, mxClassID in_class_id)
+{
+	SIMD_CONVERT_SWITCH_CASES(SSE2, out_class_id, in_class_id);
+	return 0;
+}
+
+#endif
+
+#ifdef MSH_AVX2_KERNELS
+
+static simdconvert_T msh_ChooseAVX2Converter(mxClassID out_class_id, mxClassID in_class_id)
+{
+	SIMD_CONVERT_SWITCH_CASES(AVX2, out_class_id, in_class_id);
+	return 0;
+}
+
+#endif
+
+/** public function definitions **/
+
+msh_simdlevel_T msh_GetSIMDLevel(void)
+{
+	/* detection is idempotent, so a race here only repeats it */
+	static int simd_level = -1;
+	if(simd_level < 0)
+	{
+		simd_level = (int)msh_DetectSIMDLevel();
+	}
+	return (msh_simdlevel_T)simd_level;
+}
+
+
+size_t msh_SIMDBinaryOp(msh_varop_T varop, mxClassID mxtype, void* accum, const void* in, size_t num_elems, bool_T is_scalar_in)
+{
+	simdkernel_T kernel = NULL;
+	
+	switch(msh_GetSIMDLevel())
+	{
+#ifdef MSH_AVX2_KERNELS
+		case(msh_SIMD_AVX2):
+		{
+			kernel = msh_ChooseAVX2Kernel(varop, mxtype);
+			break;
+		}
+#endif
+#ifdef MSH_SSE2_KERNELS
+		case(msh_SIMD_SSE2):
+		{
+			kernel = msh_ChooseSSE2Kernel(varop, mxtype);
+			break;
+		}
+#endif
+		default:
+		{
+			/* these are unused when no kernels are compiled in */
+			(void)varop;
+			(void)mxtype;
+			break;
+		}
+	}
+	
+	return (kernel == NULL)? 0 : kernel(accum, in, num_elems, is_scalar_in);
+}
+
+
+size_t msh_SIMDConvert(mxClassID out_mxtype, mxClassID in_mxtype, void* out, const void* in, size_t num_elems)
+{
+	simdconvert_T converter = NULL;
+	
+	switch(msh_GetSIMDLevel())
+	{
+#ifdef MSH_AVX2_KERNELS
+		case(msh_SIMD_AVX2):
+		{
+			converter = msh_ChooseAVX2Converter(out_mxtype, in_mxtype);
+			break;
+		}
+#endif
+#ifdef MSH_SSE2_KERNELS
+		case(msh_SIMD_SSE2):
+		{
+			converter = msh_ChooseSSE2Converter(out_mxtype, in_mxtype);
+			break;
+		}
+#endif
+		default:
+		{
+			/* these are unused when no kernels are compiled in */
+			(void)out_mxtype;
+			(void)in_mxtype;
+			break;
+		}
+	}
+	
+	return (converter == NULL)? 0 : converter(out, in, num_elems);
+}
+
+
+size_t msh_SIMDReduce(msh_varop_T varop, mxClassID mxtype, const void* in, size_t num_elems, void* lanes, size_t* num_lanes)
+{
+	simdreduce_T reduction = NULL;
+	
+	switch(msh_GetSIMDLevel())
+	{
+#ifdef MSH_AVX2_KERNELS
+		case(msh_SIMD_AVX2):
+		{
+			reduction = msh_ChooseAVX2Reduction(varop, mxtype);
+			break;
+		}
+#endif
+#ifdef MSH_SSE2_KERNELS
+		case(msh_SIMD_SSE2):
+		{
+			reduction = msh_ChooseSSE2Reduction(varop, mxtype);
+			break;
+		}
+#endif
+		default:
+		{
+			/* these are unused when no kernels are compiled in */
+			(void)varop;
+			(void)mxtype;
+			break;
+		}
+	}
+	
+	if(reduction == NULL)
+	{
+		*num_lanes = 0;
+		return 0;
+	}
+	
+	return reduction(lanes, num_lanes, in, num_elems);
+}
+
+/** static function definitions **/
+
+static msh_simdlevel_T msh_DetectSIMDLevel(void)
+{
+#if defined(MSH_SSE2_KERNELS) || defined(MSH_AVX2_KERNELS)
+	unsigned int regs[4] = {0};
+	unsigned int max_leaf;
+	bool_T has_sse2, has_avx2 = FALSE;
+#  if defined(_MSC_VER)
+	int msc_regs[4];
+	__cpuid(msc_regs, 0);
+	max_leaf = (unsigned int)msc_regs[0];
+	__cpuid(msc_regs, 1);
+	regs[2] = (unsigned int)msc_regs[2];
+	regs[3] = (unsigned int)msc_regs[3];
+#  else
+	max_leaf = __get_cpuid_max(0, NULL);
+	__cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#  endif
+
+	has_sse2 = (bool_T)((regs[3] & (1u << 26)) != 0);
+	
+	/* AVX2 also needs the operating system to save the upper halves of the registers (OSXSAVE and AVX bits) */
+	if(max_leaf >= 7 && (regs[2] & (1u << 27)) && (regs[2] & (1u << 28)))
+	{
+#  if defined(_MSC_VER)
+		if((_xgetbv(0) & 0x6) == 0x6)
+		{
+			__cpuidex(msc_regs, 7, 0);
+			has_avx2 = (bool_T)((msc_regs[1] & (1 << 5)) != 0);
+		}
+#  else
+		unsigned int xcr0_lo, xcr0_hi;
+		__asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		if((xcr0_lo & 0x6) == 0x6)
+		{
+			__cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+			has_avx2 = (bool_T)((regs[1] & (1u << 5)) != 0);
+		}
+#  endif
+	}
+
+#  ifdef MSH_AVX2_KERNELS
+	if(has_avx2)
+	{
+		return msh_SIMD_AVX2;
+	}
+#  else
+	/* detected, but there are no kernels to use it */
+	(void)has_avx2;
+#  endif
+#  ifdef MSH_SSE2_KERNELS
+	if(has_sse2)
+	{
+		return msh_SIMD_SSE2;
+	}
+#  else
+	(void)has_sse2;
+#  endif
+#endif
+	return msh_SIMD_NONE;
+}
@@ -17,221 +17,198 @@
 
 #define MSH_INIT_TABLE_SIZE 64
 
+#define msh_GetHomeSlot(seg_table, hash) ((hash) & ((seg_table)->table_sz - 1))
+#define msh_GetNextSlot(seg_table, slot) (((slot) + 1) & ((seg_table)->table_sz - 1))
+
 /**
  * Resizes the segment table.
  *
  * @param seg_table The segment table.
- * @param num_segs The number of segments hooked into the table.
+ * @param new_table_sz The new table size, which must be a power of two.
  */
-static void msh_ResizeTable(SegmentTable_T* seg_table, uint32_T num_segs);
-
-
-static void msh_AddNodeToTable(SegmentTable_T* seg_table, SegmentTableNode_T* new_table_node);
+static void msh_ResizeTable(SegmentTable_T* seg_table, uint32_T new_table_sz);
 
 
 /**
- * Calculates the new hash table size.
+ * Inserts the entry with Robin Hood linear probing. Entries which are further
+ * from their home slots displace those which are closer, which bounds the
+ * variance of the probe lengths.
  *
- * @param curr_sz The current table size.
- * @return The new table size.
+ * @note This does not check the load of the table.
+ * @param seg_table The segment table.
+ * @param new_entry The entry to be inserted. Used as scratch space.
  */
-static uint32_T msh_FindNewTableSize(uint32_T curr_sz);
+static void msh_InsertEntry(SegmentTable_T* seg_table, SegmentTableEntry_T* new_entry);
 
 
 void msh_InitializeTable(SegmentTable_T* seg_table)
 {
 	seg_table->table_sz = MSH_INIT_TABLE_SIZE;
-	seg_table->table = mxCalloc(seg_table->table_sz, sizeof(SegmentTableNode_T*));
+	seg_table->num_entries = 0;
+	seg_table->table = mxCalloc(seg_table->table_sz, sizeof(SegmentTableEntry_T));
 	mexMakeMemoryPersistent(seg_table->table);
 }
 
 
 void msh_AddSegmentToTable(SegmentTable_T* seg_table, SegmentNode_T* seg_node, void* key)
 {
-	SegmentTableNode_T* new_table_node;
+	SegmentTableEntry_T new_entry;
 	
 	/* table must be initialized; don't want spooky initialization here */
 	
-	/* create new table node */
-	new_table_node = mxMalloc(sizeof(SegmentTableNode_T));
-	mexMakeMemoryPersistent(new_table_node);
-	new_table_node->seg_node = seg_node;
-	new_table_node->key = key;
-	new_table_node->next = NULL;
-	
-	if(msh_GetSegmentList(seg_node)->num_segs >= seg_table->table_sz/2)
+	/* keep the load factor under 3/4 so that probe sequences stay short */
+	if(4*((size_t)seg_table->num_entries + 1) > 3*(size_t)seg_table->table_sz)
 	{
-		msh_ResizeTable(seg_table, msh_GetSegmentList(seg_node)->num_segs);
+		msh_ResizeTable(seg_table, seg_table->table_sz << 1);
 	}
 	
-	msh_AddNodeToTable(seg_table, new_table_node);
+	new_entry.seg_node = seg_node;
+	new_entry.key = key;
+	new_entry.hash = seg_table->get_hash(key);
+	new_entry.probe_len = 0;
+	msh_InsertEntry(seg_table, &new_entry);
+	
+	seg_table->num_entries += 1;
 }
 
 
 void msh_RemoveSegmentFromTable(SegmentTable_T* seg_table, SegmentNode_T* seg_node, void* key)
 {
+	SegmentTableEntry_T* removed_entry;
+	uint32_T curr_slot, next_slot;
 	
-	SegmentTableNode_T* curr_table_node,* removed_table_node = NULL;
-	uint32_T removed_seg_hash;
+	/* keys may be shared by multiple segments, so match the segment node too */
+	for(removed_entry = msh_FindTableEntry(seg_table, NULL, key);
+	    removed_entry != NULL && removed_entry->seg_node != seg_node;
+	    removed_entry = msh_FindTableEntry(seg_table, removed_entry, key));
 	
-	/* find the segment node immediately preceding this segment node in the table */
-	removed_seg_hash = seg_table->get_hash(seg_table, key);
-	if((curr_table_node = seg_table->table[removed_seg_hash]) == NULL)
+	if(removed_entry == NULL)
 	{
 		meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL | MEU_SEVERITY_FATAL, "TableLogicError", "There was a failure in internal table logic (tried to remove a segment which wasn't in the table).");
 	}
-	else if(curr_table_node->seg_node == seg_node)
-	{
-		removed_table_node = seg_table->table[removed_seg_hash];
-		seg_table->table[removed_seg_hash] = removed_table_node->next;
-	}
-	else
+	
+	/* shift the following entries back rather than leaving a tombstone */
+	curr_slot = (uint32_T)(removed_entry - seg_table->table);
+	for(next_slot = msh_GetNextSlot(seg_table, curr_slot);
+	    seg_table->table[next_slot].seg_node != NULL && seg_table->table[next_slot].probe_len > 0;
+	    curr_slot = next_slot, next_slot = msh_GetNextSlot(seg_table, next_slot))
 	{
-		/* find the segment node immediately preceding this segment node in the table */
-		while(curr_table_node->next->seg_node != seg_node)
-		{
-			curr_table_node = curr_table_node->next;
-			if(curr_table_node->next == NULL)
-			{
-				meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL | MEU_SEVERITY_FATAL, "TableLogicError", "There was a failure in internal table logic (tried to remove a segment which wasn't in the table).");
-			}
-		}
-		removed_table_node = curr_table_node->next;
-		curr_table_node->next = removed_table_node->next;
+		seg_table->table[curr_slot] = seg_table->table[next_slot];
+		seg_table->table[curr_slot].probe_len -= 1;
 	}
+	memset(&seg_table->table[curr_slot], 0, sizeof(SegmentTableEntry_T));
 	
-	mxFree(removed_table_node);
+	seg_table->num_entries -= 1;
 	
 }
 
 
 void msh_DestroyTable(SegmentTable_T* seg_table)
 {
-	SegmentTableNode_T* curr_table_node,* next_table_node;
-	uint32_T curr_seg_hash;
 	if(seg_table->table != NULL)
 	{
-		for(curr_seg_hash = 0; curr_seg_hash < seg_table->table_sz; curr_seg_hash++)
-		{
-			for(curr_table_node = seg_table->table[curr_seg_hash]; curr_table_node != NULL; curr_table_node = next_table_node)
-			{
-				next_table_node = curr_table_node->next;
-				mxFree(curr_table_node);
-			}
-			seg_table->table[curr_seg_hash] = NULL;
-		}
 		mxFree(seg_table->table);
 		seg_table->table = NULL;
 		seg_table->table_sz = 0;
+		seg_table->num_entries = 0;
 	}
 }
 
 
 SegmentNode_T* msh_FindSegmentNode(SegmentTable_T* seg_table, void* key)
 {
-	SegmentTableNode_T* curr_table_node;
-	if(seg_table->table != NULL)
-	{
-		for(curr_table_node = seg_table->table[seg_table->get_hash(seg_table, key)]; curr_table_node != NULL; curr_table_node = curr_table_node->next)
-		{
-			if(seg_table->compare_keys(curr_table_node->key, key))
-			{
-				return curr_table_node->seg_node;
-			}
-		}
-	}
-	return NULL;
+	SegmentTableEntry_T* found_entry = msh_FindTableEntry(seg_table, NULL, key);
+	return (found_entry != NULL)? found_entry->seg_node : NULL;
 }
 
 
-void msh_FindAllSegmentNodes(SegmentTable_T* seg_table, SegmentList_T* seg_list_cache, void* key)
+SegmentTableEntry_T* msh_FindTableEntry(SegmentTable_T* seg_table, SegmentTableEntry_T* prev_entry, void* key)
 {
-	SegmentNode_T* seg_node_copy;
-	SegmentTableNode_T* curr_table_node;
-	memset(seg_list_cache, 0, sizeof(SegmentList_T));
-	if(seg_table->table != NULL)
+	SegmentTableEntry_T* curr_entry;
+	uint32_T hash, curr_slot, probe_len;
+	
+	if(seg_table->table == NULL)
 	{
-		for(curr_table_node = seg_table->table[seg_table->get_hash(seg_table, key)]; curr_table_node != NULL; curr_table_node = curr_table_node->next)
+		return NULL;
+	}
+	
+	if(prev_entry != NULL)
+	{
+		/* matching keys have matching hashes, so continue the same probe sequence */
+		hash = prev_entry->hash;
+		curr_slot = msh_GetNextSlot(seg_table, (uint32_T)(prev_entry - seg_table->table));
+		probe_len = prev_entry->probe_len + 1;
+	}
+	else
+	{
+		hash = seg_table->get_hash(key);
+		curr_slot = msh_GetHomeSlot(seg_table, hash);
+		probe_len = 0;
+	}
+	
+	/* an entry closer to its home slot than the probe means the key cannot be any further */
+	for(curr_entry = &seg_table->table[curr_slot];
+	    curr_entry->seg_node != NULL && curr_entry->probe_len >= probe_len;
+	    curr_slot = msh_GetNextSlot(seg_table, curr_slot), curr_entry = &seg_table->table[curr_slot], probe_len++)
+	{
+		if(curr_entry->hash == hash && seg_table->compare_keys(curr_entry->key, key))
 		{
-			if(seg_table->compare_keys(curr_table_node->key, key))
-			{
-				seg_node_copy = msh_CreateSegmentNode(msh_GetSegmentInfo(curr_table_node->seg_node));
-				msh_AddSegmentToList(seg_list_cache, seg_node_copy);
-				msh_SetVariableNode(seg_node_copy, msh_GetVariableNode(curr_table_node->seg_node));
-			}
+			return curr_entry;
 		}
 	}
+	
+	return NULL;
 }
 
 
-static void msh_ResizeTable(SegmentTable_T* seg_table, uint32_T num_segs)
+static void msh_ResizeTable(SegmentTable_T* seg_table, uint32_T new_table_sz)
 {
 	
-	SegmentTableNode_T* curr_table_node,* next_table_node;
-	SegmentTable_T new_table;
-	uint32_T curr_seg_hash;
+	SegmentTableEntry_T* old_table = seg_table->table;
+	SegmentTableEntry_T curr_entry;
+	uint32_T i, old_table_sz = seg_table->table_sz;
 	
-	if(seg_table->table_sz >= (uint32_T)(1 << 31))
+	if(old_table_sz >= ((uint32_T)1 << 31))
 	{
 		/* dont do anything if we approach the max size for some reason */
 		return;
 	}
 	
-	/* copy any immutable members */
-	new_table = *seg_table;
-	new_table.table_sz = msh_FindNewTableSize(num_segs);
-	new_table.table = mxCalloc(new_table.table_sz, sizeof(SegmentTableNode_T*));
-	mexMakeMemoryPersistent(new_table.table);
+	seg_table->table = mxCalloc(new_table_sz, sizeof(SegmentTableEntry_T));
+	mexMakeMemoryPersistent(seg_table->table);
+	seg_table->table_sz = new_table_sz;
 	
-	for(curr_seg_hash = 0; curr_seg_hash < seg_table->table_sz; curr_seg_hash++)
+	for(i = 0; i < old_table_sz; i++)
 	{
-		for(curr_table_node = seg_table->table[curr_seg_hash]; curr_table_node != NULL; curr_table_node = next_table_node)
+		if(old_table[i].seg_node != NULL)
 		{
-			next_table_node = curr_table_node->next;
-			msh_AddNodeToTable(&new_table, curr_table_node);
+			curr_entry = old_table[i];
+			curr_entry.probe_len = 0;
+			msh_InsertEntry(seg_table, &curr_entry);
 		}
 	}
 	
-	mxFree(seg_table->table);
-	seg_table->table = new_table.table;
-	seg_table->table_sz = new_table.table_sz;
+	mxFree(old_table);
 	
 }
 
 
-static void msh_AddNodeToTable(SegmentTable_T* seg_table, SegmentTableNode_T* new_table_node)
+static void msh_InsertEntry(SegmentTable_T* seg_table, SegmentTableEntry_T* new_entry)
 {
-	SegmentTableNode_T* curr_table_node;
-	uint32_T seg_hash = seg_table->get_hash(seg_table, new_table_node->key);
+	SegmentTableEntry_T displaced_entry;
+	uint32_T curr_slot;
 	
-	if(seg_table->table[seg_hash] == NULL)
+	for(curr_slot = msh_GetHomeSlot(seg_table, new_entry->hash); seg_table->table[curr_slot].seg_node != NULL; curr_slot = msh_GetNextSlot(seg_table, curr_slot))
 	{
-		seg_table->table[seg_hash] = new_table_node;
-	}
-	else
-	{
-		curr_table_node = seg_table->table[seg_hash];
-		while(curr_table_node->next != NULL)
+		/* take the slot from an entry which is closer to its home slot */
+		if(seg_table->table[curr_slot].probe_len < new_entry->probe_len)
 		{
-			curr_table_node = curr_table_node->next;
+			displaced_entry = seg_table->table[curr_slot];
+			seg_table->table[curr_slot] = *new_entry;
+			*new_entry = displaced_entry;
 		}
-		curr_table_node->next = new_table_node;
+		new_entry->probe_len += 1;
 	}
-
-	/* make sure next is NULL in case we are resizing */
-	new_table_node->next = NULL;
 	
-}
-
-
-static uint32_T msh_FindNewTableSize(uint32_T curr_sz)
-{
-	if(curr_sz < MSH_INIT_TABLE_SIZE)
-	{
-		return MSH_INIT_TABLE_SIZE;
-	}
-	else
-	{
-		return curr_sz << 1;
-	}
+	seg_table->table[curr_slot] = *new_entry;
 }
@@ -0,0 +1,133 @@
+/** mshthreads.c
+ * Defines functions for running work on native threads.
+ *
+ * Copyright © 2018 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "mex.h"
+
+#include "mshthreads.h"
+
+#ifdef MSH_UNIX
+#  include <unistd.h>
+#  include <pthread.h>
+#  include <time.h>
+#endif
+
+typedef struct ThreadStart_T
+{
+	ThreadFunction_T thread_function;
+	void*            thread_arg;
+#ifdef MSH_WIN
+	HANDLE           thread_handle;
+#else
+	pthread_t        thread_handle;
+#endif
+	int              is_started;
+} ThreadStart_T;
+
+
+/**
+ * The native entry point for started threads.
+ *
+ * @param thread_start The ThreadStart_T for this thread.
+ * @return Nothing.
+ */
+#ifdef MSH_WIN
+static DWORD WINAPI msh_ThreadEntry(LPVOID thread_start);
+#else
+static void* msh_ThreadEntry(void* thread_start);
+#endif
+
+
+size_t msh_GetNumProcessors(void)
+{
+#ifdef MSH_WIN
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	return (size_t)system_info.dwNumberOfProcessors;
+#else
+	long num_procs = sysconf(_SC_NPROCESSORS_ONLN);
+	return (num_procs > 0)? (size_t)num_procs : 1;
+#endif
+}
+
+
+void msh_RunThreads(ThreadFunction_T thread_function, void* thread_args, size_t arg_size, size_t num_threads)
+{
+	size_t         i;
+	ThreadStart_T* thread_starts;
+	
+	if(num_threads == 0)
+	{
+		return;
+	}
+	
+	thread_starts = mxMalloc(num_threads*sizeof(ThreadStart_T));
+	for(i = 1; i < num_threads; i++)
+	{
+		thread_starts[i].thread_function = thread_function;
+		thread_starts[i].thread_arg = (byte_T*)thread_args + i*arg_size;
+#ifdef MSH_WIN
+		thread_starts[i].thread_handle = CreateThread(NULL, 0, msh_ThreadEntry, &thread_starts[i], 0, NULL);
+		thread_starts[i].is_started = (thread_starts[i].thread_handle != NULL);
+#else
+		thread_starts[i].is_started = (pthread_create(&thread_starts[i].thread_handle, NULL, msh_ThreadEntry, &thread_starts[i]) == 0);
+#endif
+	}
+	
+	thread_function(thread_args);
+	
+	for(i = 1; i < num_threads; i++)
+	{
+		if(thread_starts[i].is_started)
+		{
+#ifdef MSH_WIN
+			WaitForSingleObject(thread_starts[i].thread_handle, INFINITE);
+			CloseHandle(thread_starts[i].thread_handle);
+#else
+			pthread_join(thread_starts[i].thread_handle, NULL);
+#endif
+		}
+		else
+		{
+			thread_function(thread_starts[i].thread_arg);
+		}
+	}
+	
+	mxFree(thread_starts);
+	
+}
+
+
+double msh_GetTime(void)
+{
+#ifdef MSH_WIN
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+	struct timespec curr_time;
+	clock_gettime(CLOCK_MONOTONIC, &curr_time);
+	return (double)curr_time.tv_sec + (double)curr_time.tv_nsec*1e-9;
+#endif
+}
+
+
+#ifdef MSH_WIN
+static DWORD WINAPI msh_ThreadEntry(LPVOID thread_start)
+{
+	((ThreadStart_T*)thread_start)->thread_function(((ThreadStart_T*)thread_start)->thread_arg);
+	return 0;
+}
+#else
+static void* msh_ThreadEntry(void* thread_start)
+{
+	((ThreadStart_T*)thread_start)->thread_function(((ThreadStart_T*)thread_start)->thread_arg);
+	return NULL;
+}
+#endif
@@ -17,6 +17,54 @@
 #include "mshvariables.h"
 #include "mshlockfree.h"
 #include "mlerrorutils.h"
+#include "mshthreads.h"
+
+/* the byte lane stride used to shuffle data before compression; the size of the widest element */
+#define MSH_SHUFFLE_STRIDE 8
+
+/* run-length encoding control bytes below this are literal runs */
+#define MSH_RLE_LITERAL_MAX 0x80
+#define MSH_RLE_REPEAT_MIN  3
+#define MSH_RLE_REPEAT_MAX  (0xFF - MSH_RLE_LITERAL_MAX + MSH_RLE_REPEAT_MIN)
+
+/* the size of each positional read issued by the bulk file reader */
+#define MSH_READ_CHUNK_SIZE 0x800000
+
+typedef struct ReadChunk_T
+{
+	handle_T file_handle;
+	size_t   file_offset;
+	byte_T*  dest;
+	size_t   size;
+} ReadChunk_T;
+
+typedef struct ReadWorker_T
+{
+	ReadChunk_T* chunks;
+	size_t       num_chunks;
+	size_t       first_chunk;
+	size_t       chunk_stride;
+	int          error_code;
+} ReadWorker_T;
+
+/**
+ * Shuffles or unshuffles bytes between the buffer order and lanes of MSH_SHUFFLE_STRIDE. The tail
+ * which doesn't fill a row is copied in place.
+ *
+ * @param dest The destination buffer.
+ * @param src The source buffer.
+ * @param buf_sz The size of the buffers.
+ * @param will_unshuffle Whether to move the bytes from lane order back to buffer order.
+ */
+static void msh_ShuffleBytes(uint8_T* dest, const uint8_T* src, size_t buf_sz, int will_unshuffle);
+
+
+/**
+ * Reads every chunk_stride-th chunk starting at first_chunk. Runs on a worker thread.
+ *
+ * @param read_worker The ReadWorker_T for this thread. The error code is set on failure.
+ */
+static void msh_ReadChunks(void* read_worker);
 
 #ifdef MSH_UNIX
 #  include <string.h>
@@ -330,3 +378,248 @@ uint32_T msh_MurmurHash3(const uint8_T* key, size_t len, int seed)
 	h ^= h >> 16u;
 	return h;
 }
+
+
+size_t msh_FindCompressedBound(size_t src_sz)
+{
+	/* worst case is one control byte for every literal run */
+	return src_sz + src_sz/MSH_RLE_LITERAL_MAX + 1;
+}
+
+
+size_t msh_Compress(uint8_T* dest, const uint8_T* src, size_t src_sz)
+{
+	size_t   src_idx, run_len, lit_ctrl_idx, dest_idx = 0;
+	uint8_T  curr_byte;
+	uint8_T* shuf_src = mxMalloc(src_sz > 0? src_sz : 1);
+	
+	msh_ShuffleBytes(shuf_src, src, src_sz, FALSE);
+	
+#define msh_ShuffledByte(IDX) shuf_src[(IDX)]
+	
+	for(src_idx = 0; src_idx < src_sz;)
+	{
+		curr_byte = msh_ShuffledByte(src_idx);
+		for(run_len = 1; src_idx + run_len < src_sz && run_len < MSH_RLE_REPEAT_MAX && msh_ShuffledByte(src_idx + run_len) == curr_byte; run_len++);
+		
+		if(run_len >= MSH_RLE_REPEAT_MIN)
+		{
+			dest[dest_idx++] = (uint8_T)(run_len - MSH_RLE_REPEAT_MIN + MSH_RLE_LITERAL_MAX);
+			dest[dest_idx++] = curr_byte;
+			src_idx += run_len;
+		}
+		else
+		{
+			/* copy literals until the next repeated run */
+			lit_ctrl_idx = dest_idx++;
+			for(run_len = 0; src_idx < src_sz && run_len < MSH_RLE_LITERAL_MAX; run_len++, src_idx++)
+			{
+				curr_byte = msh_ShuffledByte(src_idx);
+				if(run_len > 0 && src_idx + 2 < src_sz && msh_ShuffledByte(src_idx + 1) == curr_byte && msh_ShuffledByte(src_idx + 2) == curr_byte)
+				{
+					break;
+				}
+				dest[dest_idx++] = curr_byte;
+			}
+			dest[lit_ctrl_idx] = (uint8_T)(run_len - 1);
+		}
+	}
+	
+#undef msh_ShuffledByte
+	
+	mxFree(shuf_src);
+	
+	return dest_idx;
+}
+
+
+void msh_Decompress(uint8_T* dest, size_t dest_sz, const uint8_T* src, size_t src_sz)
+{
+	size_t   src_idx, run_len, dest_idx = 0;
+	uint8_T* shuf_dest = mxMalloc(dest_sz > 0? dest_sz : 1);
+	
+	for(src_idx = 0; src_idx < src_sz; )
+	{
+		if(src[src_idx] < MSH_RLE_LITERAL_MAX)
+		{
+			run_len = (size_t)src[src_idx++] + 1;
+			if(src_idx + run_len > src_sz || dest_idx + run_len > dest_sz)
+			{
+				break;
+			}
+			for(; run_len > 0; run_len--)
+			{
+				shuf_dest[dest_idx++] = src[src_idx++];
+			}
+		}
+		else
+		{
+			run_len = (size_t)src[src_idx++] - MSH_RLE_LITERAL_MAX + MSH_RLE_REPEAT_MIN;
+			if(src_idx >= src_sz || dest_idx + run_len > dest_sz)
+			{
+				break;
+			}
+			for(; run_len > 0; run_len--)
+			{
+				shuf_dest[dest_idx++] = src[src_idx];
+			}
+			src_idx++;
+		}
+	}
+	
+	if(src_idx != src_sz || dest_idx != dest_sz)
+	{
+		mxFree(shuf_dest);
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL | MEU_SEVERITY_CORRUPTION, "DecompressionError", "The compressed segment could not be decompressed. The segment may have been corrupted.");
+	}
+	
+	msh_ShuffleBytes(dest, shuf_dest, dest_sz, TRUE);
+	mxFree(shuf_dest);
+}
+
+
+int msh_ReadFiles(void* dest, const handle_T* file_handles, const size_t* file_sizes, size_t num_files, size_t num_threads)
+{
+	size_t        i, file_offset, num_chunks, chunk_num;
+	byte_T*       curr_dest = dest;
+	ReadChunk_T*  chunks;
+	ReadWorker_T* read_workers;
+	int           error_code = 0;
+	
+	for(i = 0, num_chunks = 0; i < num_files; i++)
+	{
+		num_chunks += (file_sizes[i] + MSH_READ_CHUNK_SIZE - 1)/MSH_READ_CHUNK_SIZE;
+	}
+	
+	if(num_chunks == 0)
+	{
+		return 0;
+	}
+	
+	/* lay out the chunks in order so that neighbouring threads read neighbouring chunks */
+	chunks = mxMalloc(num_chunks*sizeof(ReadChunk_T));
+	for(i = 0, chunk_num = 0; i < num_files; i++)
+	{
+		for(file_offset = 0; file_offset < file_sizes[i]; file_offset += MSH_READ_CHUNK_SIZE, chunk_num++)
+		{
+			chunks[chunk_num].file_handle = file_handles[i];
+			chunks[chunk_num].file_offset = file_offset;
+			chunks[chunk_num].dest = curr_dest + file_offset;
+			chunks[chunk_num].size = MIN(MSH_READ_CHUNK_SIZE, file_sizes[i] - file_offset);
+		}
+		curr_dest += file_sizes[i];
+	}
+	
+	num_threads = MAX(MIN(num_threads, num_chunks), 1);
+	read_workers = mxMalloc(num_threads*sizeof(ReadWorker_T));
+	for(i = 0; i < num_threads; i++)
+	{
+		read_workers[i].chunks = chunks;
+		read_workers[i].num_chunks = num_chunks;
+		read_workers[i].first_chunk = i;
+		read_workers[i].chunk_stride = num_threads;
+		read_workers[i].error_code = 0;
+	}
+	
+	msh_RunThreads(msh_ReadChunks, read_workers, sizeof(ReadWorker_T), num_threads);
+	
+	for(i = 0; i < num_threads && error_code == 0; i++)
+	{
+		error_code = read_workers[i].error_code;
+	}
+	
+	mxFree(read_workers);
+	mxFree(chunks);
+	
+	return error_code;
+}
+
+
+static void msh_ReadChunks(void* read_worker)
+{
+	size_t        i, num_read, num_left;
+	ReadWorker_T* worker = read_worker;
+	ReadChunk_T*  curr_chunk;
+#ifdef MSH_WIN
+	DWORD         win_num_read;
+	OVERLAPPED    overlapped;
+#else
+	ssize_t       ret_num_read;
+#endif
+	
+	for(i = worker->first_chunk; i < worker->num_chunks; i += worker->chunk_stride)
+	{
+		curr_chunk = worker->chunks + i;
+		for(num_read = 0; num_read < curr_chunk->size; num_read += num_left)
+		{
+			num_left = curr_chunk->size - num_read;
+#ifdef MSH_WIN
+			memset(&overlapped, 0, sizeof(OVERLAPPED));
+			overlapped.Offset = (DWORD)((curr_chunk->file_offset + num_read) & 0xFFFFFFFF);
+#  if MSH_BITNESS == 64
+			overlapped.OffsetHigh = (DWORD)((curr_chunk->file_offset + num_read) >> 32);
+#  endif
+			if(ReadFile(curr_chunk->file_handle, curr_chunk->dest + num_read, (DWORD)num_left, &win_num_read, &overlapped) == 0)
+			{
+				worker->error_code = (int)GetLastError();
+				return;
+			}
+			if(win_num_read == 0)
+			{
+				worker->error_code = ERROR_HANDLE_EOF;
+				return;
+			}
+			num_left = win_num_read;
+#else
+			ret_num_read = pread(curr_chunk->file_handle, curr_chunk->dest + num_read, num_left, (off_t)(curr_chunk->file_offset + num_read));
+			if(ret_num_read < 0)
+			{
+				if(errno == EINTR)
+				{
+					num_left = 0;
+					continue;
+				}
+				worker->error_code = errno;
+				return;
+			}
+			if(ret_num_read == 0)
+			{
+				/* the file was truncated while reading */
+				worker->error_code = EIO;
+				return;
+			}
+			num_left = (size_t)ret_num_read;
+#endif
+		}
+	}
+}
+
+
+static void msh_ShuffleBytes(uint8_T* dest, const uint8_T* src, size_t buf_sz, int will_unshuffle)
+{
+	size_t         lane, row;
+	size_t         num_rows = buf_sz/MSH_SHUFFLE_STRIDE;
+	uint8_T*       lane_dest = dest;
+	const uint8_T* lane_src = src;
+	
+	/* walk each lane with a stride so there is no division per byte */
+	for(lane = 0; lane < MSH_SHUFFLE_STRIDE; lane++)
+	{
+		if(will_unshuffle)
+		{
+			for(row = 0, lane_dest = dest + lane; row < num_rows; row++, lane_dest += MSH_SHUFFLE_STRIDE)
+			{
+				*lane_dest = *lane_src++;
+			}
+		}
+		else
+		{
+			for(row = 0, lane_src = src + lane; row < num_rows; row++, lane_src += MSH_SHUFFLE_STRIDE)
+			{
+				*lane_dest++ = *lane_src;
+			}
+		}
+	}
+	
+	memcpy(dest + num_rows*MSH_SHUFFLE_STRIDE, src + num_rows*MSH_SHUFFLE_STRIDE, buf_sz - num_rows*MSH_SHUFFLE_STRIDE);
+}
@@ -16,6 +16,7 @@
 #include "mshutils.h"
 #include "mshexterntypes.h"
 #include "mshlockfree.h"
+#include "mshprocs.h"
 
 /* may have been disabled for R2018a+ */
 #ifdef mxCreateSharedDataCopy
@@ -25,6 +26,7 @@
 /* undocumented function */
 extern mxArray* mxCreateSharedDataCopy(const mxArray *);
 
+
 /** public function definitions **/
 
 VariableNode_T* msh_CreateVariable(SegmentNode_T* seg_node)
@@ -47,6 +49,34 @@ VariableNode_T* msh_CreateVariable(SegmentNode_T* seg_node)
 }
 
 
+VariableNode_T* msh_CreateSubVariable(SegmentNode_T* seg_node, SharedVariableHeader_T* sub_header)
+{
+	
+	mxArray* new_var;
+	VariableNode_T* new_var_node;
+	
+	new_var = msh_FetchVariable(sub_header);
+	
+	/* Important! Make sure MATLAB doesn't try to free this since the data points to a non-allocated address. */
+	mexMakeArrayPersistent(new_var);
+	
+	/* don't replace the primary variable of the segment */
+	new_var_node = msh_CreateVariableNode(NULL, new_var);
+	msh_SetSegmentNode(new_var_node, seg_node);
+	
+	/* push to the front of the sub-variables of this segment */
+	msh_SetNextSubVariable(new_var_node, msh_GetSubVariableNode(seg_node));
+	if(msh_GetSubVariableNode(seg_node) != NULL)
+	{
+		msh_SetPreviousSubVariable(msh_GetSubVariableNode(seg_node), new_var_node);
+	}
+	msh_SetSubVariableNode(seg_node, new_var_node);
+	
+	return new_var_node;
+	
+}
+
+
 int msh_DestroyVariable(VariableNode_T* var_node)
 {
 	SegmentNode_T* seg_node = msh_GetSegmentNode(var_node);
@@ -57,12 +87,31 @@ int msh_DestroyVariable(VariableNode_T* var_node)
 	mxDestroyArray(msh_GetVariableData(var_node));
 	
 	/* remove tracking for this variable */
-	msh_SetVariableNode(seg_node, NULL);
+	if(msh_GetVariableNode(seg_node) == var_node)
+	{
+		msh_SetVariableNode(seg_node, NULL);
+	}
+	else
+	{
+		if(msh_GetPreviousSubVariable(var_node) != NULL)
+		{
+			msh_SetNextSubVariable(msh_GetPreviousSubVariable(var_node), msh_GetNextSubVariable(var_node));
+		}
+		else
+		{
+			msh_SetSubVariableNode(seg_node, msh_GetNextSubVariable(var_node));
+		}
+		
+		if(msh_GetNextSubVariable(var_node) != NULL)
+		{
+			msh_SetPreviousSubVariable(msh_GetNextSubVariable(var_node), msh_GetPreviousSubVariable(var_node));
+		}
+	}
 
 	if(msh_GetIsUsed(var_node))
 	{
 		msh_SetIsUsed(var_node, FALSE);
-		if((msh_AtomicDecrement(&msh_GetSegmentMetadata(seg_node)->procs_using) == 0) &&
+		if((msh_DecrementProcsUsing(msh_GetSegmentMetadata(seg_node)) == 0) &&
 		   g_user_config.will_shared_gc &&
 		   !msh_GetSegmentMetadata(seg_node)->is_persistent)
 		{
@@ -93,15 +142,45 @@ void msh_ClearVariableList(VariableList_T* var_list)
 }
 
 
-void msh_CleanVariableList(VariableList_T* var_list, int shared_gc_override)
+void msh_CleanVariableList(VariableList_T* var_list, size_t max_nodes, int shared_gc_override)
 {
-	VariableNode_T* curr_var_node, * next_var_node;
+	VariableNode_T* curr_var_node;
 	SegmentNode_T* curr_seg_node;
+	SegmentNode_T* dead_seg_nodes[MSH_RECLAIM_BATCH_SIZE];
+	size_t num_inspected, num_dead = 0;
+	int will_remove_segment;
+	
+	/* start a new pass if the last one finished or if the entire list is to be swept */
+	if(var_list->sweep_node == NULL || max_nodes == SIZE_MAX)
+	{
+		var_list->sweep_node = var_list->first;
+	}
 	
-	for(curr_var_node = var_list->first; curr_var_node != NULL; curr_var_node = next_var_node)
+	/* removing a node from the list advances the sweep node past it, so it stays valid even if detaching destroys other variables */
+	for(num_inspected = 0; var_list->sweep_node != NULL && num_inspected < max_nodes; num_inspected++)
 	{
-		next_var_node = msh_GetNextVariable(curr_var_node);
-		if(met_GetCrosslink(msh_GetVariableData(curr_var_node)) == NULL && msh_GetIsUsed(curr_var_node))
+		curr_var_node = var_list->sweep_node;
+		var_list->sweep_node = msh_GetNextVariable(curr_var_node);
+		if(met_GetCrosslink(msh_GetVariableData(curr_var_node)) == NULL && msh_GetVariableNode(msh_GetSegmentNode(curr_var_node)) != curr_var_node)
+		{
+			/* sub-variables are not reused, so destroy them as soon as they are unused */
+			curr_seg_node = msh_GetSegmentNode(curr_var_node);
+			
+			will_remove_segment = msh_GetIsUsed(curr_var_node)
+			                      && msh_DecrementProcsUsing(msh_GetSegmentMetadata(curr_seg_node)) == 0
+			                      && (g_user_config.will_shared_gc || shared_gc_override)
+			                      && !msh_GetSegmentMetadata(curr_seg_node)->is_persistent;
+			
+			msh_SetIsUsed(curr_var_node, FALSE);
+			msh_RemoveVariableFromList(curr_var_node);
+			msh_DestroyVariable(curr_var_node);
+			
+			if(will_remove_segment)
+			{
+				dead_seg_nodes[num_dead++] = curr_seg_node;
+			}
+		}
+		else if(met_GetCrosslink(msh_GetVariableData(curr_var_node)) == NULL && msh_GetIsUsed(curr_var_node))
 		{
 			curr_seg_node = msh_GetSegmentNode(curr_var_node);
 			
@@ -109,16 +188,22 @@ void msh_CleanVariableList(VariableList_T* var_list, int shared_gc_override)
 			msh_SetIsUsed(curr_var_node, FALSE);
 			
 			/* decrement number of processes using this variable; if this is the last variable then GC */
-			if(msh_AtomicDecrement(&msh_GetSegmentMetadata(curr_seg_node)->procs_using) == 0
+			if(msh_DecrementProcsUsing(msh_GetSegmentMetadata(curr_seg_node)) == 0
 			   && (g_user_config.will_shared_gc || shared_gc_override)
 			   && !msh_GetSegmentMetadata(curr_seg_node)->is_persistent)
 			{
-				msh_RemoveSegmentFromSharedList(curr_seg_node);
-				msh_RemoveSegmentFromList(curr_seg_node);
-				msh_DetachSegment(curr_seg_node);
+				dead_seg_nodes[num_dead++] = curr_seg_node;
 			}
 		}
+		
+		if(num_dead == MSH_RECLAIM_BATCH_SIZE)
+		{
+			msh_ReclaimSegments(dead_seg_nodes, num_dead);
+			num_dead = 0;
+		}
 	}
+	
+	msh_ReclaimSegments(dead_seg_nodes, num_dead);
 }
 
 
@@ -160,7 +245,12 @@ mxArray* msh_CreateSharedDataCopy(VariableNode_T* var_node, int will_set_used)
 	if(!msh_GetIsUsed(var_node) && will_set_used)
 	{
 		msh_SetIsUsed(var_node, TRUE);
-		msh_AtomicIncrement(&msh_GetSegmentMetadata(msh_GetSegmentNode(var_node))->procs_using);
+		msh_IncrementProcsUsing(msh_GetSegmentMetadata(msh_GetSegmentNode(var_node)));
+	}
+	
+	if(msh_GetSegmentNode(var_node) != NULL)
+	{
+		msh_TouchSegment(msh_GetSegmentNode(var_node));
 	}
 	
 	if(mxIsEmpty(var) && !mxIsSparse(var))
@@ -201,6 +291,11 @@ void msh_RemoveVariableFromList(VariableNode_T* var_node)
 		msh_RemoveSegmentFromTable(var_list->mvar_table, msh_GetSegmentNode(var_node), msh_GetVariableData(var_node));
 	}
 	
+	if(var_list->sweep_node == var_node)
+	{
+		var_list->sweep_node = msh_GetNextVariable(var_node);
+	}
+	
 	/* reset references in prev and next var node */
 	if(msh_GetPreviousVariable(var_node) != NULL)
 	{
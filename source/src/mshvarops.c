@@ -14,6 +14,64 @@
 #include "mshutils.h"
 #include "mshlockfree.h"
 #include "mlerrorutils.h"
+#include "mshsimd.h"
+#include "mshthreads.h"
+
+/* variable operations are only split across threads if each thread gets at least this many elements */
+#define MSH_VAROP_THREAD_MIN_ELEMS 0x40000
+
+/* thread chunks are a multiple of this many elements so that threads do not write to the same cache lines
+ * (this only holds for whole variables, which are the only writes split across threads) */
+#define MSH_VAROP_THREAD_ALIGN 64
+
+/* the partial result of a reduction, which is merged across threads */
+typedef struct ReduceAccum_T
+{
+	double   sum;
+	uint64_T count;
+	int      has_extreme;
+	union
+	{
+		int8_T   Int8;
+		int16_T  Int16;
+		int32_T  Int32;
+		int64_T  Int64;
+		uint8_T  UInt8;
+		uint16_T UInt16;
+		uint32_T UInt32;
+		uint64_T UInt64;
+		single   Single;
+		double   Double;
+	} extreme;
+} ReduceAccum_T;
+
+typedef void (*reducevaropfcn_T)(WideInput_T*, ReduceAccum_T*);
+
+typedef struct VarOpWorker_T
+{
+	unaryvaropfcn_T   unary_fcn;            /* exactly one of the functions is set */
+	binaryvaropfcn_T  binary_fcn;
+	ternaryvaropfcn_T ternary_fcn;
+	reducevaropfcn_T  reduce_fcn;
+	int8_T*          dest_real_anchor;
+	int8_T*          dest_imag_anchor;      /* NULL if the destination is real */
+	size_t           dest_elem_size;
+	mxClassID        dest_mxtype;
+	WideInput_T      wide_in_real;          /* holds the start of the input and its total number of elements */
+	WideInput_T      wide_in_imag;
+	size_t           in_elem_size;
+	WideInput_T      wide_in2_real;         /* the second input of a ternary operation */
+	size_t           in2_elem_size;
+	const mwIndex*   start_idxs;
+	const mwSize*    slice_lens;
+	size_t           num_lens;
+	size_t           group_len;             /* the sum of the slice lengths */
+	size_t           first_elem;
+	size_t           end_elem;
+	long             opts;
+	ReduceAccum_T    reduce_real;           /* the results of a reduction */
+	ReduceAccum_T    reduce_imag;
+} VarOpWorker_T;
 
 static size_t msh_ParseIndicesWorker(mxArray*      subs_arr,
                                      const mwSize* dest_dims,
@@ -29,12 +87,74 @@ static size_t msh_ParseIndicesWorker(mxArray*      subs_arr,
 
 static void msh_CheckInputSize(mxArray* subs_arr, const mxArray* in_var, const size_t* dest_dims, size_t dest_num_dims);
 
+
+/**
+ * Runs the variable operation over the indexed elements of the destination,
+ * splitting them across threads if there are enough of them. Indexed
+ * selections which are modified run on one thread since indices may repeat.
+ *
+ * @param varop_worker The operation to run. The slices and element range are set here.
+ * @param indices The parsed indices, or NULL indices if the entire destination is used.
+ * @param dest_num_elems The number of elements in the destination.
+ */
+static void msh_RunVariableOperation(VarOpWorker_T* varop_worker, const ParsedIndices_T* indices, size_t dest_num_elems);
+
+
+/**
+ * Runs the variable operation on the elements from first_elem up to end_elem,
+ * counted in the order the slices are selected. Runs on a worker thread.
+ *
+ * @param varop_worker The VarOpWorker_T for this thread.
+ */
+static void msh_RunVarOpChunk(void* varop_worker);
+
+
+/**
+ * Merges the partial result of a reduction from another thread.
+ *
+ * @param reduce_fcn The reduction, used to merge the extremes.
+ * @param accum The result to merge into.
+ * @param part The partial result.
+ */
+static void msh_MergeReduction(reducevaropfcn_T reduce_fcn, ReduceAccum_T* accum, ReduceAccum_T* part);
+
+
+/**
+ * Creates an array of the class, which may be numeric, logical, or char.
+ *
+ * @param class_id The class of the array.
+ * @param num_dims The number of dimensions.
+ * @param dims The dimensions.
+ * @param is_complex Whether the array should be complex.
+ * @return The new array.
+ */
+static mxArray* msh_CreateArrayOfClass(mxClassID class_id, size_t num_dims, const mwSize* dims, int is_complex);
+
+
+/**
+ * Copies the elements of the destination which a variable operation affects.
+ * Only the indexed elements are copied for numeric, logical, and char
+ * destinations, in the shape MATLAB would give them. Otherwise the entire
+ * destination is copied.
+ *
+ * @param indexed_var The indexed destination.
+ * @param subs_struct The subscript struct used for the indexing, or NULL.
+ * @return A new array holding the copy.
+ */
+static mxArray* msh_CopyAffectedValues(IndexedVariable_T* indexed_var, const mxArray* subs_struct);
+
+
 int msh_GetNumVarOpArgs(msh_varop_T varop)
 {
 	switch(varop)
 	{
 		case(VAROP_ABS):
-		case(VAROP_NEG): return 1;
+		case(VAROP_NEG):
+		case(VAROP_SUM):
+		case(VAROP_MINVAL):
+		case(VAROP_MAXVAL):
+		case(VAROP_ANY):
+		case(VAROP_NNZ): return 1;
 		case(VAROP_ADD):
 		case(VAROP_SUB):
 		case(VAROP_MUL):
@@ -43,13 +163,35 @@ int msh_GetNumVarOpArgs(msh_varop_T varop)
 		case(VAROP_MOD):
 		case(VAROP_ARS):
 		case(VAROP_ALS):
-		case(VAROP_CPY): return 2;
+		case(VAROP_CPY):
+		case(VAROP_MIN):
+		case(VAROP_MAX):
+		case(VAROP_AND):
+		case(VAROP_OR):
+		case(VAROP_XOR): return 2;
+		case(VAROP_AXPY):
+		case(VAROP_FMA):
+		case(VAROP_CLAMP): return 3;
 		default:   meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "UnrecognizedVarOpError", "Unrecognized variable operation.");
 	}
 	return 0;
 }
 
 
+int msh_IsReadOnlyVarOp(msh_varop_T varop)
+{
+	switch(varop)
+	{
+		case(VAROP_SUM):
+		case(VAROP_MINVAL):
+		case(VAROP_MAXVAL):
+		case(VAROP_ANY):
+		case(VAROP_NNZ): return TRUE;
+		default:         return FALSE;
+	}
+}
+
+
 IndexedVariable_T msh_ParseSubscriptStruct(const mxArray* parent_var, const mxArray* subs_struct)
 {
 	size_t            i, num_idxs;
@@ -963,6 +1105,11 @@ void msh_CompareVariableSize(IndexedVariable_T* indexed_var, const mxArray* in_v
 					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "ComplexVarOpError", "Variable operations other than overwriting are not available.");
 				}
 				
+				if((varop == VAROP_AND || varop == VAROP_OR || varop == VAROP_XOR) && (dest_class_id == mxDOUBLE_CLASS || dest_class_id == mxSINGLE_CLASS))
+				{
+					meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "BitwiseFloatError", "Bitwise variable operations are only available for destinations of integer or logical class.");
+				}
+				
 				/*
 				 * Rules:
 				 * floats may operate with floats
@@ -1031,7 +1178,49 @@ void msh_CompareVariableSize(IndexedVariable_T* indexed_var, const mxArray* in_v
 #define VO_FCN_CTCNAME(TYPEN) VO_FCN_CTCNAME_(TYPEN)
 #define VO_FCN_TCNAME(TYPEN1, TYPEN2) VO_FCN_TCNAME_(TYPEN1, TYPEN2)
 
+/* maps the names used by the runners to the operation and class IDs used by the vector kernels */
+#define VO_VAROP_Add VAROP_ADD
+#define VO_VAROP_Sub VAROP_SUB
+#define VO_VAROP_Mul VAROP_MUL
+#define VO_VAROP_Div VAROP_DIV
+#define VO_VAROP_Rem VAROP_REM
+#define VO_VAROP_Mod VAROP_MOD
+#define VO_VAROP_ARS VAROP_ARS
+#define VO_VAROP_ALS VAROP_ALS
+#define VO_VAROP_Min VAROP_MIN
+#define VO_VAROP_Max VAROP_MAX
+#define VO_VAROP_And VAROP_AND
+#define VO_VAROP_Or  VAROP_OR
+#define VO_VAROP_Xor VAROP_XOR
+
+#define VO_MXCLASS_Int8   mxINT8_CLASS
+#define VO_MXCLASS_Int16  mxINT16_CLASS
+#define VO_MXCLASS_Int32  mxINT32_CLASS
+#define VO_MXCLASS_Int64  mxINT64_CLASS
+#define VO_MXCLASS_UInt8  mxUINT8_CLASS
+#define VO_MXCLASS_UInt16 mxUINT16_CLASS
+#define VO_MXCLASS_UInt32 mxUINT32_CLASS
+#define VO_MXCLASS_UInt64 mxUINT64_CLASS
+#define VO_MXCLASS_Single mxSINGLE_CLASS
+#define VO_MXCLASS_Double mxDOUBLE_CLASS
+
+#define VO_FCN_VAROP_(OP) VO_VAROP_##OP
+#define VO_FCN_MXCLASS_(TYPEN) VO_MXCLASS_##TYPEN
+
+#define VO_FCN_VAROP(OP) VO_FCN_VAROP_(OP)
+#define VO_FCN_MXCLASS(TYPEN) VO_FCN_MXCLASS_(TYPEN)
+
+/* mixed type inputs are converted in blocks of this many elements on the stack */
+#define MSH_CONVERT_BLOCK_SIZE 256
+
+#define VO_FCN_BTCNAME_(TYPEN1, TYPEN2) msh_BTC##TYPEN1##From##TYPEN2
+#define VO_FCN_BCTCNAME_(TYPEN) msh_Choose##TYPEN##BlockConverter
+
+#define VO_FCN_BTCNAME(TYPEN1, TYPEN2) VO_FCN_BTCNAME_(TYPEN1, TYPEN2)
+#define VO_FCN_BCTCNAME(TYPEN) VO_FCN_BCTCNAME_(TYPEN)
+
 #define FW_INT_TYPEC(SIZE) int##SIZE##conv_T
+#define FW_INT_TYPEBC(SIZE) int##SIZE##bconv_T
 #define FW_INT_TYPEN(SIZE) Int##SIZE
 #define FW_INT_TYPE(SIZE) int##SIZE##_T
 #define FW_INT_MAX(SIZE) INT##SIZE##_MAX
@@ -1040,10 +1229,12 @@ void msh_CompareVariableSize(IndexedVariable_T* indexed_var, const mxArray* in_v
 #define FW_INT_FCN_RNAME(OP, SIZE) VO_FCN_RNAME(OP, FW_INT_TYPEN(SIZE))
 #define FW_INT_FCN_FNAME(OP, SIZE) VO_FCN_FNAME(OP, FW_INT_TYPEN(SIZE))
 #define FW_INT_FCN_CTCNAME(SIZE) VO_FCN_CTCNAME(FW_INT_TYPEN(SIZE))
+#define FW_INT_FCN_BCTCNAME(SIZE) VO_FCN_BCTCNAME(FW_INT_TYPEN(SIZE))
 #define FW_II_FCN_TCNAME(SIZE1,SIZE2) VO_FCN_TCNAME(FW_INT_TYPEN(SIZE1), FW_INT_TYPEN(SIZE2))
 #define FW_IU_FCN_TCNAME(SIZE1,SIZE2) VO_FCN_TCNAME(FW_INT_TYPEN(SIZE1), FW_UINT_TYPEN(SIZE2))
 
 #define FW_UINT_TYPEC(SIZE) uint##SIZE##conv_T
+#define FW_UINT_TYPEBC(SIZE) uint##SIZE##bconv_T
 #define FW_UINT_TYPEN(SIZE) UInt##SIZE
 #define FW_UINT_TYPE(SIZE) uint##SIZE##_T
 #define FW_UINT_MAX(SIZE) UINT##SIZE##_MAX
@@ -1051,6 +1242,7 @@ void msh_CompareVariableSize(IndexedVariable_T* indexed_var, const mxArray* in_v
 #define FW_UINT_FCN_RNAME(OP, SIZE) VO_FCN_RNAME(OP, FW_UINT_TYPEN(SIZE))
 #define FW_UINT_FCN_FNAME(OP, SIZE) VO_FCN_FNAME(OP, FW_UINT_TYPEN(SIZE))
 #define FW_UINT_FCN_CTCNAME(SIZE) VO_FCN_CTCNAME(FW_UINT_TYPEN(SIZE))
+#define FW_UINT_FCN_BCTCNAME(SIZE) VO_FCN_BCTCNAME(FW_UINT_TYPEN(SIZE))
 #define FW_UU_FCN_TCNAME(SIZE1,SIZE2) VO_FCN_TCNAME(FW_UINT_TYPEN(SIZE1), FW_UINT_TYPEN(SIZE2))
 #define FW_UI_FCN_TCNAME(SIZE1,SIZE2) VO_FCN_TCNAME(FW_UINT_TYPEN(SIZE1), FW_INT_TYPEN(SIZE2))
 
@@ -1063,6 +1255,11 @@ static double VO_FCN_FNAME(Rem, Double)(double accum, double in);
 static double VO_FCN_FNAME(Mod, Double)(double accum, double in);
 static double VO_FCN_FNAME(ARS, Double)(double accum, double in);
 static double VO_FCN_FNAME(ALS, Double)(double accum, double in);
+static double VO_FCN_FNAME(Min, Double)(double accum, double in);
+static double VO_FCN_FNAME(Max, Double)(double accum, double in);
+static double VO_FCN_FNAME(Axpy, Double)(double accum, double a, double x);
+static double VO_FCN_FNAME(Fma, Double)(double accum, double a, double b);
+static double VO_FCN_FNAME(Clamp, Double)(double accum, double lower, double upper);
 
 /** Type Conversion routines **/
 #define TC_II_L_DEF(TYPE1, TYPE2, TYPE1_MAX, TYPE1_MIN, TCNAME) \
@@ -1173,17 +1370,43 @@ static TYPE1 TCNAME(void* v_in, size_t offset) \
 	} \
 }
 
+/** Block conversion routines
+ * These convert a run of the input into a buffer of the destination type,
+ * calling the element converters directly so that they may be inlined.
+ */
+#define TC_BLOCK_DEF(TYPE1, TYPE2, TYPEN1, TYPEN2) \
+static void VO_FCN_BTCNAME(TYPEN1, TYPEN2)(TYPE1* out, void* v_in, size_t offset, size_t num_elems) \
+{ \
+	size_t i = msh_SIMDConvert(VO_FCN_MXCLASS(TYPEN1), VO_FCN_MXCLASS(TYPEN2), out, (TYPE2*)v_in + offset, num_elems); \
+	for(; i < num_elems; i++) \
+	{ \
+		out[i] = VO_FCN_TCNAME(TYPEN1, TYPEN2)(v_in, offset + i); \
+	} \
+}
+
+#define FW_TC_INT_BLOCK_METADEF(SIZE1, SIZE2) \
+TC_BLOCK_DEF(FW_INT_TYPE(SIZE1), FW_INT_TYPE(SIZE2), FW_INT_TYPEN(SIZE1), FW_INT_TYPEN(SIZE2)); \
+TC_BLOCK_DEF(FW_INT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_INT_TYPEN(SIZE1), FW_UINT_TYPEN(SIZE2));
+
+#define FW_TC_UINT_BLOCK_METADEF(SIZE1, SIZE2) \
+TC_BLOCK_DEF(FW_UINT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_UINT_TYPEN(SIZE1), FW_UINT_TYPEN(SIZE2)); \
+TC_BLOCK_DEF(FW_UINT_TYPE(SIZE1), FW_INT_TYPE(SIZE2), FW_UINT_TYPEN(SIZE1), FW_INT_TYPEN(SIZE2));
+
 #define FW_TC_INT_L_METADEF(SIZE1, SIZE2) \
 TC_II_L_DEF(FW_INT_TYPE(SIZE1), FW_INT_TYPE(SIZE2), FW_INT_MAX(SIZE1), FW_INT_MIN(SIZE1), FW_II_FCN_TCNAME(SIZE1, SIZE2)); \
-TC_IU_L_DEF(FW_INT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_INT_MAX(SIZE1), FW_IU_FCN_TCNAME(SIZE1, SIZE2));
+TC_IU_L_DEF(FW_INT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_INT_MAX(SIZE1), FW_IU_FCN_TCNAME(SIZE1, SIZE2)); \
+FW_TC_INT_BLOCK_METADEF(SIZE1, SIZE2)
 
 #define FW_TC_INT_U_METADEF(SIZE1, SIZE2) \
 TC_INT_U_DEF(FW_INT_TYPE(SIZE1), FW_INT_TYPE(SIZE2), FW_II_FCN_TCNAME(SIZE1, SIZE2)); \
-TC_INT_U_DEF(FW_INT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_IU_FCN_TCNAME(SIZE1, SIZE2));
+TC_INT_U_DEF(FW_INT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_IU_FCN_TCNAME(SIZE1, SIZE2)); \
+FW_TC_INT_BLOCK_METADEF(SIZE1, SIZE2)
 
 #define FW_TC_INT_F_METADEF(SIZE) \
 TC_INT_F_DEF(FW_INT_TYPE(SIZE), single, FW_INT_MAX(SIZE), FW_INT_MIN(SIZE), VO_FCN_TCNAME(FW_INT_TYPEN(SIZE), Single)); \
 TC_INT_F_DEF(FW_INT_TYPE(SIZE), double, FW_INT_MAX(SIZE), FW_INT_MIN(SIZE), VO_FCN_TCNAME(FW_INT_TYPEN(SIZE), Double)); \
+TC_BLOCK_DEF(FW_INT_TYPE(SIZE), single, FW_INT_TYPEN(SIZE), Single); \
+TC_BLOCK_DEF(FW_INT_TYPE(SIZE), double, FW_INT_TYPEN(SIZE), Double);
 
 #define FW_TC_INT_CONV_DEF(SIZE) \
 typedef FW_INT_TYPE(SIZE) (*FW_INT_TYPEC(SIZE))(void*, size_t); \
@@ -1201,6 +1424,29 @@ static FW_INT_TYPEC(SIZE) FW_INT_FCN_CTCNAME(SIZE)(mxClassID cid) \
 		case(mxUINT64_CLASS): return FW_IU_FCN_TCNAME(SIZE, 64); \
 		case(mxSINGLE_CLASS): return VO_FCN_TCNAME(FW_INT_TYPEN(SIZE), Single); \
 		case(mxDOUBLE_CLASS): return VO_FCN_TCNAME(FW_INT_TYPEN(SIZE), Double); \
+		case(mxLOGICAL_CLASS): return FW_IU_FCN_TCNAME(SIZE, 8); \
+		case(mxCHAR_CLASS):    return FW_IU_FCN_TCNAME(SIZE, 16); \
+		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion."); \
+	} \
+	return 0; \
+} \
+typedef void (*FW_INT_TYPEBC(SIZE))(FW_INT_TYPE(SIZE)*, void*, size_t, size_t); \
+static FW_INT_TYPEBC(SIZE) FW_INT_FCN_BCTCNAME(SIZE)(mxClassID cid) \
+{ \
+	switch(cid) \
+	{ \
+		case(mxINT8_CLASS):   return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_INT_TYPEN(8)); \
+		case(mxUINT8_CLASS):  return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_UINT_TYPEN(8)); \
+		case(mxINT16_CLASS):  return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_INT_TYPEN(16)); \
+		case(mxUINT16_CLASS): return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_UINT_TYPEN(16)); \
+		case(mxINT32_CLASS):  return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_INT_TYPEN(32)); \
+		case(mxUINT32_CLASS): return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_UINT_TYPEN(32)); \
+		case(mxINT64_CLASS):  return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_INT_TYPEN(64)); \
+		case(mxUINT64_CLASS): return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_UINT_TYPEN(64)); \
+		case(mxSINGLE_CLASS): return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), Single); \
+		case(mxDOUBLE_CLASS): return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), Double); \
+		case(mxLOGICAL_CLASS): return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_UINT_TYPEN(8)); \
+		case(mxCHAR_CLASS):    return VO_FCN_BTCNAME(FW_INT_TYPEN(SIZE), FW_UINT_TYPEN(16)); \
 		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion."); \
 	} \
 	return 0; \
@@ -1236,15 +1482,19 @@ FW_TC_INT_CONV_DEF(64);
 
 #define FW_UINT_TC_L_METADEF(SIZE1, SIZE2) \
 TC_UU_L_DEF(FW_UINT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_UINT_MAX(SIZE1), FW_UU_FCN_TCNAME(SIZE1, SIZE2)); \
-TC_UI_L_DEF(FW_UINT_TYPE(SIZE1), FW_INT_TYPE(SIZE2), FW_UINT_MAX(SIZE1), FW_UI_FCN_TCNAME(SIZE1, SIZE2));
+TC_UI_L_DEF(FW_UINT_TYPE(SIZE1), FW_INT_TYPE(SIZE2), FW_UINT_MAX(SIZE1), FW_UI_FCN_TCNAME(SIZE1, SIZE2)); \
+FW_TC_UINT_BLOCK_METADEF(SIZE1, SIZE2)
 
 #define FW_UINT_TC_U_METADEF(SIZE1, SIZE2) \
 TC_INT_U_DEF(FW_UINT_TYPE(SIZE1), FW_UINT_TYPE(SIZE2), FW_UU_FCN_TCNAME(SIZE1, SIZE2)); \
 TC_UINT_U_DEF(FW_UINT_TYPE(SIZE1), FW_INT_TYPE(SIZE2), FW_UI_FCN_TCNAME(SIZE1, SIZE2)); \
+FW_TC_UINT_BLOCK_METADEF(SIZE1, SIZE2)
 
 #define FW_TC_UINT_F_METADEF(SIZE) \
 TC_INT_F_DEF(FW_UINT_TYPE(SIZE), single, FW_UINT_MAX(SIZE), 0, VO_FCN_TCNAME(FW_UINT_TYPEN(SIZE), Single)); \
 TC_INT_F_DEF(FW_UINT_TYPE(SIZE), double, FW_UINT_MAX(SIZE), 0, VO_FCN_TCNAME(FW_UINT_TYPEN(SIZE), Double)); \
+TC_BLOCK_DEF(FW_UINT_TYPE(SIZE), single, FW_UINT_TYPEN(SIZE), Single); \
+TC_BLOCK_DEF(FW_UINT_TYPE(SIZE), double, FW_UINT_TYPEN(SIZE), Double);
 
 #define FW_TC_UINT_CONV_DEF(SIZE) \
 typedef FW_UINT_TYPE(SIZE) (*FW_UINT_TYPEC(SIZE))(void*, size_t); \
@@ -1262,6 +1512,29 @@ static FW_UINT_TYPEC(SIZE) FW_UINT_FCN_CTCNAME(SIZE)(mxClassID cid) \
 		case(mxUINT64_CLASS): return FW_UU_FCN_TCNAME(SIZE, 64); \
 		case(mxSINGLE_CLASS): return VO_FCN_TCNAME(FW_UINT_TYPEN(SIZE), Single); \
 		case(mxDOUBLE_CLASS): return VO_FCN_TCNAME(FW_UINT_TYPEN(SIZE), Double); \
+		case(mxLOGICAL_CLASS): return FW_UU_FCN_TCNAME(SIZE, 8); \
+		case(mxCHAR_CLASS):    return FW_UU_FCN_TCNAME(SIZE, 16); \
+		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion."); \
+	} \
+	return 0; \
+} \
+typedef void (*FW_UINT_TYPEBC(SIZE))(FW_UINT_TYPE(SIZE)*, void*, size_t, size_t); \
+static FW_UINT_TYPEBC(SIZE) FW_UINT_FCN_BCTCNAME(SIZE)(mxClassID cid) \
+{ \
+	switch(cid) \
+	{ \
+		case(mxINT8_CLASS):   return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_INT_TYPEN(8)); \
+		case(mxUINT8_CLASS):  return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_UINT_TYPEN(8)); \
+		case(mxINT16_CLASS):  return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_INT_TYPEN(16)); \
+		case(mxUINT16_CLASS): return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_UINT_TYPEN(16)); \
+		case(mxINT32_CLASS):  return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_INT_TYPEN(32)); \
+		case(mxUINT32_CLASS): return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_UINT_TYPEN(32)); \
+		case(mxINT64_CLASS):  return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_INT_TYPEN(64)); \
+		case(mxUINT64_CLASS): return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_UINT_TYPEN(64)); \
+		case(mxSINGLE_CLASS): return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), Single); \
+		case(mxDOUBLE_CLASS): return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), Double); \
+		case(mxLOGICAL_CLASS): return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_UINT_TYPEN(8)); \
+		case(mxCHAR_CLASS):    return VO_FCN_BTCNAME(FW_UINT_TYPEN(SIZE), FW_UINT_TYPEN(16)); \
 		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion."); \
 	} \
 	return 0; \
@@ -1305,7 +1578,11 @@ static TYPE1 TCNAME(void* v_in, size_t offset) \
 TC_FL_DEF(single, FW_INT_TYPE(SIZE), VO_FCN_TCNAME(Single, FW_INT_TYPEN(SIZE))); \
 TC_FL_DEF(single, FW_UINT_TYPE(SIZE), VO_FCN_TCNAME(Single, FW_UINT_TYPEN(SIZE))); \
 TC_FL_DEF(double, FW_INT_TYPE(SIZE), VO_FCN_TCNAME(Double, FW_INT_TYPEN(SIZE))); \
-TC_FL_DEF(double, FW_UINT_TYPE(SIZE), VO_FCN_TCNAME(Double, FW_UINT_TYPEN(SIZE)));
+TC_FL_DEF(double, FW_UINT_TYPE(SIZE), VO_FCN_TCNAME(Double, FW_UINT_TYPEN(SIZE))); \
+TC_BLOCK_DEF(single, FW_INT_TYPE(SIZE), Single, FW_INT_TYPEN(SIZE)); \
+TC_BLOCK_DEF(single, FW_UINT_TYPE(SIZE), Single, FW_UINT_TYPEN(SIZE)); \
+TC_BLOCK_DEF(double, FW_INT_TYPE(SIZE), Double, FW_INT_TYPEN(SIZE)); \
+TC_BLOCK_DEF(double, FW_UINT_TYPE(SIZE), Double, FW_UINT_TYPEN(SIZE));
 
 TC_FL_INT_METADEF(8);
 TC_FL_INT_METADEF(16);
@@ -1317,6 +1594,11 @@ TC_FL_DEF(single, double, VO_FCN_TCNAME(Single, Double));
 TC_FL_DEF(double, double, VO_FCN_TCNAME(Double, Double));
 TC_FL_DEF(double, single, VO_FCN_TCNAME(Double, Single));
 
+TC_BLOCK_DEF(single, single, Single, Single);
+TC_BLOCK_DEF(single, double, Single, Double);
+TC_BLOCK_DEF(double, double, Double, Double);
+TC_BLOCK_DEF(double, single, Double, Single);
+
 typedef single (*singleconv_T)(void*,size_t);
 static singleconv_T VO_FCN_CTCNAME(Single)(mxClassID cid)
 {
@@ -1332,6 +1614,31 @@ static singleconv_T VO_FCN_CTCNAME(Single)(mxClassID cid)
 		case(mxUINT64_CLASS): return VO_FCN_TCNAME(Single, FW_UINT_TYPEN( 64 ));
 		case(mxSINGLE_CLASS): return VO_FCN_TCNAME(Single, Single);
 		case(mxDOUBLE_CLASS): return VO_FCN_TCNAME(Single, Double);
+		case(mxLOGICAL_CLASS): return VO_FCN_TCNAME(Single, FW_UINT_TYPEN( 8  ));
+		case(mxCHAR_CLASS):    return VO_FCN_TCNAME(Single, FW_UINT_TYPEN( 16 ));
+		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion.");
+	}
+	return 0;
+}
+
+
+typedef void (*singlebconv_T)(single*, void*, size_t, size_t);
+static singlebconv_T VO_FCN_BCTCNAME(Single)(mxClassID cid)
+{
+	switch(cid)
+	{
+		case(mxINT8_CLASS):   return VO_FCN_BTCNAME(Single, FW_INT_TYPEN(  8  ));
+		case(mxUINT8_CLASS):  return VO_FCN_BTCNAME(Single, FW_UINT_TYPEN( 8  ));
+		case(mxINT16_CLASS):  return VO_FCN_BTCNAME(Single, FW_INT_TYPEN(  16 ));
+		case(mxUINT16_CLASS): return VO_FCN_BTCNAME(Single, FW_UINT_TYPEN( 16 ));
+		case(mxINT32_CLASS):  return VO_FCN_BTCNAME(Single, FW_INT_TYPEN(  32 ));
+		case(mxUINT32_CLASS): return VO_FCN_BTCNAME(Single, FW_UINT_TYPEN( 32 ));
+		case(mxINT64_CLASS):  return VO_FCN_BTCNAME(Single, FW_INT_TYPEN(  64 ));
+		case(mxUINT64_CLASS): return VO_FCN_BTCNAME(Single, FW_UINT_TYPEN( 64 ));
+		case(mxSINGLE_CLASS): return VO_FCN_BTCNAME(Single, Single);
+		case(mxDOUBLE_CLASS): return VO_FCN_BTCNAME(Single, Double);
+		case(mxLOGICAL_CLASS): return VO_FCN_BTCNAME(Single, FW_UINT_TYPEN( 8  ));
+		case(mxCHAR_CLASS):    return VO_FCN_BTCNAME(Single, FW_UINT_TYPEN( 16 ));
 		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion.");
 	}
 	return 0;
@@ -1353,6 +1660,31 @@ static doubleconv_T VO_FCN_CTCNAME(Double)(mxClassID cid)
 		case(mxUINT64_CLASS): return VO_FCN_TCNAME(Double, FW_UINT_TYPEN( 64 ));
 		case(mxSINGLE_CLASS): return VO_FCN_TCNAME(Double, Single);
 		case(mxDOUBLE_CLASS): return VO_FCN_TCNAME(Double, Double);
+		case(mxLOGICAL_CLASS): return VO_FCN_TCNAME(Double, FW_UINT_TYPEN( 8  ));
+		case(mxCHAR_CLASS):    return VO_FCN_TCNAME(Double, FW_UINT_TYPEN( 16 ));
+		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion.");
+	}
+	return 0;
+}
+
+
+typedef void (*doublebconv_T)(double*, void*, size_t, size_t);
+static doublebconv_T VO_FCN_BCTCNAME(Double)(mxClassID cid)
+{
+	switch(cid)
+	{
+		case(mxINT8_CLASS):   return VO_FCN_BTCNAME(Double, FW_INT_TYPEN(  8  ));
+		case(mxUINT8_CLASS):  return VO_FCN_BTCNAME(Double, FW_UINT_TYPEN( 8  ));
+		case(mxINT16_CLASS):  return VO_FCN_BTCNAME(Double, FW_INT_TYPEN(  16 ));
+		case(mxUINT16_CLASS): return VO_FCN_BTCNAME(Double, FW_UINT_TYPEN( 16 ));
+		case(mxINT32_CLASS):  return VO_FCN_BTCNAME(Double, FW_INT_TYPEN(  32 ));
+		case(mxUINT32_CLASS): return VO_FCN_BTCNAME(Double, FW_UINT_TYPEN( 32 ));
+		case(mxINT64_CLASS):  return VO_FCN_BTCNAME(Double, FW_INT_TYPEN(  64 ));
+		case(mxUINT64_CLASS): return VO_FCN_BTCNAME(Double, FW_UINT_TYPEN( 64 ));
+		case(mxSINGLE_CLASS): return VO_FCN_BTCNAME(Double, Single);
+		case(mxDOUBLE_CLASS): return VO_FCN_BTCNAME(Double, Double);
+		case(mxLOGICAL_CLASS): return VO_FCN_BTCNAME(Double, FW_UINT_TYPEN( 8  ));
+		case(mxCHAR_CLASS):    return VO_FCN_BTCNAME(Double, FW_UINT_TYPEN( 16 ));
 		default: meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "TypeConversionError", "Invalid variable conversion.");
 	}
 	return 0;
@@ -1360,7 +1692,7 @@ static doubleconv_T VO_FCN_CTCNAME(Double)(mxClassID cid)
 
 
 
-#define UNARY_OP_RUNNER(RNAME, NAME, TYPE, TYPEN, CASNAME)   \
+#define UNARY_OP_RUNNER(RNAME, NAME, TYPE, TYPEN, CXNAME)   \
 static void RNAME(WideInput_T* wide_accum, long opts) \
 {                                                  \
 	size_t i;                                     \
@@ -1369,11 +1701,11 @@ static void RNAME(WideInput_T* wide_accum, long opts) \
 	{ \
 		for(i = 0; i < wide_accum->num_elems; i++)                \
 		{                                             \
+			old_val = WideInputFetch(wide_accum, TYPEN)[i];                        \
 			do                                                      \
 			{                                                       \
-				old_val = WideInputFetch(wide_accum, TYPEN)[i];                    \
 				new_val = NAME(old_val);          \
-			} while(CASNAME(WideInputFetch(wide_accum, TYPEN) + i, old_val, new_val) != old_val); \
+			} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i, &old_val, new_val)); \
 		}                                             \
 	} \
 	else \
@@ -1386,14 +1718,16 @@ static void RNAME(WideInput_T* wide_accum, long opts) \
 }
 
 #define UNARY_OP_RUNNER_METADEF(OP, TYPE, TYPEN) \
-UNARY_OP_RUNNER(VO_FCN_RNAME(OP, TYPEN), VO_FCN_FNAME(OP, TYPEN), TYPE, TYPEN, VO_FCN_CASNAME(TYPEN))
+UNARY_OP_RUNNER(VO_FCN_RNAME(OP, TYPEN), VO_FCN_FNAME(OP, TYPEN), TYPE, TYPEN, VO_FCN_CXNAME(TYPEN))
 
-#define BINARY_OP_RUNNER(RNAME, FNAME, CASNAME, CTCNAME, OP, TYPE, TYPEN, TYPEC)           \
+#define BINARY_OP_RUNNER(RNAME, FNAME, CXNAME, CTCNAME, OP, TYPE, TYPEN, TYPEC)           \
 static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 { \
-	size_t i; \
+	size_t i, j, num_block_elems; \
 	TYPEC in_conv; \
+	void (*in_bconv)(TYPE*, void*, size_t, size_t); \
 	TYPE new_val, old_val, static_val; \
+	TYPE conv_block[MSH_CONVERT_BLOCK_SIZE]; \
 	double static_val_dbl, tmp; \
 	if(wide_in->num_elems == 1) \
 	{ \
@@ -1406,12 +1740,12 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 				{ \
 					for(i = 0; i < wide_accum->num_elems; i++) \
 					{ \
+						old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 						do \
 						{ \
-							old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 							tmp = VO_FCN_FNAME(OP, Double)((double)old_val, static_val_dbl); \
 							new_val = VO_FCN_TCNAME(TYPEN, Double)(&tmp, 0); \
-						} while(CASNAME(WideInputFetch(wide_accum, TYPEN) + i, old_val, new_val) != old_val); \
+						} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i, &old_val, new_val)); \
 					} \
 				} \
 				else \
@@ -1431,11 +1765,11 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 				{ \
 					for(i = 0; i < wide_accum->num_elems; i++) \
 					{ \
+						old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 						do \
 						{ \
-							old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 							new_val = FNAME(old_val, static_val); \
-						} while(CASNAME(WideInputFetch(wide_accum, TYPEN) + i, old_val, new_val) != old_val); \
+						} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i, &old_val, new_val)); \
 					} \
 				} \
 				else \
@@ -1453,16 +1787,17 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 			{ \
 				for(i = 0; i < wide_accum->num_elems; i++) \
 				{ \
+					old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 					do \
 					{ \
-						old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 						new_val = FNAME(old_val, *WideInputFetch(wide_in, TYPEN)); \
-					} while(CASNAME(WideInputFetch(wide_accum, TYPEN) + i, old_val, new_val) != old_val); \
+					} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i, &old_val, new_val)); \
 				} \
 			} \
 			else \
 			{ \
-				for(i = 0; i < wide_accum->num_elems; i++) \
+				i = msh_SIMDBinaryOp(VO_FCN_VAROP(OP), VO_FCN_MXCLASS(TYPEN), wide_accum->input.raw, wide_in->input.raw, wide_accum->num_elems, TRUE); \
+				for(; i < wide_accum->num_elems; i++) \
 				{ \
 					WideInputFetch(wide_accum, TYPEN)[i] = FNAME(WideInputFetch(wide_accum, TYPEN)[i], *WideInputFetch(wide_in, TYPEN)); \
 				} \
@@ -1473,23 +1808,31 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 	{ \
 		if(wide_accum->mxtype != wide_in->mxtype) \
 		{ \
-			in_conv = CTCNAME(wide_in->mxtype); \
 			if(opts & MSH_USE_ATOMIC_OPS) \
 			{ \
+				in_conv = CTCNAME(wide_in->mxtype); \
 				for(i = 0; i < wide_accum->num_elems; i++) \
 				{ \
+					old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 					do \
 					{ \
-						old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 						new_val = FNAME(old_val, in_conv(WideInputFetch(wide_in, TYPEN), i)); \
-					} while(CASNAME(WideInputFetch(wide_accum, TYPEN) + i, old_val, new_val) != old_val); \
+					} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i, &old_val, new_val)); \
 				} \
 			} \
 			else \
 			{ \
-				for(i = 0; i < wide_accum->num_elems; i++) \
+				/* convert a block of the input, then run the same type operation on it */ \
+				in_bconv = VO_FCN_BCTCNAME(TYPEN)(wide_in->mxtype); \
+				for(i = 0; i < wide_accum->num_elems; i += num_block_elems) \
 				{ \
-					WideInputFetch(wide_accum, TYPEN)[i] = FNAME(WideInputFetch(wide_accum, TYPEN)[i], in_conv(WideInputFetch(wide_in, TYPEN), i)); \
+					num_block_elems = MIN(wide_accum->num_elems - i, MSH_CONVERT_BLOCK_SIZE); \
+					in_bconv(conv_block, wide_in->input.raw, i, num_block_elems); \
+					j = msh_SIMDBinaryOp(VO_FCN_VAROP(OP), VO_FCN_MXCLASS(TYPEN), WideInputFetch(wide_accum, TYPEN) + i, conv_block, num_block_elems, FALSE); \
+					for(; j < num_block_elems; j++) \
+					{ \
+						WideInputFetch(wide_accum, TYPEN)[i + j] = FNAME(WideInputFetch(wide_accum, TYPEN)[i + j], conv_block[j]); \
+					} \
 				} \
 			} \
 		} \
@@ -1499,16 +1842,17 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 			{ \
 				for(i = 0; i < wide_accum->num_elems; i++) \
 				{ \
+					old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 					do \
 					{ \
-						old_val = WideInputFetch(wide_accum, TYPEN)[i]; \
 						new_val = FNAME(old_val, WideInputFetch(wide_in, TYPEN)[i]); \
-					} while(CASNAME(WideInputFetch(wide_accum, TYPEN) + i, old_val, new_val) != old_val); \
+					} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i, &old_val, new_val)); \
 				} \
 			} \
 			else \
 			{ \
-				for(i = 0; i < wide_accum->num_elems; i++) \
+				i = msh_SIMDBinaryOp(VO_FCN_VAROP(OP), VO_FCN_MXCLASS(TYPEN), wide_accum->input.raw, wide_in->input.raw, wide_accum->num_elems, FALSE); \
+				for(; i < wide_accum->num_elems; i++) \
 				{ \
 					WideInputFetch(wide_accum, TYPEN)[i] = FNAME(WideInputFetch(wide_accum, TYPEN)[i], WideInputFetch(wide_in, TYPEN)[i]); \
 				} \
@@ -1518,7 +1862,178 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 }
 
 #define BINARY_OP_RUNNER_METADEF(OP, TYPE, TYPEN, TYPEC) \
-BINARY_OP_RUNNER(VO_FCN_RNAME(OP,TYPEN), VO_FCN_FNAME(OP,TYPEN), VO_FCN_CASNAME(TYPEN), VO_FCN_CTCNAME(TYPEN), OP, TYPE, TYPEN, TYPEC)
+BINARY_OP_RUNNER(VO_FCN_RNAME(OP,TYPEN), VO_FCN_FNAME(OP,TYPEN), VO_FCN_CXNAME(TYPEN), VO_FCN_CTCNAME(TYPEN), OP, TYPE, TYPEN, TYPEC)
+
+/* the bitwise operations are only defined for integers, and use the native atomic operations */
+#define BITWISE_OP_RUNNER(RNAME, FNAME, FETCHNAME, CTCNAME, OP, TYPE, TYPEN) \
+static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
+{ \
+	size_t i, j, num_block_elems; \
+	void (*in_bconv)(TYPE*, void*, size_t, size_t); \
+	TYPE static_val; \
+	TYPE* in_block; \
+	TYPE conv_block[MSH_CONVERT_BLOCK_SIZE]; \
+	if(wide_in->num_elems == 1) \
+	{ \
+		static_val = CTCNAME(wide_in->mxtype)(wide_in->input.raw, 0); \
+		if(opts & MSH_USE_ATOMIC_OPS) \
+		{ \
+			for(i = 0; i < wide_accum->num_elems; i++) \
+			{ \
+				FETCHNAME(WideInputFetch(wide_accum, TYPEN) + i, static_val); \
+			} \
+		} \
+		else \
+		{ \
+			i = msh_SIMDBinaryOp(VO_FCN_VAROP(OP), VO_FCN_MXCLASS(TYPEN), wide_accum->input.raw, &static_val, wide_accum->num_elems, TRUE); \
+			for(; i < wide_accum->num_elems; i++) \
+			{ \
+				WideInputFetch(wide_accum, TYPEN)[i] = FNAME(WideInputFetch(wide_accum, TYPEN)[i], static_val); \
+			} \
+		} \
+	} \
+	else \
+	{ \
+		in_bconv = (wide_accum->mxtype == wide_in->mxtype)? NULL : VO_FCN_BCTCNAME(TYPEN)(wide_in->mxtype); \
+		for(i = 0; i < wide_accum->num_elems; i += num_block_elems) \
+		{ \
+			num_block_elems = MIN(wide_accum->num_elems - i, MSH_CONVERT_BLOCK_SIZE); \
+			if(in_bconv == NULL) \
+			{ \
+				in_block = WideInputFetch(wide_in, TYPEN) + i; \
+			} \
+			else \
+			{ \
+				in_bconv(conv_block, wide_in->input.raw, i, num_block_elems); \
+				in_block = conv_block; \
+			} \
+			if(opts & MSH_USE_ATOMIC_OPS) \
+			{ \
+				for(j = 0; j < num_block_elems; j++) \
+				{ \
+					FETCHNAME(WideInputFetch(wide_accum, TYPEN) + i + j, in_block[j]); \
+				} \
+			} \
+			else \
+			{ \
+				j = msh_SIMDBinaryOp(VO_FCN_VAROP(OP), VO_FCN_MXCLASS(TYPEN), WideInputFetch(wide_accum, TYPEN) + i, in_block, num_block_elems, FALSE); \
+				for(; j < num_block_elems; j++) \
+				{ \
+					WideInputFetch(wide_accum, TYPEN)[i + j] = FNAME(WideInputFetch(wide_accum, TYPEN)[i + j], in_block[j]); \
+				} \
+			} \
+		} \
+	} \
+}
+
+#define BITWISE_OP_RUNNER_METADEF(OP, FETCHNAME, TYPE, TYPEN) \
+BITWISE_OP_RUNNER(VO_FCN_RNAME(OP,TYPEN), VO_FCN_FNAME(OP,TYPEN), FETCHNAME, VO_FCN_CTCNAME(TYPEN), OP, TYPE, TYPEN)
+
+#define MSH_IS_FLOAT_CLASS(CID) ((CID) == mxSINGLE_CLASS || (CID) == mxDOUBLE_CLASS)
+
+/* both operands are converted to the class of the accumulator before the fused operation, except that
+ * integer variables with a floating point operand are computed in double and converted once at the end */
+#define TERNARY_OP_RUNNER(RNAME, FNAME, WIDE_FNAME, CXNAME, TYPE, TYPEN) \
+static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in1, WideInput_T* wide_in2, long opts) \
+{ \
+	size_t i, j, num_block_elems, in1_stride, in2_stride; \
+	int is_wide; \
+	void (*in1_bconv)(TYPE*, void*, size_t, size_t); \
+	void (*in2_bconv)(TYPE*, void*, size_t, size_t); \
+	void (*wide_in1_bconv)(double*, void*, size_t, size_t); \
+	void (*wide_in2_bconv)(double*, void*, size_t, size_t); \
+	TYPE new_val, old_val; \
+	double wide_val; \
+	TYPE in1_block[MSH_CONVERT_BLOCK_SIZE]; \
+	TYPE in2_block[MSH_CONVERT_BLOCK_SIZE]; \
+	double wide_in1_block[MSH_CONVERT_BLOCK_SIZE]; \
+	double wide_in2_block[MSH_CONVERT_BLOCK_SIZE]; \
+	is_wide = !MSH_IS_FLOAT_CLASS(VO_FCN_MXCLASS(TYPEN)) && (MSH_IS_FLOAT_CLASS(wide_in1->mxtype) || MSH_IS_FLOAT_CLASS(wide_in2->mxtype)); \
+	in1_bconv = VO_FCN_BCTCNAME(TYPEN)(wide_in1->mxtype); \
+	in2_bconv = VO_FCN_BCTCNAME(TYPEN)(wide_in2->mxtype); \
+	wide_in1_bconv = VO_FCN_BCTCNAME(Double)(wide_in1->mxtype); \
+	wide_in2_bconv = VO_FCN_BCTCNAME(Double)(wide_in2->mxtype); \
+	/* scalar inputs are converted once and used for every element */ \
+	in1_stride = (wide_in1->num_elems == 1)? 0 : 1; \
+	in2_stride = (wide_in2->num_elems == 1)? 0 : 1; \
+	if(in1_stride == 0) \
+	{ \
+		in1_bconv(in1_block, wide_in1->input.raw, 0, 1); \
+		wide_in1_bconv(wide_in1_block, wide_in1->input.raw, 0, 1); \
+	} \
+	if(in2_stride == 0) \
+	{ \
+		in2_bconv(in2_block, wide_in2->input.raw, 0, 1); \
+		wide_in2_bconv(wide_in2_block, wide_in2->input.raw, 0, 1); \
+	} \
+	for(i = 0; i < wide_accum->num_elems; i += num_block_elems) \
+	{ \
+		num_block_elems = MIN(wide_accum->num_elems - i, MSH_CONVERT_BLOCK_SIZE); \
+		if(is_wide) \
+		{ \
+			if(in1_stride != 0) \
+			{ \
+				wide_in1_bconv(wide_in1_block, wide_in1->input.raw, i, num_block_elems); \
+			} \
+			if(in2_stride != 0) \
+			{ \
+				wide_in2_bconv(wide_in2_block, wide_in2->input.raw, i, num_block_elems); \
+			} \
+			if(opts & MSH_USE_ATOMIC_OPS) \
+			{ \
+				for(j = 0; j < num_block_elems; j++) \
+				{ \
+					old_val = WideInputFetch(wide_accum, TYPEN)[i + j]; \
+					do \
+					{ \
+						wide_val = WIDE_FNAME((double)old_val, wide_in1_block[j*in1_stride], wide_in2_block[j*in2_stride]); \
+						new_val = VO_FCN_TCNAME(TYPEN, Double)(&wide_val, 0); \
+					} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i + j, &old_val, new_val)); \
+				} \
+			} \
+			else \
+			{ \
+				for(j = 0; j < num_block_elems; j++) \
+				{ \
+					wide_val = WIDE_FNAME((double)WideInputFetch(wide_accum, TYPEN)[i + j], wide_in1_block[j*in1_stride], wide_in2_block[j*in2_stride]); \
+					WideInputFetch(wide_accum, TYPEN)[i + j] = VO_FCN_TCNAME(TYPEN, Double)(&wide_val, 0); \
+				} \
+			} \
+		} \
+		else \
+		{ \
+			if(in1_stride != 0) \
+			{ \
+				in1_bconv(in1_block, wide_in1->input.raw, i, num_block_elems); \
+			} \
+			if(in2_stride != 0) \
+			{ \
+				in2_bconv(in2_block, wide_in2->input.raw, i, num_block_elems); \
+			} \
+			if(opts & MSH_USE_ATOMIC_OPS) \
+			{ \
+				for(j = 0; j < num_block_elems; j++) \
+				{ \
+					old_val = WideInputFetch(wide_accum, TYPEN)[i + j]; \
+					do \
+					{ \
+						new_val = FNAME(old_val, in1_block[j*in1_stride], in2_block[j*in2_stride]); \
+					} while(!CXNAME(WideInputFetch(wide_accum, TYPEN) + i + j, &old_val, new_val)); \
+				} \
+			} \
+			else \
+			{ \
+				for(j = 0; j < num_block_elems; j++) \
+				{ \
+					WideInputFetch(wide_accum, TYPEN)[i + j] = FNAME(WideInputFetch(wide_accum, TYPEN)[i + j], in1_block[j*in1_stride], in2_block[j*in2_stride]); \
+				} \
+			} \
+		} \
+	} \
+}
+
+#define TERNARY_OP_RUNNER_METADEF(OP, TYPE, TYPEN) \
+TERNARY_OP_RUNNER(VO_FCN_RNAME(OP,TYPEN), VO_FCN_FNAME(OP,TYPEN), VO_FCN_FNAME(OP,Double), VO_FCN_CXNAME(TYPEN), TYPE, TYPEN)
 
 /** Signed integer arithmetic
  * We assume here that ints are two's complement, and
@@ -1880,6 +2395,52 @@ ALS_INT_METADEF(16);
 ALS_INT_METADEF(32);
 ALS_INT_METADEF(64);
 
+/** SIGNED MINIMUM AND MAXIMUM **/
+
+#define MIN_INT_DEF(NAME, TYPE)      \
+static TYPE NAME(TYPE accum, TYPE in) \
+{                                     \
+	return (in < accum)? in : accum;  \
+}
+
+#define MAX_INT_DEF(NAME, TYPE)      \
+static TYPE NAME(TYPE accum, TYPE in) \
+{                                     \
+	return (in > accum)? in : accum;  \
+}
+
+#define MINMAX_INT_METADEF(SIZE)                               \
+MIN_INT_DEF(FW_INT_FCN_FNAME(Min, SIZE), FW_INT_TYPE(SIZE)); \
+BINARY_OP_RUNNER_METADEF(Min, FW_INT_TYPE(SIZE), FW_INT_TYPEN(SIZE), FW_INT_TYPEC(SIZE)); \
+MAX_INT_DEF(FW_INT_FCN_FNAME(Max, SIZE), FW_INT_TYPE(SIZE)); \
+BINARY_OP_RUNNER_METADEF(Max, FW_INT_TYPE(SIZE), FW_INT_TYPEN(SIZE), FW_INT_TYPEC(SIZE));
+
+MINMAX_INT_METADEF(8);
+MINMAX_INT_METADEF(16);
+MINMAX_INT_METADEF(32);
+MINMAX_INT_METADEF(64);
+
+/** SIGNED BITWISE OPERATIONS **/
+
+#define BITWISE_INT_DEF(NAME, TYPE, OPERATOR) \
+static TYPE NAME(TYPE accum, TYPE in)          \
+{                                              \
+	return (TYPE)(accum OPERATOR in);          \
+}
+
+#define BITWISE_INT_METADEF(SIZE)                                                          \
+BITWISE_INT_DEF(FW_INT_FCN_FNAME(And, SIZE), FW_INT_TYPE(SIZE), &); \
+BITWISE_OP_RUNNER_METADEF(And, VO_FCN_ANDNAME(FW_INT_TYPEN(SIZE)), FW_INT_TYPE(SIZE), FW_INT_TYPEN(SIZE)); \
+BITWISE_INT_DEF(FW_INT_FCN_FNAME(Or, SIZE), FW_INT_TYPE(SIZE), |); \
+BITWISE_OP_RUNNER_METADEF(Or, VO_FCN_ORNAME(FW_INT_TYPEN(SIZE)), FW_INT_TYPE(SIZE), FW_INT_TYPEN(SIZE)); \
+BITWISE_INT_DEF(FW_INT_FCN_FNAME(Xor, SIZE), FW_INT_TYPE(SIZE), ^); \
+BITWISE_OP_RUNNER_METADEF(Xor, VO_FCN_XORNAME(FW_INT_TYPEN(SIZE)), FW_INT_TYPE(SIZE), FW_INT_TYPEN(SIZE));
+
+BITWISE_INT_METADEF(8);
+BITWISE_INT_METADEF(16);
+BITWISE_INT_METADEF(32);
+BITWISE_INT_METADEF(64);
+
 /** Unsigned integer arithmetic
  *  The functions here are pretty straightforward, except
  *  for uint64 multiplication.
@@ -2127,6 +2688,52 @@ ALS_UINT_METADEF(16);
 ALS_UINT_METADEF(32);
 ALS_UINT_METADEF(64);
 
+/** UNSIGNED MINIMUM AND MAXIMUM **/
+
+#define MIN_UINT_DEF(NAME, TYPE)      \
+static TYPE NAME(TYPE accum, TYPE in) \
+{                                     \
+	return (in < accum)? in : accum;  \
+}
+
+#define MAX_UINT_DEF(NAME, TYPE)      \
+static TYPE NAME(TYPE accum, TYPE in) \
+{                                     \
+	return (in > accum)? in : accum;  \
+}
+
+#define MINMAX_UINT_METADEF(SIZE)                               \
+MIN_UINT_DEF(FW_UINT_FCN_FNAME(Min, SIZE), FW_UINT_TYPE(SIZE)); \
+BINARY_OP_RUNNER_METADEF(Min, FW_UINT_TYPE(SIZE), FW_UINT_TYPEN(SIZE), FW_UINT_TYPEC(SIZE)); \
+MAX_UINT_DEF(FW_UINT_FCN_FNAME(Max, SIZE), FW_UINT_TYPE(SIZE)); \
+BINARY_OP_RUNNER_METADEF(Max, FW_UINT_TYPE(SIZE), FW_UINT_TYPEN(SIZE), FW_UINT_TYPEC(SIZE));
+
+MINMAX_UINT_METADEF(8);
+MINMAX_UINT_METADEF(16);
+MINMAX_UINT_METADEF(32);
+MINMAX_UINT_METADEF(64);
+
+/** UNSIGNED BITWISE OPERATIONS **/
+
+#define BITWISE_UINT_DEF(NAME, TYPE, OPERATOR) \
+static TYPE NAME(TYPE accum, TYPE in)          \
+{                                              \
+	return (TYPE)(accum OPERATOR in);          \
+}
+
+#define BITWISE_UINT_METADEF(SIZE)                                                          \
+BITWISE_UINT_DEF(FW_UINT_FCN_FNAME(And, SIZE), FW_UINT_TYPE(SIZE), &); \
+BITWISE_OP_RUNNER_METADEF(And, VO_FCN_ANDNAME(FW_UINT_TYPEN(SIZE)), FW_UINT_TYPE(SIZE), FW_UINT_TYPEN(SIZE)); \
+BITWISE_UINT_DEF(FW_UINT_FCN_FNAME(Or, SIZE), FW_UINT_TYPE(SIZE), |); \
+BITWISE_OP_RUNNER_METADEF(Or, VO_FCN_ORNAME(FW_UINT_TYPEN(SIZE)), FW_UINT_TYPE(SIZE), FW_UINT_TYPEN(SIZE)); \
+BITWISE_UINT_DEF(FW_UINT_FCN_FNAME(Xor, SIZE), FW_UINT_TYPE(SIZE), ^); \
+BITWISE_OP_RUNNER_METADEF(Xor, VO_FCN_XORNAME(FW_UINT_TYPEN(SIZE)), FW_UINT_TYPE(SIZE), FW_UINT_TYPEN(SIZE));
+
+BITWISE_UINT_METADEF(8);
+BITWISE_UINT_METADEF(16);
+BITWISE_UINT_METADEF(32);
+BITWISE_UINT_METADEF(64);
+
 
 /** Floating point arithmetic
  * These are just derived directly from stdlib,
@@ -2195,7 +2802,7 @@ static single msh_ModSingle(single accum, single in)
 	}
 	return accum;
 }
-BINARY_OP_RUNNER(msh_ModSingleRunnerW, VO_FCN_FNAME(Mod, Single), VO_FCN_CASNAME(Single), VO_FCN_CTCNAME(Single), Mod, single, Single, singleconv_T);
+BINARY_OP_RUNNER(msh_ModSingleRunnerW, VO_FCN_FNAME(Mod, Single), VO_FCN_CXNAME(Single), VO_FCN_CTCNAME(Single), Mod, single, Single, singleconv_T);
 
 static void msh_ModSingleRunner(WideInput_T* wide_accum, WideInput_T* wide_in, long opts)
 {
@@ -2214,6 +2821,21 @@ static single msh_NegSingle(single accum)
 UNARY_OP_RUNNER_METADEF(Neg, single, Single);
 
 
+/* NaNs are ignored, as in MATLAB */
+static single msh_MinSingle(single accum, single in)
+{
+	return (in < accum || accum != accum)? in : accum;
+}
+BINARY_OP_RUNNER_METADEF(Min, single, Single, singleconv_T);
+
+
+static single msh_MaxSingle(single accum, single in)
+{
+	return (in > accum || accum != accum)? in : accum;
+}
+BINARY_OP_RUNNER_METADEF(Max, single, Single, singleconv_T);
+
+
 static single msh_ARSSingle(single accum, single in)
 {
 #if __STDC_VERSION__ >= 199901L
@@ -2222,7 +2844,7 @@ static single msh_ARSSingle(single accum, single in)
 	return accum / (single)pow(2.0, (double)in);
 #endif
 }
-BINARY_OP_RUNNER(msh_ARSSingleRunnerW, VO_FCN_FNAME(ARS, Single), VO_FCN_CASNAME(Single), VO_FCN_CTCNAME(Single), ARS, single, Single, singleconv_T);
+BINARY_OP_RUNNER(msh_ARSSingleRunnerW, VO_FCN_FNAME(ARS, Single), VO_FCN_CXNAME(Single), VO_FCN_CTCNAME(Single), ARS, single, Single, singleconv_T);
 
 static void msh_ARSSingleRunner(WideInput_T* wide_accum, WideInput_T* wide_in, long opts)
 {
@@ -2265,7 +2887,7 @@ static single msh_ALSSingle(single accum, single in)
 	return accum * (single)pow(2.0, (double)in);
 #endif
 }
-BINARY_OP_RUNNER(msh_ALSSingleRunnerW, VO_FCN_FNAME(ALS, Single), VO_FCN_CASNAME(Single), VO_FCN_CTCNAME(Single), ALS, single, Single, singleconv_T);
+BINARY_OP_RUNNER(msh_ALSSingleRunnerW, VO_FCN_FNAME(ALS, Single), VO_FCN_CXNAME(Single), VO_FCN_CTCNAME(Single), ALS, single, Single, singleconv_T);
 
 static void msh_ALSSingleRunner(WideInput_T* wide_accum, WideInput_T* wide_in, long opts)
 {
@@ -2353,7 +2975,7 @@ static double msh_ModDouble(double accum, double in)
 	}
 	return accum;
 }
-BINARY_OP_RUNNER(msh_ModDoubleRunnerW, VO_FCN_FNAME(Mod, Double), VO_FCN_CASNAME(Double), VO_FCN_CTCNAME(Double), Mod, double, Double, doubleconv_T);
+BINARY_OP_RUNNER(msh_ModDoubleRunnerW, VO_FCN_FNAME(Mod, Double), VO_FCN_CXNAME(Double), VO_FCN_CTCNAME(Double), Mod, double, Double, doubleconv_T);
 
 static void msh_ModDoubleRunner(WideInput_T* wide_accum, WideInput_T* wide_in, long opts)
 {
@@ -2372,11 +2994,26 @@ static double msh_NegDouble(double accum)
 UNARY_OP_RUNNER_METADEF(Neg, double, Double);
 
 
+/* NaNs are ignored, as in MATLAB */
+static double msh_MinDouble(double accum, double in)
+{
+	return (in < accum || accum != accum)? in : accum;
+}
+BINARY_OP_RUNNER_METADEF(Min, double, Double, doubleconv_T);
+
+
+static double msh_MaxDouble(double accum, double in)
+{
+	return (in > accum || accum != accum)? in : accum;
+}
+BINARY_OP_RUNNER_METADEF(Max, double, Double, doubleconv_T);
+
+
 static double msh_ARSDouble(double accum, double in)
 {
 	return accum / (double)pow(2.0, (double)in);
 }
-BINARY_OP_RUNNER(msh_ARSDoubleRunnerW, VO_FCN_FNAME(ARS, Double), VO_FCN_CASNAME(Double), VO_FCN_CTCNAME(Double), ARS, double, Double, doubleconv_T);
+BINARY_OP_RUNNER(msh_ARSDoubleRunnerW, VO_FCN_FNAME(ARS, Double), VO_FCN_CXNAME(Double), VO_FCN_CTCNAME(Double), ARS, double, Double, doubleconv_T);
 
 static void msh_ARSDoubleRunner(WideInput_T* wide_accum, WideInput_T* wide_in, long opts)
 {
@@ -2412,7 +3049,7 @@ static double msh_ALSDouble(double accum, double in)
 {
 	return accum * pow(2.0, in);
 }
-BINARY_OP_RUNNER(msh_ALSDoubleRunnerW, VO_FCN_FNAME(ALS, Double), VO_FCN_CASNAME(Double), VO_FCN_CTCNAME(Double), ALS, double, Double, doubleconv_T);
+BINARY_OP_RUNNER(msh_ALSDoubleRunnerW, VO_FCN_FNAME(ALS, Double), VO_FCN_CXNAME(Double), VO_FCN_CTCNAME(Double), ALS, double, Double, doubleconv_T);
 
 static void msh_ALSDoubleRunner(WideInput_T* wide_accum, WideInput_T* wide_in, long opts)
 {
@@ -2443,6 +3080,140 @@ static void msh_ALSDoubleRunner(WideInput_T* wide_accum, WideInput_T* wide_in, l
 	}
 }
 
+/** Fused operations
+ *  The operands are converted to the class of the variable
+ *  first, then combined with the operations above, so the
+ *  integer results saturate at each step and the floating
+ *  point multiply-add is rounded twice. Integer variables
+ *  with a floating point operand are instead computed in
+ *  double and rounded once, as MATLAB would.
+ */
+
+#define FUSED_OP_METADEF(TYPE, TYPEN)                                            \
+static TYPE VO_FCN_FNAME(Axpy, TYPEN)(TYPE accum, TYPE a, TYPE x)                \
+{                                                                                \
+	return VO_FCN_FNAME(Add, TYPEN)(accum, VO_FCN_FNAME(Mul, TYPEN)(a, x));      \
+}                                                                                \
+TERNARY_OP_RUNNER_METADEF(Axpy, TYPE, TYPEN);                                    \
+static TYPE VO_FCN_FNAME(Fma, TYPEN)(TYPE accum, TYPE a, TYPE b)                 \
+{                                                                                \
+	return VO_FCN_FNAME(Add, TYPEN)(VO_FCN_FNAME(Mul, TYPEN)(accum, a), b);      \
+}                                                                                \
+TERNARY_OP_RUNNER_METADEF(Fma, TYPE, TYPEN);                                     \
+static TYPE VO_FCN_FNAME(Clamp, TYPEN)(TYPE accum, TYPE lower, TYPE upper)       \
+{                                                                                \
+	return VO_FCN_FNAME(Min, TYPEN)(VO_FCN_FNAME(Max, TYPEN)(accum, lower), upper); \
+}                                                                                \
+TERNARY_OP_RUNNER_METADEF(Clamp, TYPE, TYPEN)
+
+FUSED_OP_METADEF(FW_INT_TYPE(8), FW_INT_TYPEN(8));
+FUSED_OP_METADEF(FW_INT_TYPE(16), FW_INT_TYPEN(16));
+FUSED_OP_METADEF(FW_INT_TYPE(32), FW_INT_TYPEN(32));
+FUSED_OP_METADEF(FW_INT_TYPE(64), FW_INT_TYPEN(64));
+FUSED_OP_METADEF(FW_UINT_TYPE(8), FW_UINT_TYPEN(8));
+FUSED_OP_METADEF(FW_UINT_TYPE(16), FW_UINT_TYPEN(16));
+FUSED_OP_METADEF(FW_UINT_TYPE(32), FW_UINT_TYPEN(32));
+FUSED_OP_METADEF(FW_UINT_TYPE(64), FW_UINT_TYPEN(64));
+FUSED_OP_METADEF(single, Single);
+FUSED_OP_METADEF(double, Double);
+
+/** Reductions
+ *  These only read the variable. Sums are accumulated in
+ *  double precision, and the extremes are kept in the
+ *  class of the variable.
+ */
+
+/* the counts are done in blocks so that any can stop early */
+#define MSH_REDUCE_BLOCK_SIZE 4096
+
+#define MSH_IS_NONZERO(VAL) ((VAL) != 0)
+#define MSH_IS_TRUE(VAL) ((VAL) != 0 && (VAL) == (VAL)) /* any ignores NaNs */
+
+#define REDUCE_SUM_DEF(TYPE, TYPEN)                                                                                    \
+static void VO_FCN_RNAME(Sum, TYPEN)(WideInput_T* wide_in, ReduceAccum_T* accum)                                      \
+{                                                                                                                      \
+	size_t i, j, num_lanes;                                                                                            \
+	double lanes[MSH_SIMD_MAX_LANES];                                                                                  \
+	double sum = 0;                                                                                                    \
+	i = msh_SIMDReduce(VAROP_SUM, VO_FCN_MXCLASS(TYPEN), wide_in->input.raw, wide_in->num_elems, lanes, &num_lanes); \
+	for(j = 0; j < num_lanes; j++)                                                                                     \
+	{                                                                                                                  \
+		sum += lanes[j];                                                                                               \
+	}                                                                                                                  \
+	for(; i < wide_in->num_elems; i++)                                                                                 \
+	{                                                                                                                  \
+		sum += (double)WideInputFetch(wide_in, TYPEN)[i];                                                              \
+	}                                                                                                                  \
+	accum->sum += sum;                                                                                                 \
+}
+
+#define REDUCE_EXTREME_DEF(OP, FNAME, VAROP, TYPE, TYPEN)                                                          \
+static void VO_FCN_RNAME(OP, TYPEN)(WideInput_T* wide_in, ReduceAccum_T* accum)                                   \
+{                                                                                                                  \
+	size_t i, j, num_lanes;                                                                                        \
+	TYPE lanes[MSH_SIMD_MAX_LANES];                                                                                \
+	TYPE extreme;                                                                                                  \
+	if(wide_in->num_elems == 0)                                                                                    \
+	{                                                                                                              \
+		return;                                                                                                    \
+	}                                                                                                              \
+	i = msh_SIMDReduce(VAROP, VO_FCN_MXCLASS(TYPEN), wide_in->input.raw, wide_in->num_elems, lanes, &num_lanes); \
+	extreme = (accum->has_extreme)? accum->extreme.TYPEN : WideInputFetch(wide_in, TYPEN)[0];                      \
+	for(j = 0; j < num_lanes; j++)                                                                                 \
+	{                                                                                                              \
+		extreme = FNAME(extreme, lanes[j]);                                                                        \
+	}                                                                                                              \
+	for(; i < wide_in->num_elems; i++)                                                                             \
+	{                                                                                                              \
+		extreme = FNAME(extreme, WideInputFetch(wide_in, TYPEN)[i]);                                               \
+	}                                                                                                              \
+	accum->extreme.TYPEN = extreme;                                                                                \
+	accum->has_extreme = TRUE;                                                                                     \
+}
+
+#define REDUCE_COUNT_DEF(OP, VAROP, IS_COUNTED, STOP_EARLY, TYPE, TYPEN)                                                                    \
+static void VO_FCN_RNAME(OP, TYPEN)(WideInput_T* wide_in, ReduceAccum_T* accum)                                                            \
+{                                                                                                                                           \
+	size_t i, j, k, num_block_elems, num_lanes;                                                                                             \
+	uint64_T lanes[MSH_SIMD_MAX_LANES];                                                                                                     \
+	TYPE val;                                                                                                                               \
+	for(i = 0; i < wide_in->num_elems && !((STOP_EARLY) && accum->count > 0); i += num_block_elems)                                         \
+	{                                                                                                                                       \
+		num_block_elems = MIN(wide_in->num_elems - i, MSH_REDUCE_BLOCK_SIZE);                                                               \
+		j = msh_SIMDReduce(VAROP, VO_FCN_MXCLASS(TYPEN), WideInputFetch(wide_in, TYPEN) + i, num_block_elems, lanes, &num_lanes);         \
+		for(k = 0; k < num_lanes; k++)                                                                                                      \
+		{                                                                                                                                   \
+			accum->count += lanes[k];                                                                                                       \
+		}                                                                                                                                   \
+		for(; j < num_block_elems; j++)                                                                                                     \
+		{                                                                                                                                   \
+			val = WideInputFetch(wide_in, TYPEN)[i + j];                                                                                    \
+			if(IS_COUNTED(val))                                                                                                             \
+			{                                                                                                                               \
+				accum->count++;                                                                                                             \
+			}                                                                                                                               \
+		}                                                                                                                                   \
+	}                                                                                                                                       \
+}
+
+#define REDUCE_METADEF(TYPE, TYPEN, IS_TRUE)                                          \
+REDUCE_SUM_DEF(TYPE, TYPEN)                                                           \
+REDUCE_EXTREME_DEF(MinVal, VO_FCN_FNAME(Min, TYPEN), VAROP_MINVAL, TYPE, TYPEN)       \
+REDUCE_EXTREME_DEF(MaxVal, VO_FCN_FNAME(Max, TYPEN), VAROP_MAXVAL, TYPE, TYPEN)       \
+REDUCE_COUNT_DEF(Any, VAROP_ANY, IS_TRUE, TRUE, TYPE, TYPEN)                          \
+REDUCE_COUNT_DEF(Nnz, VAROP_NNZ, MSH_IS_NONZERO, FALSE, TYPE, TYPEN)
+
+REDUCE_METADEF(FW_INT_TYPE(8), FW_INT_TYPEN(8), MSH_IS_NONZERO);
+REDUCE_METADEF(FW_INT_TYPE(16), FW_INT_TYPEN(16), MSH_IS_NONZERO);
+REDUCE_METADEF(FW_INT_TYPE(32), FW_INT_TYPEN(32), MSH_IS_NONZERO);
+REDUCE_METADEF(FW_INT_TYPE(64), FW_INT_TYPEN(64), MSH_IS_NONZERO);
+REDUCE_METADEF(FW_UINT_TYPE(8), FW_UINT_TYPEN(8), MSH_IS_NONZERO);
+REDUCE_METADEF(FW_UINT_TYPE(16), FW_UINT_TYPEN(16), MSH_IS_NONZERO);
+REDUCE_METADEF(FW_UINT_TYPE(32), FW_UINT_TYPEN(32), MSH_IS_NONZERO);
+REDUCE_METADEF(FW_UINT_TYPE(64), FW_UINT_TYPEN(64), MSH_IS_NONZERO);
+REDUCE_METADEF(single, Single, MSH_IS_TRUE);
+REDUCE_METADEF(double, Double, MSH_IS_TRUE);
+
 #define CPY_FCN_DEF(RNAME, NAME, SNAME, CTCNAME, TYPE, TYPEN, TYPEC) \
 static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 { \
@@ -2479,9 +3250,9 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 	{ \
 		if(wide_accum->mxtype != wide_in->mxtype) \
 		{ \
-			in_conv = CTCNAME(wide_in->mxtype); \
 			if(opts & MSH_USE_ATOMIC_OPS) \
 			{ \
+				in_conv = CTCNAME(wide_in->mxtype); \
 				for(i = 0; i < wide_accum->num_elems; i++) \
 				{ \
 					SNAME(WideInputFetch(wide_accum, TYPEN) + i, in_conv(WideInputFetch(wide_in, TYPEN), i)); \
@@ -2489,10 +3260,8 @@ static void RNAME(WideInput_T* wide_accum, WideInput_T* wide_in, long opts) \
 			} \
 			else \
 			{ \
-				for(i = 0; i < wide_accum->num_elems; i++) \
-				{ \
-					WideInputFetch(wide_accum, TYPEN)[i] = in_conv(WideInputFetch(wide_in, TYPEN), i); \
-				} \
+				/* convert straight into the destination */ \
+				VO_FCN_BCTCNAME(TYPEN)(wide_in->mxtype)(WideInputFetch(wide_accum, TYPEN), wide_in->input.raw, 0, wide_accum->num_elems); \
 			} \
 		} \
 		else \
@@ -2562,6 +3331,25 @@ switch(CLASS_ID_NAME)                                      \
 	default:               return 0;                        \
 }
 
+/* the bitwise operations have no floating point runners */
+#define INT_CLASS_FCN_SWITCH_CASES(OP, CLASS_ID_NAME)      \
+switch(CLASS_ID_NAME)                                      \
+{                                                          \
+	case(mxINT8_CLASS):    return msh_##OP##Int8Runner;   \
+	case(mxINT16_CLASS):   return msh_##OP##Int16Runner;  \
+	case(mxINT32_CLASS):   return msh_##OP##Int32Runner;  \
+	case(mxINT64_CLASS):   return msh_##OP##Int64Runner;  \
+                                                           \
+	case(mxUINT8_CLASS):   return msh_##OP##UInt8Runner;  \
+	case(mxUINT16_CLASS):  return msh_##OP##UInt16Runner; \
+	case(mxUINT32_CLASS):  return msh_##OP##UInt32Runner; \
+	case(mxUINT64_CLASS):  return msh_##OP##UInt64Runner; \
+	                                                      \
+	case(mxLOGICAL_CLASS): return msh_##OP##Int8Runner;   \
+	case(mxCHAR_CLASS):    return msh_##OP##Int16Runner;  \
+	default:               return 0;                        \
+}
+
 static unaryvaropfcn_T msh_ChooseUnaryVarOpFcn(msh_varop_T varop, mxClassID class_id)
 {
 	switch(varop)
@@ -2574,9 +3362,9 @@ static unaryvaropfcn_T msh_ChooseUnaryVarOpFcn(msh_varop_T varop, mxClassID clas
 }
 
 
-void msh_UnaryVariableOperation(IndexedVariable_T* indexed_var, msh_varop_T varop, long opts, mxArray** output)
+void msh_UnaryVariableOperation(IndexedVariable_T* indexed_var, msh_varop_T varop, long opts)
 {
-	size_t          i, j, nzmax, elem_size, dest_offset, dest_num_elems;
+	size_t          nzmax;
 	unaryvaropfcn_T varop_fcn;
 	
 	int             is_complex = mxIsComplex(indexed_var->dest_var);
@@ -2587,6 +3375,8 @@ void msh_UnaryVariableOperation(IndexedVariable_T* indexed_var, msh_varop_T varo
 	WideInput_T    wide_dest_real   = {{dest_real_anchor}, 0, 0};
 	WideInput_T    wide_dest_imag   = {{dest_imag_anchor}, 0, 0};
 	
+	VarOpWorker_T  varop_worker     = {0};
+	
 	if((varop_fcn  = msh_ChooseUnaryVarOpFcn(varop, mxGetClassID(indexed_var->dest_var))) == 0)
 	{
 		meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "NoVarOpFoundError", "Could not find a suitable variable operation for type '%s'.", mxGetClassName(indexed_var->dest_var));
@@ -2608,51 +3398,14 @@ void msh_UnaryVariableOperation(IndexedVariable_T* indexed_var, msh_varop_T varo
 	}
 	else
 	{
+		varop_worker.unary_fcn        = varop_fcn;
+		varop_worker.dest_real_anchor = dest_real_anchor;
+		varop_worker.dest_imag_anchor = is_complex? dest_imag_anchor : NULL;
+		varop_worker.dest_elem_size   = mxGetElementSize(indexed_var->dest_var);
+		varop_worker.dest_mxtype      = mxGetClassID(indexed_var->dest_var);
+		varop_worker.opts             = opts;
 		
-		elem_size = mxGetElementSize(indexed_var->dest_var);
-		
-		if(indexed_var->indices.start_idxs == NULL)
-		{
-			
-			dest_num_elems  = mxGetNumberOfElements(indexed_var->dest_var);
-			wide_dest_real.num_elems = dest_num_elems;
-			
-			varop_fcn(&wide_dest_real, opts);
-			if(is_complex)
-			{
-				wide_dest_imag.num_elems = dest_num_elems;
-				
-				varop_fcn(&wide_dest_imag, opts);
-			}
-		}
-		else
-		{
-			for(i = 0; i < indexed_var->indices.num_idxs; i += indexed_var->indices.num_lens)
-			{
-				for(j = 0; j < indexed_var->indices.num_lens; j++)
-				{
-					dest_offset = indexed_var->indices.start_idxs[i+j]*elem_size/sizeof(int8_T);
-					
-					wide_dest_real.input.Int8 = dest_real_anchor + dest_offset;
-					wide_dest_real.num_elems  = indexed_var->indices.slice_lens[j];
-					
-					varop_fcn(&wide_dest_real, opts);
-					
-					if(is_complex)
-					{
-						wide_dest_imag.input.Int8 = dest_imag_anchor + dest_offset;
-						wide_dest_imag.num_elems  = indexed_var->indices.slice_lens[j];
-						
-						varop_fcn(&wide_dest_imag, opts);
-					}
-				}
-			}
-		}
-	}
-	
-	if(output != NULL)
-	{
-		*output = mxDuplicateArray(indexed_var->dest_var);
+		msh_RunVariableOperation(&varop_worker, &indexed_var->indices, mxGetNumberOfElements(indexed_var->dest_var));
 	}
 	
 }
@@ -2669,6 +3422,11 @@ static binaryvaropfcn_T msh_ChooseBinaryVarOpFcn(msh_varop_T varop, mxClassID cl
 		case(VAROP_MOD): CLASS_FCN_SWITCH_CASES(Mod, class_id);
 		case(VAROP_ARS): CLASS_FCN_SWITCH_CASES(ARS, class_id);
 		case(VAROP_ALS): CLASS_FCN_SWITCH_CASES(ALS, class_id);
+		case(VAROP_MIN): CLASS_FCN_SWITCH_CASES(Min, class_id);
+		case(VAROP_MAX): CLASS_FCN_SWITCH_CASES(Max, class_id);
+		case(VAROP_AND): INT_CLASS_FCN_SWITCH_CASES(And, class_id);
+		case(VAROP_OR):  INT_CLASS_FCN_SWITCH_CASES(Or, class_id);
+		case(VAROP_XOR): INT_CLASS_FCN_SWITCH_CASES(Xor, class_id);
 		case(VAROP_CPY): CLASS_FCN_SWITCH_CASES(Cpy, class_id);
 		default: return 0;
 	}
@@ -2677,19 +3435,16 @@ static binaryvaropfcn_T msh_ChooseBinaryVarOpFcn(msh_varop_T varop, mxClassID cl
 	
 }
 
-void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray* in_var, msh_varop_T varop, long opts, mxArray** output)
+void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray* in_var, msh_varop_T varop, long opts)
 {
 	int               field_num, in_num_fields, is_complex;
 	size_t            i, j;
-	size_t            dest_elem_size, dest_offset, in_elem_size;
+	size_t            dest_elem_size, in_elem_size;
 	mwSize            in_num_elems;
 	mwIndex           dest_idx, in_idx;
 	binaryvaropfcn_T  varop_fcn, varop_fcn_ir, varop_fcn_jc;
 	const char_T*     curr_field_name;
 	
-	int8_T*             dest_real_anchor;
-	int8_T*             dest_imag_anchor;
-	
 	WideInput_T wide_dest_real;
 	WideInput_T wide_dest_imag;
 	WideInput_T wide_dest_ir;
@@ -2701,6 +3456,7 @@ void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray*
 	WideInput_T wide_in_jc;
 	
 	IndexedVariable_T sub_variable = {0};
+	VarOpWorker_T     varop_worker = {0};
 	
 	switch(mxGetClassID(indexed_var->dest_var))
 	{
@@ -2718,7 +3474,7 @@ void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray*
 					for(dest_idx = 0; dest_idx < in_num_elems; dest_idx++)
 					{
 						sub_variable.dest_var = mxGetField(indexed_var->dest_var, dest_idx, curr_field_name);
-						msh_BinaryVariableOperation(&sub_variable, mxGetField(in_var, dest_idx, curr_field_name), varop, opts, output);
+						msh_BinaryVariableOperation(&sub_variable, mxGetField(in_var, dest_idx, curr_field_name), varop, opts);
 					}
 				}
 			}
@@ -2735,7 +3491,7 @@ void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray*
 							{
 								/* this inner conditional should be optimized out by the compiler */
 								sub_variable.dest_var = mxGetField(indexed_var->dest_var, dest_idx, curr_field_name);
-								msh_BinaryVariableOperation(&sub_variable, mxGetField(in_var, (in_num_elems == 1)? 0 : in_idx, curr_field_name), varop, opts, output);
+								msh_BinaryVariableOperation(&sub_variable, mxGetField(in_var, (in_num_elems == 1)? 0 : in_idx, curr_field_name), varop, opts);
 							}
 						}
 					}
@@ -2754,7 +3510,7 @@ void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray*
 				for(dest_idx = 0; dest_idx < in_num_elems; dest_idx++)
 				{
 					sub_variable.dest_var = mxGetCell(indexed_var->dest_var, dest_idx);
-					msh_BinaryVariableOperation(&sub_variable, mxGetCell(in_var, dest_idx), varop, opts, output);
+					msh_BinaryVariableOperation(&sub_variable, mxGetCell(in_var, dest_idx), varop, opts);
 				}
 			}
 			else
@@ -2767,7 +3523,7 @@ void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray*
 						{
 							/* this inner conditional should be optimized out by the compiler */
 							sub_variable.dest_var = mxGetCell(indexed_var->dest_var, dest_idx);
-							msh_BinaryVariableOperation(&sub_variable, mxGetCell(in_var, (in_num_elems == 1)? 0 : in_idx), varop, opts, output);
+							msh_BinaryVariableOperation(&sub_variable, mxGetCell(in_var, (in_num_elems == 1)? 0 : in_idx), varop, opts);
 						}
 					}
 				}
@@ -2849,76 +3605,98 @@ void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray*
 			}
 			else
 			{
-				if(indexed_var->indices.start_idxs == NULL)
+				varop_worker.binary_fcn       = varop_fcn;
+				varop_worker.dest_real_anchor = mxGetData(indexed_var->dest_var);
+				varop_worker.dest_imag_anchor = is_complex? mxGetImagData(indexed_var->dest_var) : NULL;
+				varop_worker.dest_elem_size   = dest_elem_size;
+				varop_worker.dest_mxtype      = wide_dest_real.mxtype;
+				varop_worker.in_elem_size     = in_elem_size;
+				varop_worker.opts             = opts;
+				
+				/* the input keeps its total number of elements so that scalar input is still recognized in each chunk */
+				varop_worker.wide_in_real.input.raw = mxGetData(in_var);
+				varop_worker.wide_in_real.num_elems = mxGetNumberOfElements(in_var);
+				varop_worker.wide_in_real.mxtype    = wide_in_real.mxtype;
+				
+				if(is_complex)
 				{
-					/* use the entire variable */
-					
-					/* real setup */
-					wide_in_real.input.raw = mxGetData(in_var);
-					wide_in_real.num_elems = mxGetNumberOfElements(in_var);
-					
-					wide_dest_real.input.raw = mxGetData(indexed_var->dest_var);
-					wide_dest_real.num_elems = mxGetNumberOfElements(indexed_var->dest_var);
-					
-					/* copying */
-					varop_fcn(&wide_dest_real, &wide_in_real, opts);
-					
-					if(is_complex)
-					{
-						/* imag setup */
-						wide_in_imag.input.raw = mxGetImagData(in_var);
-						wide_in_imag.num_elems = wide_in_real.num_elems;
-						
-						wide_dest_imag.input.raw = mxGetImagData(indexed_var->dest_var);
-						wide_dest_imag.num_elems = wide_dest_real.num_elems;
-						
-						/* copying */
-						varop_fcn(&wide_dest_imag, &wide_in_imag, opts);
-					}
+					varop_worker.wide_in_imag.input.raw = mxGetImagData(in_var);
+					varop_worker.wide_in_imag.num_elems = varop_worker.wide_in_real.num_elems;
+					varop_worker.wide_in_imag.mxtype    = wide_in_imag.mxtype;
 				}
-				else
+				
+				msh_RunVariableOperation(&varop_worker, &indexed_var->indices, mxGetNumberOfElements(indexed_var->dest_var));
+			}
+			break;
+		}
+	}
+	
+}
+
+
+static ternaryvaropfcn_T msh_ChooseTernaryVarOpFcn(msh_varop_T varop, mxClassID class_id)
+{
+	switch(varop)
+	{
+		case(VAROP_AXPY):  CLASS_FCN_SWITCH_CASES(Axpy, class_id);
+		case(VAROP_FMA):   CLASS_FCN_SWITCH_CASES(Fma, class_id);
+		case(VAROP_CLAMP): CLASS_FCN_SWITCH_CASES(Clamp, class_id);
+		default: return 0;
+	}
+	
+	return 0;
+	
+}
+
+void msh_TernaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray* in_var1, const mxArray* in_var2, msh_varop_T varop, long opts)
+{
+	int               field_num, in_num_fields;
+	size_t            i, j;
+	mwSize            in1_num_elems, in2_num_elems;
+	mwIndex           dest_idx, in_idx;
+	ternaryvaropfcn_T varop_fcn;
+	const char_T*     curr_field_name;
+	
+	IndexedVariable_T sub_variable = {0};
+	VarOpWorker_T     varop_worker = {0};
+	
+	switch(mxGetClassID(indexed_var->dest_var))
+	{
+		case (mxSTRUCT_CLASS):
+		{
+			in_num_fields = mxGetNumberOfFields(in_var1);
+			in1_num_elems = mxGetNumberOfElements(in_var1);
+			in2_num_elems = mxGetNumberOfElements(in_var2);
+			
+			/* go through each element */
+			if(indexed_var->indices.start_idxs == NULL)
+			{
+				for(field_num = 0; field_num < in_num_fields; field_num++)     /* each field */
 				{
-					
-					dest_real_anchor = mxGetData(indexed_var->dest_var);
-					dest_imag_anchor = mxGetImagData(indexed_var->dest_var);
-					
-					wide_in_real.input.raw = mxGetData(in_var);
-					wide_in_real.num_elems = mxGetNumberOfElements(in_var);
-					
-					if(is_complex)
+					curr_field_name = mxGetFieldNameByNumber(indexed_var->dest_var, field_num);
+					for(dest_idx = 0; dest_idx < in1_num_elems; dest_idx++)
 					{
-						wide_in_imag.input.raw = mxGetImagData(in_var);
-						wide_in_imag.num_elems = wide_in_real.num_elems;
+						sub_variable.dest_var = mxGetField(indexed_var->dest_var, dest_idx, curr_field_name);
+						msh_TernaryVariableOperation(&sub_variable, mxGetField(in_var1, dest_idx, curr_field_name), mxGetField(in_var2, dest_idx, curr_field_name), varop, opts);
 					}
-					
-					for(i = 0; i < indexed_var->indices.num_idxs; i += indexed_var->indices.num_lens)
+				}
+			}
+			else
+			{
+				for(field_num = 0; field_num < in_num_fields; field_num++)     /* each field */
+				{
+					curr_field_name = mxGetFieldNameByNumber(indexed_var->dest_var, field_num);
+					for(i = 0, in_idx = 0; i < indexed_var->indices.num_idxs; i += indexed_var->indices.num_lens)
 					{
 						for(j = 0; j < indexed_var->indices.num_lens; j++)
 						{
-							dest_offset = indexed_var->indices.start_idxs[i+j]*dest_elem_size/sizeof(int8_T);
-							
-							/* real setup */
-							wide_dest_real.input.raw = dest_real_anchor + dest_offset;
-							wide_dest_real.num_elems = indexed_var->indices.slice_lens[j];
-							
-							varop_fcn(&wide_dest_real, &wide_in_real, opts);
-							
-							if(is_complex)
-							{
-								wide_dest_imag.input.raw = dest_imag_anchor + dest_offset;
-								wide_dest_imag.num_elems = indexed_var->indices.slice_lens[j];
-								
-								varop_fcn(&wide_dest_imag, &wide_in_imag, opts);
-							}
-							
-							/* this condition should be optimized to the exterior by the compiler */
-							if(wide_in_real.num_elems != 1)
+							for(dest_idx = indexed_var->indices.start_idxs[i + j]; dest_idx < indexed_var->indices.start_idxs[i + j] + indexed_var->indices.slice_lens[j]; dest_idx++, in_idx++)
 							{
-								wide_in_real.input.Int8 += indexed_var->indices.slice_lens[j]*in_elem_size/sizeof(int8_T);
-								if(is_complex)
-								{
-									wide_in_imag.input.Int8 += indexed_var->indices.slice_lens[j]*in_elem_size/sizeof(int8_T);
-								}
+								sub_variable.dest_var = mxGetField(indexed_var->dest_var, dest_idx, curr_field_name);
+								msh_TernaryVariableOperation(&sub_variable,
+								                             mxGetField(in_var1, (in1_num_elems == 1)? 0 : in_idx, curr_field_name),
+								                             mxGetField(in_var2, (in2_num_elems == 1)? 0 : in_idx, curr_field_name),
+								                             varop, opts);
 							}
 						}
 					}
@@ -2926,11 +3704,191 @@ void msh_BinaryVariableOperation(IndexedVariable_T* indexed_var, const mxArray*
 			}
 			break;
 		}
+		case (mxCELL_CLASS):
+		{
+			
+			in1_num_elems = mxGetNumberOfElements(in_var1);
+			in2_num_elems = mxGetNumberOfElements(in_var2);
+			
+			/* go through each element */
+			if(indexed_var->indices.start_idxs == NULL)
+			{
+				for(dest_idx = 0; dest_idx < in1_num_elems; dest_idx++)
+				{
+					sub_variable.dest_var = mxGetCell(indexed_var->dest_var, dest_idx);
+					msh_TernaryVariableOperation(&sub_variable, mxGetCell(in_var1, dest_idx), mxGetCell(in_var2, dest_idx), varop, opts);
+				}
+			}
+			else
+			{
+				for(i = 0, in_idx = 0; i < indexed_var->indices.num_idxs; i += indexed_var->indices.num_lens)
+				{
+					for(j = 0; j < indexed_var->indices.num_lens; j++)
+					{
+						for(dest_idx = indexed_var->indices.start_idxs[i + j]; dest_idx < indexed_var->indices.start_idxs[i + j] + indexed_var->indices.slice_lens[j]; dest_idx++, in_idx++)
+						{
+							sub_variable.dest_var = mxGetCell(indexed_var->dest_var, dest_idx);
+							msh_TernaryVariableOperation(&sub_variable,
+							                             mxGetCell(in_var1, (in1_num_elems == 1)? 0 : in_idx),
+							                             mxGetCell(in_var2, (in2_num_elems == 1)? 0 : in_idx),
+							                             varop, opts);
+						}
+					}
+				}
+			}
+			break;
+		}
+		default:
+		{
+			if((varop_fcn = msh_ChooseTernaryVarOpFcn(varop, mxGetClassID(indexed_var->dest_var))) == 0)
+			{
+				meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "NoVarOpFoundError", "Could not find a suitable variable operation for type '%s'.", mxGetClassName(indexed_var->dest_var));
+			}
+			
+			/* sparse and complex variables were rejected when the input was checked */
+			varop_worker.ternary_fcn      = varop_fcn;
+			varop_worker.dest_real_anchor = mxGetData(indexed_var->dest_var);
+			varop_worker.dest_imag_anchor = NULL;
+			varop_worker.dest_elem_size   = mxGetElementSize(indexed_var->dest_var);
+			varop_worker.dest_mxtype      = mxGetClassID(indexed_var->dest_var);
+			varop_worker.in_elem_size     = mxGetElementSize(in_var1);
+			varop_worker.in2_elem_size    = mxGetElementSize(in_var2);
+			varop_worker.opts             = opts;
+			
+			varop_worker.wide_in_real.input.raw  = mxGetData(in_var1);
+			varop_worker.wide_in_real.num_elems  = mxGetNumberOfElements(in_var1);
+			varop_worker.wide_in_real.mxtype     = mxGetClassID(in_var1);
+			
+			varop_worker.wide_in2_real.input.raw = mxGetData(in_var2);
+			varop_worker.wide_in2_real.num_elems = mxGetNumberOfElements(in_var2);
+			varop_worker.wide_in2_real.mxtype    = mxGetClassID(in_var2);
+			
+			msh_RunVariableOperation(&varop_worker, &indexed_var->indices, mxGetNumberOfElements(indexed_var->dest_var));
+			break;
+		}
+	}
+	
+}
+
+
+/* logical and char are read as unsigned so that the values are not changed */
+#define REDUCE_CLASS_FCN_SWITCH_CASES(OP, CLASS_ID_NAME)   \
+switch(CLASS_ID_NAME)                                      \
+{                                                          \
+	case(mxINT8_CLASS):    return msh_##OP##Int8Runner;   \
+	case(mxINT16_CLASS):   return msh_##OP##Int16Runner;  \
+	case(mxINT32_CLASS):   return msh_##OP##Int32Runner;  \
+	case(mxINT64_CLASS):   return msh_##OP##Int64Runner;  \
+                                                           \
+	case(mxUINT8_CLASS):   return msh_##OP##UInt8Runner;  \
+	case(mxUINT16_CLASS):  return msh_##OP##UInt16Runner; \
+	case(mxUINT32_CLASS):  return msh_##OP##UInt32Runner; \
+	case(mxUINT64_CLASS):  return msh_##OP##UInt64Runner; \
+                                                           \
+	case(mxSINGLE_CLASS):  return msh_##OP##SingleRunner; \
+	case(mxDOUBLE_CLASS):  return msh_##OP##DoubleRunner; \
+	                                                      \
+	case(mxLOGICAL_CLASS): return msh_##OP##UInt8Runner;  \
+	case(mxCHAR_CLASS):    return msh_##OP##UInt16Runner; \
+	default:               return 0;                        \
+}
+
+static reducevaropfcn_T msh_ChooseReduceVarOpFcn(msh_varop_T varop, mxClassID class_id)
+{
+	switch(varop)
+	{
+		case(VAROP_SUM):    REDUCE_CLASS_FCN_SWITCH_CASES(Sum, class_id);
+		case(VAROP_MINVAL): REDUCE_CLASS_FCN_SWITCH_CASES(MinVal, class_id);
+		case(VAROP_MAXVAL): REDUCE_CLASS_FCN_SWITCH_CASES(MaxVal, class_id);
+		case(VAROP_ANY):    REDUCE_CLASS_FCN_SWITCH_CASES(Any, class_id);
+		case(VAROP_NNZ):    REDUCE_CLASS_FCN_SWITCH_CASES(Nnz, class_id);
+		default: return 0;
 	}
 	
-	if(output != NULL)
+	return 0;
+	
+}
+
+void msh_ReduceVariable(IndexedVariable_T* indexed_var, msh_varop_T varop, mxArray** output)
+{
+	reducevaropfcn_T reduce_fcn;
+	mwSize           scalar_dims[2] = {1, 1};
+	mwSize           empty_dims[2]  = {0, 0};
+	
+	mxClassID        dest_class_id = mxGetClassID(indexed_var->dest_var);
+	int              is_complex    = mxIsComplex(indexed_var->dest_var);
+	VarOpWorker_T    varop_worker  = {0};
+	
+	if(!mxIsNumeric(indexed_var->dest_var) && dest_class_id != mxLOGICAL_CLASS && dest_class_id != mxCHAR_CLASS)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "ReductionClassError", "Reductions are only available for numeric, logical, and char variables.");
+	}
+	
+	if(mxIsSparse(indexed_var->dest_var))
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "SparseVarOpError", "Reductions are not available for shared sparse matrices.");
+	}
+	
+	/* the real and imaginary parts are reduced separately, which only works for these */
+	if(is_complex && varop != VAROP_SUM && varop != VAROP_ANY)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_USER, "ComplexVarOpError", "Complex variables may only be reduced with sum and any.");
+	}
+	
+	if((reduce_fcn = msh_ChooseReduceVarOpFcn(varop, dest_class_id)) == 0)
+	{
+		meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "NoVarOpFoundError", "Could not find a suitable variable operation for type '%s'.", mxGetClassName(indexed_var->dest_var));
+	}
+	
+	varop_worker.reduce_fcn       = reduce_fcn;
+	varop_worker.dest_real_anchor = mxGetData(indexed_var->dest_var);
+	varop_worker.dest_imag_anchor = is_complex? mxGetImagData(indexed_var->dest_var) : NULL;
+	varop_worker.dest_elem_size   = mxGetElementSize(indexed_var->dest_var);
+	varop_worker.dest_mxtype      = dest_class_id;
+	
+	msh_RunVariableOperation(&varop_worker, &indexed_var->indices, mxGetNumberOfElements(indexed_var->dest_var));
+	
+	switch(varop)
 	{
-		*output = mxDuplicateArray(indexed_var->dest_var);
+		case(VAROP_SUM):
+		{
+			*output = mxCreateDoubleMatrix(1, 1, is_complex? mxCOMPLEX : mxREAL);
+			*mxGetPr(*output) = varop_worker.reduce_real.sum;
+			if(is_complex)
+			{
+				*(double*)mxGetImagData(*output) = varop_worker.reduce_imag.sum;
+			}
+			break;
+		}
+		case(VAROP_MINVAL):
+		case(VAROP_MAXVAL):
+		{
+			/* empty like min([]) if nothing was selected */
+			if(varop_worker.reduce_real.has_extreme)
+			{
+				*output = msh_CreateArrayOfClass(dest_class_id, 2, scalar_dims, FALSE);
+				memcpy(mxGetData(*output), &varop_worker.reduce_real.extreme, varop_worker.dest_elem_size);
+			}
+			else
+			{
+				*output = msh_CreateArrayOfClass(dest_class_id, 2, empty_dims, FALSE);
+			}
+			break;
+		}
+		case(VAROP_ANY):
+		{
+			*output = mxCreateLogicalScalar((mxLogical)(varop_worker.reduce_real.count > 0 || varop_worker.reduce_imag.count > 0));
+			break;
+		}
+		case(VAROP_NNZ):
+		{
+			*output = mxCreateDoubleScalar((double)varop_worker.reduce_real.count);
+			break;
+		}
+		default:
+		{
+			meu_PrintMexError(MEU_FL, MEU_SEVERITY_INTERNAL, "UnrecognizedVarOpError", "Unrecognized variable operation.");
+		}
 	}
 	
 }
@@ -2959,16 +3917,33 @@ void msh_VariableOperation(const mxArray* parent_var, const mxArray* subs_struct
 	
 	if(opts & MSH_IS_SYNCHRONOUS) msh_AcquireProcessLock(filelock);
 	
+	if(output != NULL && (opts & MSH_RETURN_OLD_VALS) && !msh_IsReadOnlyVarOp(varop))
+	{
+		*output = msh_CopyAffectedValues(&indexed_var, subs_struct);
+	}
+	
 	switch(num_in_vars)
 	{
 		case(0):
 		{
-			msh_UnaryVariableOperation(&indexed_var, varop, opts, output);
+			if(msh_IsReadOnlyVarOp(varop))
+			{
+				msh_ReduceVariable(&indexed_var, varop, output);
+			}
+			else
+			{
+				msh_UnaryVariableOperation(&indexed_var, varop, opts);
+			}
 			break;
 		}
 		case(1):
 		{
-			msh_BinaryVariableOperation(&indexed_var, mxGetCell(in_vars, 0), varop, opts, output);
+			msh_BinaryVariableOperation(&indexed_var, mxGetCell(in_vars, 0), varop, opts);
+			break;
+		}
+		case(2):
+		{
+			msh_TernaryVariableOperation(&indexed_var, mxGetCell(in_vars, 0), mxGetCell(in_vars, 1), varop, opts);
 			break;
 		}
 		default:
@@ -2977,6 +3952,12 @@ void msh_VariableOperation(const mxArray* parent_var, const mxArray* subs_struct
 		}
 	}
 	
+	if(output != NULL && !(opts & MSH_RETURN_OLD_VALS) && !msh_IsReadOnlyVarOp(varop))
+	{
+		/* only copy out what was changed rather than the whole variable */
+		*output = msh_CopyAffectedValues(&indexed_var, subs_struct);
+	}
+	
 	if(opts & MSH_IS_SYNCHRONOUS) msh_ReleaseProcessLock(filelock);
 	
 	if(indexed_var.indices.start_idxs != NULL)
@@ -2990,3 +3971,325 @@ void msh_VariableOperation(const mxArray* parent_var, const mxArray* subs_struct
 	}
 	
 }
+
+
+static void msh_RunVariableOperation(VarOpWorker_T* varop_worker, const ParsedIndices_T* indices, size_t dest_num_elems)
+{
+	size_t         i, num_elems, num_threads, chunk_len;
+	VarOpWorker_T* varop_workers;
+	
+	/* these must stay in scope until the threads finish */
+	mwIndex        whole_start_idx = 0;
+	mwSize         whole_slice_len = dest_num_elems;
+	
+	if(indices->start_idxs == NULL)
+	{
+		/* use the entire variable as a single slice */
+		varop_worker->start_idxs = &whole_start_idx;
+		varop_worker->slice_lens = &whole_slice_len;
+		varop_worker->num_lens   = 1;
+		varop_worker->group_len  = whole_slice_len;
+		num_elems = whole_slice_len;
+	}
+	else if(indices->num_lens == 0)
+	{
+		/* nothing was indexed */
+		return;
+	}
+	else
+	{
+		varop_worker->start_idxs = indices->start_idxs;
+		varop_worker->slice_lens = indices->slice_lens;
+		varop_worker->num_lens   = indices->num_lens;
+		for(i = 0, varop_worker->group_len = 0; i < indices->num_lens; i++)
+		{
+			varop_worker->group_len += indices->slice_lens[i];
+		}
+		num_elems = (indices->num_idxs/indices->num_lens)*varop_worker->group_len;
+	}
+	
+	if(num_elems == 0)
+	{
+		return;
+	}
+	
+	num_threads = (g_user_config.varop_threads == 0)? msh_GetNumProcessors() : g_user_config.varop_threads;
+	num_threads = MAX(MIN(num_threads, num_elems/MSH_VAROP_THREAD_MIN_ELEMS), 1);
+	
+	/* indices may be repeated, so only reductions may split a selection without losing updates */
+	if(indices->start_idxs != NULL && varop_worker->reduce_fcn == NULL)
+	{
+		num_threads = 1;
+	}
+	
+	if(num_threads == 1)
+	{
+		varop_worker->first_elem = 0;
+		varop_worker->end_elem   = num_elems;
+		msh_RunVarOpChunk(varop_worker);
+		return;
+	}
+	
+	/* the instruction set is detected lazily, so do it here rather than on every thread */
+	msh_GetSIMDLevel();
+	
+	chunk_len = (num_elems/num_threads + MSH_VAROP_THREAD_ALIGN - 1)/MSH_VAROP_THREAD_ALIGN*MSH_VAROP_THREAD_ALIGN;
+	num_threads = (num_elems + chunk_len - 1)/chunk_len;
+	
+	varop_workers = mxMalloc(num_threads*sizeof(VarOpWorker_T));
+	for(i = 0; i < num_threads; i++)
+	{
+		varop_workers[i] = *varop_worker;
+		varop_workers[i].first_elem = i*chunk_len;
+		varop_workers[i].end_elem   = MIN((i + 1)*chunk_len, num_elems);
+	}
+	
+	msh_RunThreads(msh_RunVarOpChunk, varop_workers, sizeof(VarOpWorker_T), num_threads);
+	
+	if(varop_worker->reduce_fcn != NULL)
+	{
+		for(i = 0; i < num_threads; i++)
+		{
+			msh_MergeReduction(varop_worker->reduce_fcn, &varop_worker->reduce_real, &varop_workers[i].reduce_real);
+			msh_MergeReduction(varop_worker->reduce_fcn, &varop_worker->reduce_imag, &varop_workers[i].reduce_imag);
+		}
+	}
+	
+	mxFree(varop_workers);
+	
+}
+
+
+static void msh_RunVarOpChunk(void* varop_worker)
+{
+	size_t         curr_elem, group_num, slice_num, slice_offset, num_slice_elems, dest_offset, in_offset, in2_offset;
+	VarOpWorker_T* worker = varop_worker;
+	
+	WideInput_T    wide_dest_real = {{NULL}, 0, 0};
+	WideInput_T    wide_dest_imag = {{NULL}, 0, 0};
+	WideInput_T    wide_in_real   = worker->wide_in_real;
+	WideInput_T    wide_in_imag   = worker->wide_in_imag;
+	WideInput_T    wide_in2_real  = worker->wide_in2_real;
+	
+	wide_dest_real.mxtype = worker->dest_mxtype;
+	wide_dest_imag.mxtype = worker->dest_mxtype;
+	
+	/* find the slice holding the first element */
+	group_num    = worker->first_elem/worker->group_len;
+	slice_offset = worker->first_elem%worker->group_len;
+	for(slice_num = 0; slice_offset >= worker->slice_lens[slice_num]; slice_num++)
+	{
+		slice_offset -= worker->slice_lens[slice_num];
+	}
+	
+	for(curr_elem = worker->first_elem; curr_elem < worker->end_elem; curr_elem += num_slice_elems)
+	{
+		num_slice_elems = MIN(worker->slice_lens[slice_num] - slice_offset, worker->end_elem - curr_elem);
+		dest_offset = (worker->start_idxs[group_num*worker->num_lens + slice_num] + slice_offset)*worker->dest_elem_size/sizeof(int8_T);
+		
+		wide_dest_real.input.Int8 = worker->dest_real_anchor + dest_offset;
+		wide_dest_real.num_elems  = num_slice_elems;
+		
+		if(worker->reduce_fcn != NULL)
+		{
+			worker->reduce_fcn(&wide_dest_real, &worker->reduce_real);
+			if(worker->dest_imag_anchor != NULL)
+			{
+				wide_dest_imag.input.Int8 = worker->dest_imag_anchor + dest_offset;
+				wide_dest_imag.num_elems  = num_slice_elems;
+				worker->reduce_fcn(&wide_dest_imag, &worker->reduce_imag);
+			}
+		}
+		else if(worker->unary_fcn != NULL)
+		{
+			worker->unary_fcn(&wide_dest_real, worker->opts);
+			if(worker->dest_imag_anchor != NULL)
+			{
+				wide_dest_imag.input.Int8 = worker->dest_imag_anchor + dest_offset;
+				wide_dest_imag.num_elems  = num_slice_elems;
+				worker->unary_fcn(&wide_dest_imag, worker->opts);
+			}
+		}
+		else if(worker->ternary_fcn != NULL)
+		{
+			/* ternary operations are only done on real variables */
+			in_offset  = (worker->wide_in_real.num_elems == 1)? 0 : curr_elem*worker->in_elem_size/sizeof(int8_T);
+			in2_offset = (worker->wide_in2_real.num_elems == 1)? 0 : curr_elem*worker->in2_elem_size/sizeof(int8_T);
+			
+			wide_in_real.input.Int8  = worker->wide_in_real.input.Int8 + in_offset;
+			wide_in2_real.input.Int8 = worker->wide_in2_real.input.Int8 + in2_offset;
+			worker->ternary_fcn(&wide_dest_real, &wide_in_real, &wide_in2_real, worker->opts);
+		}
+		else
+		{
+			/* scalar input is applied to every element */
+			in_offset = (worker->wide_in_real.num_elems == 1)? 0 : curr_elem*worker->in_elem_size/sizeof(int8_T);
+			
+			wide_in_real.input.Int8 = worker->wide_in_real.input.Int8 + in_offset;
+			worker->binary_fcn(&wide_dest_real, &wide_in_real, worker->opts);
+			if(worker->dest_imag_anchor != NULL)
+			{
+				wide_dest_imag.input.Int8 = worker->dest_imag_anchor + dest_offset;
+				wide_dest_imag.num_elems  = num_slice_elems;
+				wide_in_imag.input.Int8   = worker->wide_in_imag.input.Int8 + in_offset;
+				worker->binary_fcn(&wide_dest_imag, &wide_in_imag, worker->opts);
+			}
+		}
+		
+		slice_offset = 0;
+		if(++slice_num == worker->num_lens)
+		{
+			slice_num = 0;
+			group_num++;
+		}
+	}
+	
+}
+
+
+static void msh_MergeReduction(reducevaropfcn_T reduce_fcn, ReduceAccum_T* accum, ReduceAccum_T* part)
+{
+	WideInput_T wide_extreme;
+	
+	accum->sum   += part->sum;
+	accum->count += part->count;
+	
+	if(part->has_extreme)
+	{
+		/* fold the other extreme in as a single element */
+		wide_extreme.input.raw = &part->extreme;
+		wide_extreme.num_elems = 1;
+		reduce_fcn(&wide_extreme, accum);
+	}
+	
+}
+
+
+static mxArray* msh_CreateArrayOfClass(mxClassID class_id, size_t num_dims, const mwSize* dims, int is_complex)
+{
+	switch(class_id)
+	{
+		case(mxLOGICAL_CLASS): return mxCreateLogicalArray(num_dims, dims);
+		case(mxCHAR_CLASS):    return mxCreateCharArray(num_dims, dims);
+		default:               return mxCreateNumericArray(num_dims, dims, class_id, is_complex? mxCOMPLEX : mxREAL);
+	}
+}
+
+
+static mxArray* msh_CopyAffectedValues(IndexedVariable_T* indexed_var, const mxArray* subs_struct)
+{
+	size_t         i, j, num_subs, num_dims, num_affected, num_groups, elem_size, check_num;
+	mwSize*        dims;
+	mxArray*       subs_arr;
+	mxArray*       curr_subs;
+	mxArray*       ret_var;
+	int8_T*        real_out;
+	int8_T*        imag_out;
+	
+	const mxArray* dest_var      = indexed_var->dest_var;
+	mxClassID      dest_class_id = mxGetClassID(dest_var);
+	size_t         dest_num_dims = mxGetNumberOfDimensions(dest_var);
+	const mwSize*  dest_dims     = mxGetDimensions(dest_var);
+	
+	if(indexed_var->indices.start_idxs == NULL || subs_struct == NULL || mxIsSparse(dest_var) ||
+	   (!mxIsNumeric(dest_var) && dest_class_id != mxLOGICAL_CLASS && dest_class_id != mxCHAR_CLASS))
+	{
+		return mxDuplicateArray(dest_var);
+	}
+	
+	num_groups = (indexed_var->indices.num_lens > 0)? indexed_var->indices.num_idxs/indexed_var->indices.num_lens : 0;
+	for(i = 0, num_affected = 0; i < indexed_var->indices.num_lens; i++)
+	{
+		num_affected += indexed_var->indices.slice_lens[i];
+	}
+	num_affected *= num_groups;
+	
+	/* the indices are always parsed from the last subscript */
+	subs_arr = mxGetField(subs_struct, mxGetNumberOfElements(subs_struct) - 1, "subs");
+	num_subs = mxGetNumberOfElements(subs_arr);
+	
+	if(num_subs == 1)
+	{
+		curr_subs = mxGetCell(subs_arr, 0);
+		if(!mxIsChar(curr_subs) && dest_num_dims == 2 && (dest_dims[0] == 1 || dest_dims[1] == 1) &&
+		   mxGetNumberOfDimensions(curr_subs) == 2 && (mxGetM(curr_subs) == 1 || mxGetN(curr_subs) == 1))
+		{
+			/* a vector indexing a vector keeps the orientation of the destination */
+			num_dims = 2;
+			dims = mxMalloc(num_dims*sizeof(mwSize));
+			dims[0] = (dest_dims[0] == 1)? 1 : num_affected;
+			dims[1] = (dest_dims[0] == 1)? num_affected : 1;
+		}
+		else if(!mxIsChar(curr_subs))
+		{
+			num_dims = mxGetNumberOfDimensions(curr_subs);
+			dims = mxMalloc(num_dims*sizeof(mwSize));
+			memcpy(dims, mxGetDimensions(curr_subs), num_dims*sizeof(mwSize));
+		}
+		else
+		{
+			num_dims = 2;
+			dims = mxMalloc(num_dims*sizeof(mwSize));
+			dims[0] = num_affected;
+			dims[1] = 1;
+		}
+	}
+	else
+	{
+		num_dims = num_subs;
+		dims = mxMalloc(num_dims*sizeof(mwSize));
+		for(i = 0; i < num_subs; i++)
+		{
+			curr_subs = mxGetCell(subs_arr, i);
+			if(mxIsChar(curr_subs))
+			{
+				/* the last subscript spans the remaining dimensions */
+				for(j = i, dims[i] = 1; j < dest_num_dims && (j == i || i + 1 == num_subs); j++)
+				{
+					dims[i] *= dest_dims[j];
+				}
+			}
+			else
+			{
+				dims[i] = mxGetNumberOfElements(curr_subs);
+			}
+		}
+	}
+	
+	for(i = 0, check_num = 1; i < num_dims; i++)
+	{
+		check_num *= dims[i];
+	}
+	
+	if(check_num != num_affected)
+	{
+		num_dims = 2;
+		dims[0] = num_affected;
+		dims[1] = 1;
+	}
+	
+	ret_var = msh_CreateArrayOfClass(dest_class_id, num_dims, dims, mxIsComplex(dest_var));
+	mxFree(dims);
+	
+	elem_size = mxGetElementSize(dest_var);
+	real_out  = mxGetData(ret_var);
+	imag_out  = mxGetImagData(ret_var);
+	for(i = 0; i < num_groups; i++)
+	{
+		for(j = 0; j < indexed_var->indices.num_lens; j++)
+		{
+			memcpy(real_out, (int8_T*)mxGetData(dest_var) + indexed_var->indices.start_idxs[i*indexed_var->indices.num_lens + j]*elem_size,
+			       indexed_var->indices.slice_lens[j]*elem_size);
+			real_out += indexed_var->indices.slice_lens[j]*elem_size;
+			if(imag_out != NULL)
+			{
+				memcpy(imag_out, (int8_T*)mxGetImagData(dest_var) + indexed_var->indices.start_idxs[i*indexed_var->indices.num_lens + j]*elem_size,
+				       indexed_var->indices.slice_lens[j]*elem_size);
+				imag_out += indexed_var->indices.slice_lens[j]*elem_size;
+			}
+		}
+	}
+	
+	return ret_var;
+	
+}